@@ -576,6 +576,9 @@ Resolver::DoArrayResolve (std::string path, const ObjectPtrContainerValue &conta
 class ConfigImpl : public Singleton<ConfigImpl>
 {
 public:
+  /** Constructor. */
+  ConfigImpl ();
+
   /** \copydoc Config::Set() */
   void Set (std::string path, const AttributeValue &value);
   /** \copydoc Config::ConnectWithoutContext() */
@@ -594,6 +597,14 @@ public:
   /** \copydoc Config::UnregisterRootNamespaceObject() */
   void UnregisterRootNamespaceObject (Ptr<Object> obj);
 
+  /**
+   * Get the current generation of the object graph.
+   * \returns The generation, incremented by Invalidate().
+   */
+  uint64_t GetGeneration (void) const;
+  /** \copydoc Config::InvalidateCompiledPaths() */
+  void Invalidate (void);
+
   /** \copydoc Config::GetRootNamespaceObjectN() */
   uint32_t GetRootNamespaceObjectN (void) const;
   /** \copydoc Config::GetRootNamespaceObject() */
@@ -614,8 +625,16 @@ private:
 
   /** The list of Config path roots. */
   Roots m_roots;
+
+  /** Object graph generation, for CompiledPath. */
+  uint64_t m_generation;
 };
 
+ConfigImpl::ConfigImpl ()
+  : m_generation (1)
+{
+}
+
 void 
 ConfigImpl::ParsePath (std::string path, std::string *root, std::string *leaf) const
 {
@@ -714,6 +733,7 @@ ConfigImpl::RegisterRootNamespaceObject (Ptr<Object> obj)
 {
   NS_LOG_FUNCTION (this << obj);
   m_roots.push_back (obj);
+  Invalidate ();
 }
 
 void 
@@ -726,11 +746,25 @@ ConfigImpl::UnregisterRootNamespaceObject (Ptr<Object> obj)
       if (*i == obj)
         {
           m_roots.erase (i);
+          Invalidate ();
           return;
         }
     }
 }
 
+uint64_t
+ConfigImpl::GetGeneration (void) const
+{
+  return m_generation;
+}
+
+void
+ConfigImpl::Invalidate (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_generation++;
+}
+
 uint32_t 
 ConfigImpl::GetRootNamespaceObjectN (void) const
 {
@@ -873,6 +907,92 @@ Ptr<Object> GetRootNamespaceObject (uint32_t i)
   return ConfigImpl::Get ()->GetRootNamespaceObject (i);
 }
 
+void InvalidateCompiledPaths (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  ConfigImpl::Get ()->Invalidate ();
+}
+
+CompiledPath::CompiledPath (std::string path)
+  : m_path (path),
+    m_generation (0)
+{
+  NS_LOG_FUNCTION (this << path);
+  std::string::size_type slash = path.find_last_of ("/");
+  NS_ASSERT_MSG (slash != std::string::npos, "Invalid Config path " << path);
+  m_root = path.substr (0, slash);
+  m_leaf = path.substr (slash + 1);
+}
+
+const MatchContainer &
+CompiledPath::GetMatches (void)
+{
+  NS_LOG_FUNCTION (this);
+  uint64_t generation = ConfigImpl::Get ()->GetGeneration ();
+  if (m_generation != generation)
+    {
+      NS_LOG_LOGIC ("resolving " << m_root);
+      m_matches = ConfigImpl::Get ()->LookupMatches (m_root);
+      m_generation = generation;
+    }
+  return m_matches;
+}
+
+std::string
+CompiledPath::GetPath (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_path;
+}
+
+void
+CompiledPath::Reset (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_matches = MatchContainer ();
+  m_generation = 0;
+}
+
+void
+CompiledPath::Set (const AttributeValue &value)
+{
+  NS_LOG_FUNCTION (this << &value);
+  GetMatches ();
+  m_matches.Set (m_leaf, value);
+}
+
+void
+CompiledPath::Connect (const CallbackBase &cb)
+{
+  NS_LOG_FUNCTION (this << &cb);
+  GetMatches ();
+  m_matches.Connect (m_leaf, cb);
+}
+
+void
+CompiledPath::ConnectWithoutContext (const CallbackBase &cb)
+{
+  NS_LOG_FUNCTION (this << &cb);
+  GetMatches ();
+  m_matches.ConnectWithoutContext (m_leaf, cb);
+}
+
+void
+CompiledPath::Disconnect (const CallbackBase &cb)
+{
+  NS_LOG_FUNCTION (this << &cb);
+  GetMatches ();
+  m_matches.Disconnect (m_leaf, cb);
+}
+
+void
+CompiledPath::DisconnectWithoutContext (const CallbackBase &cb)
+{
+  NS_LOG_FUNCTION (this << &cb);
+  GetMatches ();
+  m_matches.DisconnectWithoutContext (m_leaf, cb);
+}
+
 } // namespace Config
 
 } // namespace ns3
@@ -258,6 +258,96 @@ private:
  */
 MatchContainer LookupMatches (std::string path);
 
+/**
+ * \ingroup config
+ * \brief A Config path whose matches are resolved once and reused.
+ *
+ * Config::Connect, Config::Set and the other path based functions
+ * walk the object graph from every root namespace object on each
+ * call, which is expensive for wildcard paths over many nodes.
+ * A CompiledPath keeps the MatchContainer of its path and only
+ * resolves it again after Config::InvalidateCompiledPaths() has
+ * been called.
+ *
+ * Registering root namespace objects, aggregating objects, adding
+ * Names, and adding nodes, channels, devices or applications all
+ * invalidate compiled paths automatically.  Code which changes what
+ * a path reaches in some other way, for example by setting a Pointer
+ * attribute or through an ObjectMap which grows during the
+ * simulation, must call Config::InvalidateCompiledPaths() itself.
+ */
+class CompiledPath
+{
+public:
+  /**
+   * \param [in] path A Config path ending in an attribute or trace
+   *   source name, as passed to Config::Set or Config::Connect.
+   */
+  CompiledPath (std::string path);
+
+  /**
+   * \param [in] value The value to set in all matching attributes.
+   * \sa ns3::Config::Set
+   */
+  void Set (const AttributeValue &value);
+  /**
+   * \param [in] cb The callback to connect to the matching trace sources.
+   * \sa ns3::Config::Connect
+   */
+  void Connect (const CallbackBase &cb);
+  /**
+   * \param [in] cb The callback to connect to the matching trace sources.
+   * \sa ns3::Config::ConnectWithoutContext
+   */
+  void ConnectWithoutContext (const CallbackBase &cb);
+  /**
+   * \param [in] cb The callback to disconnect from the matching trace sources.
+   * \sa ns3::Config::Disconnect
+   */
+  void Disconnect (const CallbackBase &cb);
+  /**
+   * \param [in] cb The callback to disconnect from the matching trace sources.
+   * \sa ns3::Config::DisconnectWithoutContext
+   */
+  void DisconnectWithoutContext (const CallbackBase &cb);
+
+  /**
+   * \returns The objects owning the attribute or trace source,
+   *          resolving the path again if it is stale.
+   */
+  const MatchContainer & GetMatches (void);
+  /**
+   * \returns The path this object was compiled from.
+   */
+  std::string GetPath (void) const;
+  /**
+   * Drop the cached matches, releasing the references they hold.
+   * The path is resolved again the next time it is used.
+   */
+  void Reset (void);
+
+private:
+  /** The full path. */
+  std::string m_path;
+  /** The path up to the last slash, which is resolved. */
+  std::string m_root;
+  /** The attribute or trace source name after the last slash. */
+  std::string m_leaf;
+  /** The objects matched by m_root. */
+  MatchContainer m_matches;
+  /** The generation m_matches was resolved in, 0 if never. */
+  uint64_t m_generation;
+};
+
+/**
+ * \ingroup config
+ *
+ * Mark every CompiledPath as stale, so that it resolves its path again
+ * the next time it is used.  Call this after changing which objects
+ * are reachable from the root namespace objects.
+ */
+void InvalidateCompiledPaths (void);
+
 /**
  * \ingroup config
  * \param [in] obj A new root object
@@ -23,6 +23,7 @@
 #include "abort.h"
 #include "names.h"
 #include "singleton.h"
+#include "config.h"
 
 /**
  * \file
@@ -696,6 +697,7 @@ Names::Add (std::string name, Ptr<Object> object)
   NS_LOG_FUNCTION (name << object);
   bool result = NamesPriv::Get ()->Add (name, object);
   NS_ABORT_MSG_UNLESS (result, "Names::Add(): Error adding name " << name);
+  Config::InvalidateCompiledPaths ();
 }
 
 void
@@ -704,6 +706,7 @@ Names::Rename (std::string oldpath, std::string newname)
   NS_LOG_FUNCTION (oldpath << newname);
   bool result = NamesPriv::Get ()->Rename (oldpath, newname);
   NS_ABORT_MSG_UNLESS (result, "Names::Rename(): Error renaming " << oldpath << " to " << newname);
+  Config::InvalidateCompiledPaths ();
 }
 
 void
@@ -712,6 +715,7 @@ Names::Add (std::string path, std::string name, Ptr<Object> object)
   NS_LOG_FUNCTION (path << name << object);
   bool result = NamesPriv::Get ()->Add (path, name, object);
   NS_ABORT_MSG_UNLESS (result, "Names::Add(): Error adding " << path << " " << name);
+  Config::InvalidateCompiledPaths ();
 }
 
 void
@@ -720,6 +724,7 @@ Names::Rename (std::string path, std::string oldname, std::string newname)
   NS_LOG_FUNCTION (path << oldname << newname);
   bool result = NamesPriv::Get ()->Rename (path, oldname, newname);
   NS_ABORT_MSG_UNLESS (result, "Names::Rename (): Error renaming " << path << " " << oldname << " to " << newname);
+  Config::InvalidateCompiledPaths ();
 }
 
 void
@@ -728,6 +733,7 @@ Names::Add (Ptr<Object> context, std::string name, Ptr<Object> object)
   NS_LOG_FUNCTION (context << name << object);
   bool result = NamesPriv::Get ()->Add (context, name, object);
   NS_ABORT_MSG_UNLESS (result, "Names::Add(): Error adding name " << name << " under context " << &context);
+  Config::InvalidateCompiledPaths ();
 }
 
 void
@@ -737,6 +743,7 @@ Names::Rename (Ptr<Object> context, std::string oldname, std::string newname)
   bool result = NamesPriv::Get ()->Rename (context, oldname, newname);
   NS_ABORT_MSG_UNLESS (result, "Names::Rename (): Error renaming " << oldname << " to " << newname << " under context " <<
                        &context);
+  Config::InvalidateCompiledPaths ();
 }
 
 std::string
@@ -757,7 +764,8 @@ void
 Names::Clear (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
-  return NamesPriv::Get ()->Clear ();
+  NamesPriv::Get ()->Clear ();
+  Config::InvalidateCompiledPaths ();
 }
 
 Ptr<Object>
@@ -490,6 +490,16 @@ public:
   }
   inline double ToDouble (enum Unit unit) const
   {
+    struct Information *info = PeekInformation (unit);
+    // Fast path: when both m_data and the conversion factor are exact
+    // in a double a single floating point operation gives the correctly
+    // rounded result, so we can skip the int64x64_t arithmetic.
+    if (info->factorDouble > 0
+        && m_data <= MAX_EXACT_DOUBLE && m_data >= -MAX_EXACT_DOUBLE)
+      {
+        const double v = static_cast<double> (m_data);
+        return info->toMul ? v * info->factorDouble : v / info->factorDouble;
+      }
     return To (unit).GetDouble ();
   }
   inline int64x64_t To (enum Unit unit) const
@@ -540,6 +550,7 @@ private:
     int64_t factor;                 //!< Ratio of this unit / current unit
     int64x64_t timeTo;              //!< Multiplier to convert to this unit
     int64x64_t timeFrom;            //!< Multiplier to convert from this unit
+    double factorDouble;            //!< factor as a double, or 0 if not exact
   };
   /** Current time unit, and conversion info. */
   struct Resolution
@@ -548,6 +559,9 @@ private:
     enum Time::Unit unit;           //!<  Current time unit
   };
 
+  /** Largest magnitude (2^53) for which every integer is exact in a double. */
+  static const int64_t MAX_EXACT_DOUBLE = 9007199254740992LL;
+
   /**
    *  Get the current Resolution
    *
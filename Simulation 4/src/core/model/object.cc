@@ -25,6 +25,7 @@
 #include "attribute.h"
 #include "log.h"
 #include "string.h"
+#include "config.h"
 #include <vector>
 #include <sstream>
 #include <cstdlib>
@@ -289,6 +290,8 @@ Object::AggregateObject (Ptr<Object> o)
       Object *current = aggregates->buffer[i];
       current->m_aggregates = aggregates;
     }
+  // The objects reachable through $ in Config paths have changed.
+  Config::InvalidateCompiledPaths ();
 
   // Finally, call NotifyNewAggregate on all the objects aggregates together.
   // We purposedly use the old aggregate buffers to iterate over the objects
@@ -109,7 +109,8 @@ RandomVariableStream::SetStream (int64_t stream)
       NS_ASSERT(nextStream <= ((1ULL)<<63));
       m_rng = new RngStream (RngSeedManager::GetSeed (),
                              nextStream,
-                             RngSeedManager::GetRun ());
+                             RngSeedManager::GetRun (),
+                             RngSeedManager::GetRngType ());
     }
   else
     {
@@ -119,7 +120,8 @@ RandomVariableStream::SetStream (int64_t stream)
       uint64_t target = base + stream;
       m_rng = new RngStream (RngSeedManager::GetSeed (),
                              target,
-                             RngSeedManager::GetRun ());
+                             RngSeedManager::GetRun (),
+                             RngSeedManager::GetRngType ());
     }
   m_stream = stream;
 }
@@ -130,6 +132,30 @@ RandomVariableStream::GetStream(void) const
   return m_stream;
 }
 
+void
+RandomVariableStream::GetRngState (uint32_t state[6]) const
+{
+  NS_LOG_FUNCTION (this);
+  m_rng->GetState (state);
+}
+
+void
+RandomVariableStream::SetRngState (const uint32_t state[6])
+{
+  NS_LOG_FUNCTION (this);
+  m_rng->SetState (state);
+}
+
+void
+RandomVariableStream::GetValues (double *values, uint32_t count)
+{
+  NS_LOG_FUNCTION (this << count);
+  for (uint32_t i = 0; i < count; i++)
+    {
+      values[i] = GetValue ();
+    }
+}
+
 RngStream *
 RandomVariableStream::Peek(void) const
 {
@@ -201,6 +227,25 @@ UniformRandomVariable::GetValue (void)
   NS_LOG_FUNCTION (this);
   return GetValue (m_min, m_max);
 }
+void
+UniformRandomVariable::GetValues (double *values, uint32_t count)
+{
+  NS_LOG_FUNCTION (this << count);
+  Peek ()->RandU01 (values, count);
+  const double min = m_min;
+  const double max = m_max;
+  for (uint32_t i = 0; i < count; i++)
+    {
+      values[i] = min + values[i] * (max - min);
+    }
+  if (IsAntithetic ())
+    {
+      for (uint32_t i = 0; i < count; i++)
+        {
+          values[i] = min + (max - values[i]);
+        }
+    }
+}
 uint32_t 
 UniformRandomVariable::GetInteger (void)
 {
@@ -438,6 +483,30 @@ ExponentialRandomVariable::GetValue (void)
   NS_LOG_FUNCTION (this);
   return GetValue (m_mean, m_bound);
 }
+void
+ExponentialRandomVariable::GetValues (double *values, uint32_t count)
+{
+  NS_LOG_FUNCTION (this << count);
+  if (m_bound != 0)
+    {
+      // values beyond the bound are drawn again, one by one
+      RandomVariableStream::GetValues (values, count);
+      return;
+    }
+  Peek ()->RandU01 (values, count);
+  const double mean = m_mean;
+  if (IsAntithetic ())
+    {
+      for (uint32_t i = 0; i < count; i++)
+        {
+          values[i] = 1 - values[i];
+        }
+    }
+  for (uint32_t i = 0; i < count; i++)
+    {
+      values[i] = -mean * std::log (values[i]);
+    }
+}
 uint32_t 
 ExponentialRandomVariable::GetInteger (void)
 {
@@ -149,6 +149,36 @@ public:
    */
   virtual uint32_t GetInteger (void) = 0;
 
+  /**
+   * \brief Get the next random values drawn from the distribution.
+   *
+   * The values are the ones \p count calls to GetValue() would give.
+   * The default implementation calls GetValue(); the variables which
+   * transform each uniform value alone draw the uniform values in bulk.
+   *
+   * \param [out] values The random values.
+   * \param [in] count The number of random values.
+   */
+  virtual void GetValues (double *values, uint32_t count);
+
+  /**
+   * \brief Save the position of the underlying RNG stream.
+   *
+   * Together with SetRngState() this lets a stream be checkpointed
+   * and resumed later, possibly in a different process.
+   *
+   * \param [out] state The RngStream state.
+   * \see RngStream::GetState
+   */
+  void GetRngState (uint32_t state[6]) const;
+
+  /**
+   * \brief Resume the underlying RNG stream from a saved position.
+   *
+   * \param [in] state The RngStream state, from GetRngState().
+   */
+  void SetRngState (const uint32_t state[6]);
+
 protected:
   /**
    * \brief Get the pointer to the underlying RNG stream.
@@ -293,6 +323,7 @@ public:
    * \note The upper limit is included in the output range.
    */
   virtual uint32_t GetInteger (void);
+  virtual void GetValues (double *values, uint32_t count);
   
 private:
   /** The lower bound on values that can be returned by this RNG stream. */
@@ -585,6 +616,7 @@ public:
   // Inherited from RandomVariableStream
   virtual double GetValue (void);
   virtual uint32_t GetInteger (void);
+  virtual void GetValues (double *values, uint32_t count);
 
 private:
   /** The mean value of the unbounded exponential distribution. */
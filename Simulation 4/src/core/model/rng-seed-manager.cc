@@ -21,8 +21,10 @@
 #include "global-value.h"
 #include "attribute-helper.h"
 #include "integer.h"
+#include "enum.h"
 #include "config.h"
 #include "log.h"
+#include "abort.h"
 
 /**
  * \file
@@ -60,6 +62,17 @@ static ns3::GlobalValue g_rngRun ("RngRun",
                                   "The run number used to modify the global seed",
                                   ns3::IntegerValue (1),
                                   ns3::MakeIntegerChecker<int64_t> ());
+/**
+ * \relates RngSeedManager
+ * The random number generator type global value.
+ *
+ * This is accessible as "--RngType" from CommandLine.
+ */
+static ns3::GlobalValue g_rngType ("RngType",
+                                   "The generator used by all rng streams",
+                                   ns3::EnumValue (RngStream::MRG32K3A),
+                                   ns3::MakeEnumChecker (RngStream::MRG32K3A, "MRG32k3a",
+                                                         RngStream::PHILOX4X32, "Philox4x32"));
 
 
 uint32_t RngSeedManager::GetSeed (void)
@@ -91,6 +104,22 @@ uint64_t RngSeedManager::GetRun ()
   return run;
 }
 
+void
+RngSeedManager::SetRngType (enum RngStream::Type type)
+{
+  NS_LOG_FUNCTION (type);
+  Config::SetGlobal ("RngType", EnumValue (type));
+}
+
+enum RngStream::Type
+RngSeedManager::GetRngType (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  EnumValue value;
+  g_rngType.GetValue (value);
+  return static_cast<enum RngStream::Type> (value.Get ());
+}
+
 uint64_t RngSeedManager::GetNextStreamIndex (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
@@ -99,4 +128,14 @@ uint64_t RngSeedManager::GetNextStreamIndex (void)
   return next;
 }
 
+void
+RngSeedManager::SetNextStreamIndex (uint64_t next)
+{
+  NS_LOG_FUNCTION (next);
+  NS_ABORT_MSG_IF (next < g_nextStreamIndex,
+                   "stream index " << next << " may already be in use, the next free one is "
+                                   << g_nextStreamIndex);
+  g_nextStreamIndex = next;
+}
+
 } // namespace ns3
@@ -21,6 +21,7 @@
 #define RNG_SEED_MANAGER_H
 
 #include <stdint.h>
+#include "rng-stream.h"
 
 /**
  * \file
@@ -99,12 +100,41 @@ public:
    */
   static uint64_t GetRun (void);
 
+  /**
+   * \brief Set the generator used by subsequently created streams.
+   *
+   * This is accessible as "--RngType" from CommandLine, with values
+   * "MRG32k3a" (the default) or "Philox4x32".
+   *
+   * \param [in] type The generator type.
+   */
+  static void SetRngType (enum RngStream::Type type);
+  /**
+   * \brief Get the generator used by subsequently created streams.
+   * \returns The generator type.
+   * \see SetRngType
+   */
+  static enum RngStream::Type GetRngType (void);
+
   /**
    * Get the next automatically assigned stream index.
    * \returns The next stream index.
    */
   static uint64_t GetNextStreamIndex(void);
 
+  /**
+   * Set the next automatically assigned stream index.
+   *
+   * This is only useful when restoring a checkpointed simulation,
+   * so that streams created after the restore get the same indices
+   * they would have had in the original run.  The index can only
+   * move forward: going back would assign again the indices of
+   * streams which already exist, and give them correlated values.
+   *
+   * \param [in] next The next stream index to assign.
+   */
+  static void SetNextStreamIndex (uint64_t next);
+
 };
 
 /** Alias for compatibility. */
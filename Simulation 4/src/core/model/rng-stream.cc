@@ -28,7 +28,7 @@
 
 /// \file
 /// \ingroup rngimpl
-/// Class RngStream and MRG32k3a implementation.
+/// Class RngStream, MRG32k3a and Philox4x32 implementation.
 
 namespace ns3 {
   
@@ -77,6 +77,26 @@ const double a21  =       527612.0;
 /// Second component multiplier of <i>n</i> - 3 value.
 const double a23n =       1370589.0;
 
+/// \ingroup rngimpl
+/// Philox4x32 first round multiplier.
+const uint32_t philoxM0 = 0xD2511F53;
+
+/// \ingroup rngimpl
+/// Philox4x32 second round multiplier.
+const uint32_t philoxM1 = 0xCD9E8D57;
+
+/// \ingroup rngimpl
+/// Philox4x32 first key increment (golden ratio).
+const uint32_t philoxW0 = 0x9E3779B9;
+
+/// \ingroup rngimpl
+/// Philox4x32 second key increment (sqrt(3) - 1).
+const uint32_t philoxW1 = 0xBB67AE85;
+
+/// \ingroup rngimpl
+/// Normalization of Philox4x32 words to [0,1), 2<sup>-32</sup>.
+const double philoxNorm = 1.0 / 4294967296.0;
+
 /// \ingroup rngimpl
 /// Decomposition factor for computing a*s in less than 53 bits, 2<sup>17</sup>
 const double two17 =      131072.0;
@@ -336,6 +356,15 @@ namespace ns3 {
 // Generate the next random number.
 //
 double RngStream::RandU01 ()
+{
+  if (m_type == PHILOX4X32)
+    {
+      return PhiloxRandU01 ();
+    }
+  return MrgRandU01 ();
+}
+
+double RngStream::MrgRandU01 ()
 {
   int32_t k;
   double p1, p2, u;
@@ -366,26 +395,180 @@ double RngStream::RandU01 ()
   return u;
 }
 
-RngStream::RngStream (uint32_t seedNumber, uint64_t stream, uint64_t substream)
+//-------------------------------------------------------------------------
+// Philox4x32-10
+//
+double RngStream::PhiloxRandU01 ()
+{
+  const uint64_t block = m_position >> 2;
+  if (block != m_blockIndex)
+    {
+      PhiloxBlock (block);
+    }
+  const uint32_t word = m_block[m_position & 0x3];
+  ++m_position;
+  // Center in the bin, so we never return exactly 0 or 1
+  return (word + 0.5) * philoxNorm;
+}
+
+void
+RngStream::RandU01 (double *values, uint32_t count)
 {
+  uint32_t i = 0;
+  if (m_type != PHILOX4X32)
+    {
+      for (; i < count; ++i)
+        {
+          values[i] = MrgRandU01 ();
+        }
+      return;
+    }
+  // finish the current block
+  for (; i < count && (m_position & 0x3) != 0; ++i)
+    {
+      values[i] = PhiloxRandU01 ();
+    }
+  for (; count - i >= 4; i += 4)
+    {
+      PhiloxBlock (m_position >> 2);
+      m_position += 4;
+      for (int j = 0; j < 4; ++j)
+        {
+          values[i + j] = (m_block[j] + 0.5) * philoxNorm;
+        }
+    }
+  for (; i < count; ++i)
+    {
+      values[i] = PhiloxRandU01 ();
+    }
+}
+
+void
+RngStream::PhiloxBlock (uint64_t block)
+{
+  uint32_t c0 = static_cast<uint32_t> (block);
+  uint32_t c1 = static_cast<uint32_t> (block >> 32);
+  uint32_t c2 = static_cast<uint32_t> (m_stream);
+  uint32_t c3 = static_cast<uint32_t> (m_stream >> 32);
+  uint32_t k0 = m_key[0];
+  uint32_t k1 = m_key[1];
+  for (int round = 0; round < 10; ++round)
+    {
+      const uint64_t p0 = static_cast<uint64_t> (philoxM0) * c0;
+      const uint64_t p1 = static_cast<uint64_t> (philoxM1) * c2;
+      c0 = static_cast<uint32_t> (p1 >> 32) ^ c1 ^ k0;
+      c2 = static_cast<uint32_t> (p0 >> 32) ^ c3 ^ k1;
+      c1 = static_cast<uint32_t> (p1);
+      c3 = static_cast<uint32_t> (p0);
+      k0 += philoxW0;
+      k1 += philoxW1;
+    }
+  m_block[0] = c0;
+  m_block[1] = c1;
+  m_block[2] = c2;
+  m_block[3] = c3;
+  m_blockIndex = block;
+}
+
+RngStream::RngStream (uint32_t seedNumber, uint64_t stream, uint64_t substream,
+                      enum Type type)
+  : m_type (type),
+    m_stream (stream),
+    m_position (0),
+    m_blockIndex (~0ULL)
+{
+  for (int i = 0; i < 4; ++i)
+    {
+      m_block[i] = 0;
+    }
   if (seedNumber >= m1 || seedNumber >= m2 || seedNumber == 0)
     {
       NS_FATAL_ERROR ("invalid Seed " << seedNumber);
     }
+  m_key[0] = seedNumber;
+  m_key[1] = static_cast<uint32_t> (substream);
   for (int i = 0; i < 6; ++i)
     {
       m_currentState[i] = seedNumber;
     }
-  AdvanceNthBy (stream, 127, m_currentState);
-  AdvanceNthBy (substream, 76, m_currentState);
+  if (m_type == MRG32K3A)
+    {
+      AdvanceNthBy (stream, 127, m_currentState);
+      AdvanceNthBy (substream, 76, m_currentState);
+    }
 }
 
 RngStream::RngStream(const RngStream& r)
+  : m_type (r.m_type),
+    m_stream (r.m_stream),
+    m_position (r.m_position),
+    m_blockIndex (r.m_blockIndex)
 {
   for (int i = 0; i < 6; ++i)
     {
       m_currentState[i] = r.m_currentState[i];
     }
+  for (int i = 0; i < 4; ++i)
+    {
+      m_block[i] = r.m_block[i];
+    }
+  m_key[0] = r.m_key[0];
+  m_key[1] = r.m_key[1];
+}
+
+enum RngStream::Type
+RngStream::GetType (void) const
+{
+  return m_type;
+}
+
+void
+RngStream::GetState (uint32_t state[6]) const
+{
+  if (m_type == PHILOX4X32)
+    {
+      state[0] = m_key[0];
+      state[1] = m_key[1];
+      state[2] = static_cast<uint32_t> (m_stream);
+      state[3] = static_cast<uint32_t> (m_stream >> 32);
+      state[4] = static_cast<uint32_t> (m_position);
+      state[5] = static_cast<uint32_t> (m_position >> 32);
+      return;
+    }
+  for (int i = 0; i < 6; ++i)
+    {
+      state[i] = static_cast<uint32_t> (m_currentState[i]);
+    }
+}
+
+void
+RngStream::SetState (const uint32_t state[6])
+{
+  if (m_type == PHILOX4X32)
+    {
+      m_key[0] = state[0];
+      m_key[1] = state[1];
+      m_stream = (static_cast<uint64_t> (state[3]) << 32) | state[2];
+      m_position = (static_cast<uint64_t> (state[5]) << 32) | state[4];
+      m_blockIndex = ~0ULL;
+      return;
+    }
+  if (state[0] >= m1 || state[1] >= m1 || state[2] >= m1
+      || (state[0] == 0 && state[1] == 0 && state[2] == 0))
+    {
+      NS_FATAL_ERROR ("invalid first component state "
+                      << state[0] << " " << state[1] << " " << state[2]);
+    }
+  if (state[3] >= m2 || state[4] >= m2 || state[5] >= m2
+      || (state[3] == 0 && state[4] == 0 && state[5] == 0))
+    {
+      NS_FATAL_ERROR ("invalid second component state "
+                      << state[3] << " " << state[4] << " " << state[5]);
+    }
+  for (int i = 0; i < 6; ++i)
+    {
+      m_currentState[i] = state[i];
+    }
 }
 
 void 
@@ -45,18 +45,39 @@ namespace ns3 {
  * holds a static instance of this class.  The details of this
  * class are explained in:
  * http://www.iro.umontreal.ca/~lecuyer/myftp/papers/streams00.pdf
+ *
+ * Alternatively the stream can use the counter-based Philox4x32-10
+ * generator, described in:
+ * J. K. Salmon, M. A. Moraes, R. O. Dror and D. E. Shaw,
+ * "Parallel random numbers: as easy as 1, 2, 3", SC'11.
+ * Philox computes the n-th number of a stream directly from
+ * (key, counter), so selecting a stream or substream is O(1)
+ * instead of the matrix exponentiation needed by MRG32k3a,
+ * and each block of four numbers is generated in one pass.
  */
 class RngStream
 {
 public:
+  /** The underlying generator. */
+  enum Type
+  {
+    MRG32K3A,   //!< L'Ecuyer's MRG32k3a, the default.
+    PHILOX4X32  //!< Counter-based Philox4x32-10.
+  };
+
   /**
    * Construct from explicit seed, stream and substream values.
    *
+   * With Philox4x32 the key is made of \p seed and the low 32 bits
+   * of \p substream, and the upper half of the counter is \p stream.
+   *
    * \param [in] seed The starting seed.
    * \param [in] stream The stream number.
    * \param [in] substream The sub-stream number.
+   * \param [in] type The generator to use.
    */
-  RngStream (uint32_t seed, uint64_t stream, uint64_t substream);
+  RngStream (uint32_t seed, uint64_t stream, uint64_t substream,
+             enum Type type = MRG32K3A);
   /**
    * Copy constructor.
    *
@@ -71,6 +92,48 @@ public:
    */
   double RandU01 (void);
 
+  /**
+   * Generate the next \p count random numbers for this stream.
+   *
+   * The values are the ones \p count calls to RandU01() would give,
+   * but with Philox4x32 the whole blocks are written out directly
+   * instead of going through the one block buffer.
+   *
+   * \param [out] values The random numbers.
+   * \param [in] count The number of random numbers.
+   */
+  void RandU01 (double *values, uint32_t count);
+
+  /**
+   * Get the generator used by this stream.
+   *
+   * \returns The generator type.
+   */
+  enum Type GetType (void) const;
+
+  /**
+   * Get the current state of this stream, for checkpointing.
+   *
+   * For MRG32k3a the first three components belong to the first MRG,
+   * modulo 2<sup>32</sup> - 209, the last three to the second, modulo
+   * 2<sup>32</sup> - 22853, so each fits in 32 bits.
+   * For Philox4x32 the components are the two key words, the stream
+   * and the number of values drawn so far, each as low, high words.
+   *
+   * The state can only be restored in a stream of the same Type.
+   *
+   * \param [out] state The six state components.
+   */
+  void GetState (uint32_t state[6]) const;
+  /**
+   * Restore a state previously obtained from GetState().
+   *
+   * The stream then continues exactly where the saved stream was.
+   *
+   * \param [in] state The six state components.
+   */
+  void SetState (const uint32_t state[6]);
+
 private:
   /**
    * Advance \p state of the RNG by leaps and bounds.
@@ -81,8 +144,41 @@ private:
    */
   void AdvanceNthBy (uint64_t nth, int by, double state[6]);
 
-  /** The RNG state vector. */
+  /**
+   * Generate the next random number with MRG32k3a.
+   *
+   * \returns The next random.
+   */
+  double MrgRandU01 (void);
+  /**
+   * Generate the next random number with Philox4x32.
+   *
+   * \returns The next random.
+   */
+  double PhiloxRandU01 (void);
+  /**
+   * Compute the Philox4x32-10 block for \p block into m_block.
+   *
+   * \param [in] block The block index, low half of the counter.
+   */
+  void PhiloxBlock (uint64_t block);
+
+  /** The generator used by this stream. */
+  enum Type m_type;
+
+  /** The MRG32k3a state vector. */
   double m_currentState[6];
+
+  /** The Philox4x32 key. */
+  uint32_t m_key[2];
+  /** The Philox4x32 stream, upper half of the counter. */
+  uint64_t m_stream;
+  /** Number of Philox4x32 values drawn so far. */
+  uint64_t m_position;
+  /** Index of the block held in m_block. */
+  uint64_t m_blockIndex;
+  /** The last Philox4x32 block generated. */
+  uint32_t m_block[4];
 };
 
 } // namespace ns3
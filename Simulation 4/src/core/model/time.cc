@@ -216,12 +216,15 @@ Time::SetResolution (enum Unit unit, struct Resolution *resolution,
         }
       NS_LOG_DEBUG ("SetResolution for unit " << (int) unit << " loop iteration " << i
     		    << " has shift " << shift << " has quotient " << quotient);
-      int64_t factor = static_cast<int64_t> (std::pow (10, std::fabs (shift)) * quotient);
+      const double exactFactor = std::pow (10, std::fabs (shift)) * quotient;
+      int64_t factor = static_cast<int64_t> (exactFactor);
       double realFactor = std::pow (10, (double) shift)
                         * static_cast<double> (coefficient[i]) / coefficient[(int) unit];
       NS_LOG_DEBUG ("SetResolution factor " << factor << " real factor " << realFactor);
       struct Information *info = &resolution->info[i];
       info->factor = factor;
+      // ToDouble () can only take its fast path if factor is exact
+      info->factorDouble = (exactFactor <= MAX_EXACT_DOUBLE) ? exactFactor : 0;
       // here we could equivalently check for realFactor == 1.0 but it's better
       // to avoid checking equality of doubles
       if (shift == 0 && quotient == 1)
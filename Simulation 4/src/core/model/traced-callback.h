@@ -21,7 +21,7 @@
 #ifndef TRACED_CALLBACK_H
 #define TRACED_CALLBACK_H
 
-#include <list>
+#include <vector>
 #include "callback.h"
 
 /**
@@ -46,6 +46,15 @@ namespace ns3 {
  * calling one of the \c operator() forms with the appropriate
  * number of arguments.
  *
+ * The Callbacks are stored contiguously.  Invoking a TracedCallback
+ * with no Callback connected costs a single test; the arguments are
+ * still built by the caller, which can check IsEmpty first when they
+ * are costly.
+ *
+ * A Callback may connect and disconnect Callbacks, itself included,
+ * while the chain fires.  A Callback connected then is called in the
+ * same firing, and a Callback disconnected then is not called anymore.
+ *
  * \tparam T1 \explicit Type of the first argument to the functor.
  * \tparam T2 \explicit Type of the second argument to the functor.
  * \tparam T3 \explicit Type of the third argument to the functor.
@@ -64,6 +73,21 @@ class TracedCallback
 public:
   /** Constructor. */
   TracedCallback ();
+  /**
+   * Copy constructor: copies the chain of Callbacks.
+   *
+   * \param [in] o The TracedCallback to copy.
+   */
+  TracedCallback (const TracedCallback &o);
+  /**
+   * Assignment operator: copies the chain of Callbacks.
+   *
+   * \param [in] o The TracedCallback to copy.
+   * \return This TracedCallback.
+   */
+  TracedCallback &operator = (const TracedCallback &o);
+  /** Destructor. */
+  ~TracedCallback ();
   /**
    * Append a Callback to the chain (without a context).
    *
@@ -93,6 +117,15 @@ public:
    * \param [in] path Context path which was used to connect the Callback.
    */
   void Disconnect (const CallbackBase & callback, std::string path);
+  /**
+   * Check whether any Callback is connected.
+   *
+   * Lets the class firing the trace skip building costly arguments
+   * when no one listens.
+   *
+   * \return \c true if the chain of Callbacks is empty.
+   */
+  bool IsEmpty (void) const;
   /**
    * \name Functors taking various numbers of arguments.
    *
@@ -234,9 +267,48 @@ private:
    * \tparam T7 \deduced Type of the seventh argument to the functor.
    * \tparam T8 \deduced Type of the eighth argument to the functor.
    */
-  typedef std::list<Callback<void,T1,T2,T3,T4,T5,T6,T7,T8> > CallbackList;
+  typedef std::vector<Callback<void,T1,T2,T3,T4,T5,T6,T7,T8> > CallbackList;
+  /**
+   * End a firing of the chain, and once no firing is in progress, drop
+   * the Callbacks disconnected during the firings.
+   */
+  void EndFiring (void) const;
+
+  /**
+   * Marks a firing of the chain in progress for its lifetime, so that
+   * the firing ends even when a Callback throws.
+   */
+  class FiringGuard
+  {
+  public:
+    /**
+     * Start a firing.
+     * \param [in] tc The TracedCallback firing.
+     */
+    FiringGuard (const TracedCallback *tc)
+      : m_tc (tc)
+    {
+      ++tc->m_firing;
+    }
+    /** End the firing. */
+    ~FiringGuard ()
+    {
+      m_tc->EndFiring ();
+    }
+  private:
+    const TracedCallback *m_tc;  //!< The TracedCallback firing.
+  };
+  friend class FiringGuard;
+
   /** The chain of Callbacks. */
   CallbackList m_callbackList;
+  /**
+   * The Callbacks disconnected while the chain fires, kept alive until
+   * the firing ends.  Allocated only when that happens.
+   */
+  CallbackList *m_disconnected;
+  /** Number of firings of the chain in progress. */
+  mutable uint32_t m_firing;
 };
 
 } // namespace ns3
@@ -253,8 +325,38 @@ template<typename T1, typename T2,
          typename T5, typename T6,
          typename T7, typename T8>
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::TracedCallback ()
-  : m_callbackList () 
+  : m_callbackList (),
+    m_disconnected (0),
+    m_firing (0)
+{
+}
+template<typename T1, typename T2,
+         typename T3, typename T4,
+         typename T5, typename T6,
+         typename T7, typename T8>
+TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::TracedCallback (const TracedCallback &o)
+  : m_callbackList (o.m_callbackList),
+    m_disconnected (0),
+    m_firing (0)
+{
+}
+template<typename T1, typename T2,
+         typename T3, typename T4,
+         typename T5, typename T6,
+         typename T7, typename T8>
+TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8> &
+TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator = (const TracedCallback &o)
+{
+  m_callbackList = o.m_callbackList;
+  return *this;
+}
+template<typename T1, typename T2,
+         typename T3, typename T4,
+         typename T5, typename T6,
+         typename T7, typename T8>
+TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::~TracedCallback ()
 {
+  delete m_disconnected;
 }
 template<typename T1, typename T2,
          typename T3, typename T4,
@@ -291,14 +393,26 @@ TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::DisconnectWithoutContext (const Callbac
   for (typename CallbackList::iterator i = m_callbackList.begin ();
        i != m_callbackList.end (); /* empty */)
     {
-      if ((*i).IsEqual (callback))
+      if ((*i).IsNull () || !(*i).IsEqual (callback))
         {
-          i = m_callbackList.erase (i);
+          i++;
         }
-      else
+      else if (m_firing > 0)
         {
+          // erasing would move the Callbacks not called yet: leave
+          // a null Callback in place until the firing ends
+          if (m_disconnected == 0)
+            {
+              m_disconnected = new CallbackList;
+            }
+          m_disconnected->push_back (*i);
+          *i = Callback<void,T1,T2,T3,T4,T5,T6,T7,T8> ();
           i++;
         }
+      else
+        {
+          i = m_callbackList.erase (i);
+        }
     }
 }
 template<typename T1, typename T2, 
@@ -314,6 +428,45 @@ TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::Disconnect (const CallbackBase & callba
   Callback<void,T1,T2,T3,T4,T5,T6,T7,T8> realCb = cb.Bind (path);
   DisconnectWithoutContext (realCb);
 }
+template<typename T1, typename T2, 
+         typename T3, typename T4,
+         typename T5, typename T6,
+         typename T7, typename T8>
+bool
+TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::IsEmpty (void) const
+{
+  return m_callbackList.size () == (m_disconnected == 0 ? 0 : m_disconnected->size ());
+}
+template<typename T1, typename T2,
+         typename T3, typename T4,
+         typename T5, typename T6,
+         typename T7, typename T8>
+void
+TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::EndFiring (void) const
+{
+  if (--m_firing > 0 || m_disconnected == 0)
+    {
+      return;
+    }
+  // the chain is only changed in place while it fires, so the
+  // Callbacks disconnected meanwhile are dropped now
+  TracedCallback *self = const_cast<TracedCallback *> (this);
+  typename CallbackList::size_type j = 0;
+  for (typename CallbackList::size_type i = 0; i < m_callbackList.size (); i++)
+    {
+      if (!m_callbackList[i].IsNull ())
+        {
+          if (i != j)
+            {
+              self->m_callbackList[j] = m_callbackList[i];
+            }
+          j++;
+        }
+    }
+  self->m_callbackList.resize (j);
+  delete m_disconnected;
+  self->m_disconnected = 0;
+}
 template<typename T1, typename T2, 
          typename T3, typename T4,
          typename T5, typename T6,
@@ -321,10 +474,18 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (void) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_callbackList.empty ())
     {
-      (*i)();
+      return;
+    }
+  // by index, since a Callback may connect or disconnect Callbacks
+  FiringGuard guard (this);
+  for (typename CallbackList::size_type i = 0; i < m_callbackList.size (); i++)
+    {
+      if (!m_callbackList[i].IsNull ())
+        {
+          m_callbackList[i] ();
+        }
     }
 }
 template<typename T1, typename T2, 
@@ -334,10 +495,18 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_callbackList.empty ())
     {
-      (*i)(a1);
+      return;
+    }
+  // by index, since a Callback may connect or disconnect Callbacks
+  FiringGuard guard (this);
+  for (typename CallbackList::size_type i = 0; i < m_callbackList.size (); i++)
+    {
+      if (!m_callbackList[i].IsNull ())
+        {
+          m_callbackList[i] (a1);
+        }
     }
 }
 template<typename T1, typename T2, 
@@ -347,10 +516,18 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_callbackList.empty ())
+    {
+      return;
+    }
+  // by index, since a Callback may connect or disconnect Callbacks
+  FiringGuard guard (this);
+  for (typename CallbackList::size_type i = 0; i < m_callbackList.size (); i++)
     {
-      (*i)(a1, a2);
+      if (!m_callbackList[i].IsNull ())
+        {
+          m_callbackList[i] (a1, a2);
+        }
     }
 }
 template<typename T1, typename T2, 
@@ -360,10 +537,18 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_callbackList.empty ())
     {
-      (*i)(a1, a2, a3);
+      return;
+    }
+  // by index, since a Callback may connect or disconnect Callbacks
+  FiringGuard guard (this);
+  for (typename CallbackList::size_type i = 0; i < m_callbackList.size (); i++)
+    {
+      if (!m_callbackList[i].IsNull ())
+        {
+          m_callbackList[i] (a1, a2, a3);
+        }
     }
 }
 template<typename T1, typename T2, 
@@ -373,10 +558,18 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3, T4 a4) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_callbackList.empty ())
     {
-      (*i)(a1, a2, a3, a4);
+      return;
+    }
+  // by index, since a Callback may connect or disconnect Callbacks
+  FiringGuard guard (this);
+  for (typename CallbackList::size_type i = 0; i < m_callbackList.size (); i++)
+    {
+      if (!m_callbackList[i].IsNull ())
+        {
+          m_callbackList[i] (a1, a2, a3, a4);
+        }
     }
 }
 template<typename T1, typename T2, 
@@ -386,10 +579,18 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_callbackList.empty ())
     {
-      (*i)(a1, a2, a3, a4, a5);
+      return;
+    }
+  // by index, since a Callback may connect or disconnect Callbacks
+  FiringGuard guard (this);
+  for (typename CallbackList::size_type i = 0; i < m_callbackList.size (); i++)
+    {
+      if (!m_callbackList[i].IsNull ())
+        {
+          m_callbackList[i] (a1, a2, a3, a4, a5);
+        }
     }
 }
 template<typename T1, typename T2, 
@@ -399,10 +600,18 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5, T6 a6) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_callbackList.empty ())
     {
-      (*i)(a1, a2, a3, a4, a5, a6);
+      return;
+    }
+  // by index, since a Callback may connect or disconnect Callbacks
+  FiringGuard guard (this);
+  for (typename CallbackList::size_type i = 0; i < m_callbackList.size (); i++)
+    {
+      if (!m_callbackList[i].IsNull ())
+        {
+          m_callbackList[i] (a1, a2, a3, a4, a5, a6);
+        }
     }
 }
 template<typename T1, typename T2, 
@@ -412,10 +621,18 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5, T6 a6, T7 a7) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_callbackList.empty ())
     {
-      (*i)(a1, a2, a3, a4, a5, a6, a7);
+      return;
+    }
+  // by index, since a Callback may connect or disconnect Callbacks
+  FiringGuard guard (this);
+  for (typename CallbackList::size_type i = 0; i < m_callbackList.size (); i++)
+    {
+      if (!m_callbackList[i].IsNull ())
+        {
+          m_callbackList[i] (a1, a2, a3, a4, a5, a6, a7);
+        }
     }
 }
 template<typename T1, typename T2, 
@@ -425,10 +642,18 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5, T6 a6, T7 a7, T8 a8) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_callbackList.empty ())
+    {
+      return;
+    }
+  // by index, since a Callback may connect or disconnect Callbacks
+  FiringGuard guard (this);
+  for (typename CallbackList::size_type i = 0; i < m_callbackList.size (); i++)
     {
-      (*i)(a1, a2, a3, a4, a5, a6, a7, a8);
+      if (!m_callbackList[i].IsNull ())
+        {
+          m_callbackList[i] (a1, a2, a3, a4, a5, a6, a7, a8);
+        }
     }
 }
 
@@ -256,6 +256,22 @@ public:
    * \returns Detailed information about the requested trace source.
    */
   struct TypeId::TraceSourceInformation GetTraceSource(uint16_t uid, uint32_t i) const;
+  /**
+   * Find an Attribute by name in a type id or its parents.
+   * \param [in] uid The id.
+   * \param [in] name The Attribute name.
+   * \param [out] info The Attribute information, if found.
+   * \returns \c true if the Attribute was found.
+   */
+  bool LookupAttribute (uint16_t uid, std::string name,
+                        struct TypeId::AttributeInformation *info) const;
+  /**
+   * Find a TraceSource by name in a type id or its parents.
+   * \param [in] uid The id.
+   * \param [in] name The TraceSource name.
+   * \returns The TraceSource accessor, or 0 if not found.
+   */
+  Ptr<const TraceSourceAccessor> LookupTraceSource (uint16_t uid, std::string name) const;
   /**
    * Check if this TypeId should not be listed in documentation.
    * \param [in] uid The id.
@@ -285,6 +301,9 @@ private:
    */
   static TypeId::hash_t Hasher (const std::string name);
 
+  /** Type of the by-hash index of Attributes and TraceSources. */
+  typedef std::map<TypeId::hash_t, uint32_t> indexmap_t;
+
   /** The information record about a single type id. */
   struct IidInformation {
     /** The type id name. */
@@ -307,6 +326,14 @@ private:
     std::vector<struct TypeId::AttributeInformation> attributes;
     /** The container of TraceSources. */
     std::vector<struct TypeId::TraceSourceInformation> traceSources;
+    /**
+     * Index into attributes by hash of the name.  On a hash collision
+     * the first Attribute is indexed, and the others are found by
+     * a linear search.
+     */
+    indexmap_t attributeIndex;
+    /** Index into traceSources by hash of the name, as attributeIndex. */
+    indexmap_t traceSourceIndex;
   };
   /** Iterator type. */
   typedef std::vector<struct IidInformation>::const_iterator Iterator;
@@ -317,6 +344,24 @@ private:
    * \returns The information record.
    */
   struct IidManager::IidInformation *LookupInformation (uint16_t uid) const;
+  /**
+   * Find an Attribute by name in a single type id, not its parents.
+   * \param [in] information The type id record.
+   * \param [in] hash The hash of \p name.
+   * \param [in] name The Attribute name.
+   * \returns The index of the Attribute, or -1 if not found.
+   */
+  static int32_t FindAttribute (const struct IidInformation *information,
+                                TypeId::hash_t hash, const std::string &name);
+  /**
+   * Find a TraceSource by name in a single type id, not its parents.
+   * \param [in] information The type id record.
+   * \param [in] hash The hash of \p name.
+   * \param [in] name The TraceSource name.
+   * \returns The index of the TraceSource, or -1 if not found.
+   */
+  static int32_t FindTraceSource (const struct IidInformation *information,
+                                  TypeId::hash_t hash, const std::string &name);
 
   /** The container of all type id records. */
   std::vector<struct IidInformation> m_information;
@@ -577,15 +622,12 @@ IidManager::HasAttribute (uint16_t uid,
 {
   NS_LOG_FUNCTION (this << uid << name);
   struct IidInformation *information  = LookupInformation (uid);
+  TypeId::hash_t hash = Hasher (name);
   while (true)
     {
-      for (std::vector<struct TypeId::AttributeInformation>::const_iterator i = information->attributes.begin ();
-           i != information->attributes.end (); ++i)
+      if (FindAttribute (information, hash, name) >= 0)
         {
-          if (i->name == name)
-            {
-              return true;
-            }
+          return true;
         }
       struct IidInformation *parent = LookupInformation (information->parent);
       if (parent == information)
@@ -624,6 +666,9 @@ IidManager::AddAttribute (uint16_t uid,
   info.accessor = accessor;
   info.checker = checker;
   information->attributes.push_back (info);
+  // insert () keeps the first Attribute on a hash collision
+  information->attributeIndex.insert (std::make_pair (Hasher (name),
+                                                      information->attributes.size () - 1));
 }
 void 
 IidManager::SetAttributeInitialValue(uint16_t uid,
@@ -660,15 +705,12 @@ IidManager::HasTraceSource (uint16_t uid,
 {
   NS_LOG_FUNCTION (this << uid << name);
   struct IidInformation *information  = LookupInformation (uid);
+  TypeId::hash_t hash = Hasher (name);
   while (true)
     {
-      for (std::vector<struct TypeId::TraceSourceInformation>::const_iterator i = information->traceSources.begin ();
-           i != information->traceSources.end (); ++i)
+      if (FindTraceSource (information, hash, name) >= 0)
         {
-          if (i->name == name)
-            {
-              return true;
-            }
+          return true;
         }
       struct IidInformation *parent = LookupInformation (information->parent);
       if (parent == information)
@@ -702,6 +744,8 @@ IidManager::AddTraceSource (uint16_t uid,
   source.accessor = accessor;
   source.callback = callback;
   information->traceSources.push_back (source);
+  information->traceSourceIndex.insert (std::make_pair (Hasher (name),
+                                                        information->traceSources.size () - 1));
 }
 uint32_t 
 IidManager::GetTraceSourceN (uint16_t uid) const
@@ -718,6 +762,116 @@ IidManager::GetTraceSource(uint16_t uid, uint32_t i) const
   NS_ASSERT (i < information->traceSources.size ());
   return information->traceSources[i];
 }
+
+//static
+int32_t
+IidManager::FindAttribute (const struct IidInformation *information,
+                           TypeId::hash_t hash, const std::string &name)
+{
+  indexmap_t::const_iterator it = information->attributeIndex.find (hash);
+  if (it == information->attributeIndex.end ())
+    {
+      return -1;
+    }
+  if (information->attributes[it->second].name == name)
+    {
+      return it->second;
+    }
+  // hash collision
+  for (uint32_t i = 0; i < information->attributes.size (); i++)
+    {
+      if (information->attributes[i].name == name)
+        {
+          return i;
+        }
+    }
+  return -1;
+}
+
+//static
+int32_t
+IidManager::FindTraceSource (const struct IidInformation *information,
+                             TypeId::hash_t hash, const std::string &name)
+{
+  indexmap_t::const_iterator it = information->traceSourceIndex.find (hash);
+  if (it == information->traceSourceIndex.end ())
+    {
+      return -1;
+    }
+  if (information->traceSources[it->second].name == name)
+    {
+      return it->second;
+    }
+  // hash collision
+  for (uint32_t i = 0; i < information->traceSources.size (); i++)
+    {
+      if (information->traceSources[i].name == name)
+        {
+          return i;
+        }
+    }
+  return -1;
+}
+
+bool
+IidManager::LookupAttribute (uint16_t uid, std::string name,
+                             struct TypeId::AttributeInformation *info) const
+{
+  NS_LOG_FUNCTION (this << uid << name << info);
+  struct IidInformation *information = LookupInformation (uid);
+  TypeId::hash_t hash = Hasher (name);
+  while (true)
+    {
+      int32_t i = FindAttribute (information, hash, name);
+      if (i >= 0)
+        {
+          *info = information->attributes[i];
+          return true;
+        }
+      if (information->parent == 0)
+        {
+          // no parent set, as for the collision test types
+          return false;
+        }
+      struct IidInformation *parent = LookupInformation (information->parent);
+      if (parent == information)
+        {
+          // top of inheritance tree
+          return false;
+        }
+      information = parent;
+    }
+  return false;
+}
+
+Ptr<const TraceSourceAccessor>
+IidManager::LookupTraceSource (uint16_t uid, std::string name) const
+{
+  NS_LOG_FUNCTION (this << uid << name);
+  struct IidInformation *information = LookupInformation (uid);
+  TypeId::hash_t hash = Hasher (name);
+  while (true)
+    {
+      int32_t i = FindTraceSource (information, hash, name);
+      if (i >= 0)
+        {
+          return information->traceSources[i].accessor;
+        }
+      if (information->parent == 0)
+        {
+          // no parent set, as for the collision test types
+          return 0;
+        }
+      struct IidInformation *parent = LookupInformation (information->parent);
+      if (parent == information)
+        {
+          // top of inheritance tree
+          return 0;
+        }
+      information = parent;
+    }
+  return 0;
+}
 bool 
 IidManager::MustHideFromDocumentation (uint16_t uid) const
 {
@@ -805,22 +959,7 @@ bool
 TypeId::LookupAttributeByName (std::string name, struct TypeId::AttributeInformation *info) const
 {
   NS_LOG_FUNCTION (this << name << info);
-  TypeId tid;
-  TypeId nextTid = *this;
-  do {
-      tid = nextTid;
-      for (uint32_t i = 0; i < tid.GetAttributeN (); i++)
-        {
-          struct TypeId::AttributeInformation tmp = tid.GetAttribute(i);
-          if (tmp.name == name)
-            {
-              *info = tmp;
-              return true;
-            }
-        }
-      nextTid = tid.GetParent ();
-    } while (nextTid != tid);
-  return false;
+  return IidManager::Get ()->LookupAttribute (m_tid, name, info);
 }
 
 TypeId 
@@ -1031,21 +1170,7 @@ Ptr<const TraceSourceAccessor>
 TypeId::LookupTraceSourceByName (std::string name) const
 {
   NS_LOG_FUNCTION (this << name);
-  TypeId tid;
-  TypeId nextTid = *this;
-  do {
-      tid = nextTid;
-      for (uint32_t i = 0; i < tid.GetTraceSourceN (); i++)
-        {
-          struct TypeId::TraceSourceInformation info = tid.GetTraceSource (i);
-          if (info.name == name)
-            {
-              return info.accessor;
-            }
-        }
-      nextTid = tid.GetParent ();
-    } while (nextTid != tid);
-  return 0;
+  return IidManager::Get ()->LookupTraceSource (m_tid, name);
 }
 
 uint16_t 
@@ -33,6 +33,9 @@
 
 
 #include <sstream>
+#include <iomanip>
+#include <iostream>
+#include <ctime>
 
 using namespace ns3;
 
@@ -721,6 +724,172 @@ SearchAttributesOfParentObjectsTestCase::DoRun (void)
 
 }
 
+// ===========================================================================
+// Test that a Config::CompiledPath reuses its matches until invalidated.
+// ===========================================================================
+class CompiledPathConfigTestCase : public TestCase
+{
+public:
+  CompiledPathConfigTestCase ();
+  virtual ~CompiledPathConfigTestCase () {}
+
+  void Trace (int16_t oldValue, int16_t newValue) { m_newValue = newValue; }
+
+private:
+  virtual void DoRun (void);
+
+  int16_t m_newValue;
+};
+
+CompiledPathConfigTestCase::CompiledPathConfigTestCase ()
+  : TestCase ("Check that a compiled path is only resolved again after invalidation")
+{
+}
+
+void
+CompiledPathConfigTestCase::DoRun (void)
+{
+  IntegerValue iv;
+
+  Ptr<ConfigTestObject> root = CreateObject<ConfigTestObject> ();
+  Config::RegisterRootNamespaceObject (root);
+  Ptr<ConfigTestObject> a = CreateObject<ConfigTestObject> ();
+  root->SetNodeA (a);
+  Ptr<ConfigTestObject> obj0 = CreateObject<ConfigTestObject> ();
+  Ptr<ConfigTestObject> obj1 = CreateObject<ConfigTestObject> ();
+  a->AddNodeB (obj0);
+
+  Config::CompiledPath pathA ("/NodeA/NodesB/*/A");
+  NS_TEST_ASSERT_MSG_EQ (pathA.GetPath (), "/NodeA/NodesB/*/A", "Path not kept");
+  pathA.Set (IntegerValue (1));
+  obj0->GetAttribute ("A", iv);
+  NS_TEST_ASSERT_MSG_EQ (iv.Get (), 1, "Object 0 A not set through the compiled path");
+
+  //
+  // Growing an ObjectVector does not invalidate compiled paths, so the
+  // new object is not seen until we invalidate explicitly.
+  //
+  a->AddNodeB (obj1);
+  pathA.Set (IntegerValue (2));
+  obj0->GetAttribute ("A", iv);
+  NS_TEST_ASSERT_MSG_EQ (iv.Get (), 2, "Object 0 A not set through the cached matches");
+  obj1->GetAttribute ("A", iv);
+  NS_TEST_ASSERT_MSG_EQ (iv.Get (), 10, "Object 1 A set through stale matches");
+
+  Config::InvalidateCompiledPaths ();
+  pathA.Set (IntegerValue (3));
+  obj1->GetAttribute ("A", iv);
+  NS_TEST_ASSERT_MSG_EQ (iv.Get (), 3, "Object 1 A not set after invalidation");
+
+  //
+  // Registering a new root invalidates compiled paths by itself.
+  //
+  Ptr<ConfigTestObject> root2 = CreateObject<ConfigTestObject> ();
+  Ptr<ConfigTestObject> a2 = CreateObject<ConfigTestObject> ();
+  Ptr<ConfigTestObject> obj2 = CreateObject<ConfigTestObject> ();
+  root2->SetNodeA (a2);
+  a2->AddNodeB (obj2);
+  Config::RegisterRootNamespaceObject (root2);
+  pathA.Set (IntegerValue (4));
+  obj2->GetAttribute ("A", iv);
+  NS_TEST_ASSERT_MSG_EQ (iv.Get (), 4, "Object under new root A not set");
+
+  //
+  // Connect and disconnect through the same cached matches.
+  //
+  Config::CompiledPath pathSource ("/NodeA/NodesB/*/Source");
+  pathSource.ConnectWithoutContext (MakeCallback (&CompiledPathConfigTestCase::Trace, this));
+  m_newValue = 0;
+  obj1->SetAttribute ("Source", IntegerValue (-5));
+  NS_TEST_ASSERT_MSG_EQ (m_newValue, -5, "Trace did not fire as expected");
+  pathSource.DisconnectWithoutContext (MakeCallback (&CompiledPathConfigTestCase::Trace, this));
+  m_newValue = 0;
+  obj1->SetAttribute ("Source", IntegerValue (-6));
+  NS_TEST_ASSERT_MSG_EQ (m_newValue, 0, "Trace fired after disconnect");
+
+  pathA.Reset ();
+  pathSource.Reset ();
+  Config::UnregisterRootNamespaceObject (root2);
+  Config::UnregisterRootNamespaceObject (root);
+}
+
+// ===========================================================================
+// Measure the cost of repeatedly connecting and disconnecting a wildcard
+// path, with and without a Config::CompiledPath.
+// ===========================================================================
+class CompiledPathPerformanceTestCase : public TestCase
+{
+public:
+  CompiledPathPerformanceTestCase ();
+  virtual ~CompiledPathPerformanceTestCase () {}
+
+  void Trace (int16_t oldValue, int16_t newValue) {}
+
+private:
+  virtual void DoRun (void);
+  void Report (const std::string how, const clock_t delta) const;
+
+  enum { NODES = 1000, REPETITIONS = 200 };
+};
+
+CompiledPathPerformanceTestCase::CompiledPathPerformanceTestCase ()
+  : TestCase ("Measure Config::Connect and Disconnect with a compiled path")
+{
+}
+
+void
+CompiledPathPerformanceTestCase::Report (const std::string how,
+                                         const clock_t delta) const
+{
+  double per = 1E6 * double (delta) / (double (REPETITIONS) * CLOCKS_PER_SEC);
+  std::cout << GetParent ()->GetName () << " " << std::left << std::setw (22) << how
+            << std::right << "ticks: " << std::setw (8) << delta
+            << "  per: " << std::setw (8) << per << " us/op"
+            << std::endl;
+}
+
+void
+CompiledPathPerformanceTestCase::DoRun (void)
+{
+  std::cout << std::endl;
+  std::cout << GetParent ()->GetName () << " Performance: " << GetName ()
+            << ", nodes: " << NODES << ", reps: " << REPETITIONS
+            << std::endl;
+
+  // A NodeList like tree: NODES objects, each with one object below it.
+  Ptr<ConfigTestObject> root = CreateObject<ConfigTestObject> ();
+  for (uint32_t i = 0; i < NODES; ++i)
+    {
+      Ptr<ConfigTestObject> node = CreateObject<ConfigTestObject> ();
+      node->SetNodeB (CreateObject<ConfigTestObject> ());
+      root->AddNodeA (node);
+    }
+  Config::RegisterRootNamespaceObject (root);
+
+  const std::string path = "/NodesA/*/NodeB/Source";
+  Callback<void, int16_t, int16_t> cb = MakeCallback (&CompiledPathPerformanceTestCase::Trace, this);
+
+  clock_t start = clock ();
+  for (uint32_t i = 0; i < REPETITIONS; ++i)
+    {
+      Config::ConnectWithoutContext (path, cb);
+      Config::DisconnectWithoutContext (path, cb);
+    }
+  Report ("Config::Connect", clock () - start);
+
+  Config::CompiledPath compiled (path);
+  start = clock ();
+  for (uint32_t i = 0; i < REPETITIONS; ++i)
+    {
+      compiled.ConnectWithoutContext (cb);
+      compiled.DisconnectWithoutContext (cb);
+    }
+  Report ("CompiledPath::Connect", clock () - start);
+
+  compiled.Reset ();
+  Config::UnregisterRootNamespaceObject (root);
+}
+
 // ===========================================================================
 // The Test Suite that glues all of the Test Cases together.
 // ===========================================================================
@@ -737,6 +906,24 @@ ConfigTestSuite::ConfigTestSuite ()
   AddTestCase (new UnderRootNamespaceConfigTestCase, TestCase::QUICK);
   AddTestCase (new ObjectVectorConfigTestCase, TestCase::QUICK);
   AddTestCase (new SearchAttributesOfParentObjectsTestCase, TestCase::QUICK);
+  AddTestCase (new CompiledPathConfigTestCase, TestCase::QUICK);
 }
 
 static ConfigTestSuite configTestSuite;
+
+// ===========================================================================
+// The performance Test Suite, run explicitly with --suite=config-perf.
+// ===========================================================================
+class ConfigPerformanceTestSuite : public TestSuite
+{
+public:
+  ConfigPerformanceTestSuite ();
+};
+
+ConfigPerformanceTestSuite::ConfigPerformanceTestSuite ()
+  : TestSuite ("config-perf", PERFORMANCE)
+{
+  AddTestCase (new CompiledPathPerformanceTestCase, TestCase::QUICK);
+}
+
+static ConfigPerformanceTestSuite configPerformanceTestSuite;
@@ -18,12 +18,16 @@
  */
 
 #include "ns3/int64x64.h"
+#include "ns3/nstime.h"
 #include "ns3/test.h"
+#include "ns3/unused.h"
 #include "ns3/valgrind.h"  // Bug 1882
 
 #include <cmath>    // fabs
+#include <ctime>    // clock
 #include <iomanip>
 #include <limits>   // numeric_limits<>::epsilon ()
+#include <vector>
 
 using namespace ns3;
 
@@ -1244,6 +1248,154 @@ public:
   }
 }  g_int64x64TestSuite;
 
+
+/**
+ * Micro-benchmarks of the int64x64_t operations used by Time,
+ * for comparing the int128, cairo and long double implementations.
+ */
+class Int64x64PerformanceTestCase : public TestCase
+{
+public:
+  Int64x64PerformanceTestCase ();
+  virtual void DoRun (void);
+private:
+  void Report (const std::string how, const clock_t delta) const;
+
+  enum { REPETITIONS = 10000000, TIMES = 1024 };
+};
+
+Int64x64PerformanceTestCase::Int64x64PerformanceTestCase ()
+  : TestCase ("Measure int64x64_t and Time conversion costs")
+{
+}
+
+void
+Int64x64PerformanceTestCase::Report (const std::string how,
+                                     const clock_t delta) const
+{
+  double per = 1E9 * double (delta) / (double (REPETITIONS) * CLOCKS_PER_SEC);
+  std::cout << GetParent ()->GetName () << " " << std::left << std::setw (22) << how
+            << std::right << "ticks: " << std::setw (8) << delta
+            << "  per: " << std::setw (8) << per << " ns/op"
+            << std::endl;
+}
+
+void
+Int64x64PerformanceTestCase::DoRun (void)
+{
+  std::cout << std::endl;
+  std::cout << GetParent ()->GetName () << " Performance: " << GetName ()
+            << ", reps: " << REPETITIONS
+            << std::endl;
+
+  // Accumulate into volatiles so the loops are not optimized away.
+  volatile double dsink = 0;
+  volatile int64_t isink = 0;
+  const int64x64_t step (0, 0x123456789abcdefULL);
+  const int64x64_t factor (1, 0x8000000000000000ULL);
+  const int64x64_t invert = int64x64_t::Invert (1000000000);
+
+  clock_t start = clock ();
+  int64x64_t acc (1);
+  for (uint32_t i = 0; i < REPETITIONS; ++i)
+    {
+      acc += step;
+    }
+  Report ("add", clock () - start);
+  dsink = acc.GetDouble ();
+
+  start = clock ();
+  for (uint32_t i = 0; i < REPETITIONS; ++i)
+    {
+      int64x64_t v (int64_t (i), 0);
+      v *= factor;
+      isink = v.GetHigh ();
+    }
+  Report ("mul", clock () - start);
+
+  start = clock ();
+  for (uint32_t i = 0; i < REPETITIONS; ++i)
+    {
+      int64x64_t v (int64_t (i), 0);
+      v /= factor;
+      isink = v.GetHigh ();
+    }
+  Report ("div", clock () - start);
+
+  start = clock ();
+  for (uint32_t i = 0; i < REPETITIONS; ++i)
+    {
+      int64x64_t v (int64_t (i), 0);
+      v.MulByInvert (invert);
+      isink = v.GetLow ();
+    }
+  Report ("mul by invert", clock () - start);
+
+  start = clock ();
+  for (uint32_t i = 0; i < REPETITIONS; ++i)
+    {
+      dsink = int64x64_t (int64_t (i), 0x123456789ULL).GetDouble ();
+    }
+  Report ("to double", clock () - start);
+
+  start = clock ();
+  for (uint32_t i = 0; i < REPETITIONS; ++i)
+    {
+      dsink = int64x64_t (i * 1.5e-3).GetDouble ();
+    }
+  Report ("from double", clock () - start);
+
+  // Time conversions, in the current resolution.
+  // Construct the Times up front, so we don't measure Time::Mark ().
+  std::vector<Time> times;
+  for (uint32_t i = 0; i < TIMES; ++i)
+    {
+      times.push_back (TimeStep (i * 1000003));
+    }
+
+  start = clock ();
+  for (uint32_t i = 0; i < REPETITIONS; ++i)
+    {
+      dsink = times[i % TIMES].GetSeconds ();
+    }
+  Report ("Time::GetSeconds", clock () - start);
+
+  start = clock ();
+  for (uint32_t i = 0; i < REPETITIONS; ++i)
+    {
+      dsink = times[i % TIMES].To (Time::S).GetDouble ();
+    }
+  Report ("Time::To (S)", clock () - start);
+
+  start = clock ();
+  for (uint32_t i = 0; i < REPETITIONS; ++i)
+    {
+      isink = times[i % TIMES].GetMilliSeconds ();
+    }
+  Report ("Time::GetMilliSeconds", clock () - start);
+
+  start = clock ();
+  for (uint32_t i = 0; i < REPETITIONS; ++i)
+    {
+      isink = Seconds (i * 1.5e-3).GetTimeStep ();
+    }
+  Report ("Seconds (double)", clock () - start);
+
+  NS_UNUSED (dsink);
+  NS_UNUSED (isink);
+}
+
+static class Int64x64PerformanceTestSuite : public TestSuite
+{
+public:
+  Int64x64PerformanceTestSuite ()
+    : TestSuite ("int64x64-perf", PERFORMANCE)
+  {
+    AddTestCase (new Int64x64ImplTestCase (), TestCase::QUICK);
+    AddTestCase (new Int64x64PerformanceTestCase (), TestCase::QUICK);
+  }
+}  g_int64x64PerformanceTestSuite;
+
 }  // namespace test
 
 }  // namespace int64x64
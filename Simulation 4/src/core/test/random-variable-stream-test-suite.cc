@@ -2886,6 +2886,145 @@ RandomVariableStreamEmpiricalAntitheticTestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ_TOL (valueMean, expectedMean, TOLERANCE, "Wrong mean value."); 
 }
 
+// ===========================================
+// Test case for saving and restoring the RNG state
+// ===========================================
+class RandomVariableStreamRngStateTestCase : public TestCase
+{
+public:
+  static const uint32_t N_VALUES = 1000;
+
+  RandomVariableStreamRngStateTestCase ();
+  virtual ~RandomVariableStreamRngStateTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+RandomVariableStreamRngStateTestCase::RandomVariableStreamRngStateTestCase ()
+  : TestCase ("Save and restore the RNG state of a Random Variable Stream")
+{
+}
+
+RandomVariableStreamRngStateTestCase::~RandomVariableStreamRngStateTestCase ()
+{
+}
+
+void
+RandomVariableStreamRngStateTestCase::DoRun (void)
+{
+  SetTestSuiteSeed ();
+
+  Ptr<UniformRandomVariable> x = CreateObject<UniformRandomVariable> ();
+  x->SetStream (1);
+  for (uint32_t i = 0; i < N_VALUES; ++i)
+    {
+      x->GetValue ();
+    }
+
+  // Checkpoint x, then resume the checkpoint in a different stream.
+  uint32_t state[6];
+  x->GetRngState (state);
+
+  Ptr<UniformRandomVariable> y = CreateObject<UniformRandomVariable> ();
+  y->SetStream (2);
+  y->SetRngState (state);
+
+  for (uint32_t i = 0; i < N_VALUES; ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (y->GetValue (), x->GetValue (),
+                             "Restored stream diverged at value " << i);
+    }
+}
+
+// ===========================================================================
+// Test case for drawing values in batches
+// ===========================================================================
+class RandomVariableStreamBatchTestCase : public TestCase
+{
+public:
+  static const uint32_t N_VALUES = 103;
+
+  RandomVariableStreamBatchTestCase ();
+  virtual ~RandomVariableStreamBatchTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Check that a batch of a variable matches single draws of another
+   * variable of the same stream
+   * \param batch The variable drawn in batches.
+   * \param single The variable drawn one value at a time.
+   * \param name The name of the variable.
+   */
+  void Check (Ptr<RandomVariableStream> batch, Ptr<RandomVariableStream> single, std::string name);
+};
+
+RandomVariableStreamBatchTestCase::RandomVariableStreamBatchTestCase ()
+  : TestCase ("Batches of values match single draws")
+{
+}
+
+RandomVariableStreamBatchTestCase::~RandomVariableStreamBatchTestCase ()
+{
+}
+
+void
+RandomVariableStreamBatchTestCase::Check (Ptr<RandomVariableStream> batch, Ptr<RandomVariableStream> single, std::string name)
+{
+  batch->SetStream (5);
+  single->SetStream (5);
+  double values[N_VALUES];
+  batch->GetValues (values, 1);
+  batch->GetValues (values + 1, N_VALUES - 1);
+  for (uint32_t i = 0; i < N_VALUES; ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (values[i], single->GetValue (), name << " diverged at value " << i);
+    }
+}
+
+void
+RandomVariableStreamBatchTestCase::DoRun (void)
+{
+  SetTestSuiteSeed ();
+
+  enum RngStream::Type oldType = RngSeedManager::GetRngType ();
+  const enum RngStream::Type types[2] = { RngStream::MRG32K3A, RngStream::PHILOX4X32 };
+  for (uint32_t t = 0; t < 2; ++t)
+    {
+      RngSeedManager::SetRngType (types[t]);
+      for (uint32_t antithetic = 0; antithetic < 2; ++antithetic)
+        {
+          Ptr<UniformRandomVariable> u[2];
+          Ptr<ExponentialRandomVariable> e[2];
+          Ptr<ExponentialRandomVariable> b[2];
+          Ptr<NormalRandomVariable> n[2];
+          for (uint32_t i = 0; i < 2; ++i)
+            {
+              u[i] = CreateObject<UniformRandomVariable> ();
+              u[i]->SetAttribute ("Min", DoubleValue (-3));
+              u[i]->SetAttribute ("Max", DoubleValue (7));
+              e[i] = CreateObject<ExponentialRandomVariable> ();
+              e[i]->SetAttribute ("Bound", DoubleValue (0));
+              b[i] = CreateObject<ExponentialRandomVariable> ();
+              b[i]->SetAttribute ("Bound", DoubleValue (1.5));
+              n[i] = CreateObject<NormalRandomVariable> ();
+              Ptr<RandomVariableStream> all[4] = { u[i], e[i], b[i], n[i] };
+              for (uint32_t j = 0; j < 4; ++j)
+                {
+                  all[j]->SetAttribute ("Antithetic", BooleanValue (antithetic));
+                }
+            }
+          Check (u[0], u[1], "Uniform");
+          Check (e[0], e[1], "Exponential");
+          Check (b[0], b[1], "Bounded exponential");
+          Check (n[0], n[1], "Normal");
+        }
+    }
+  RngSeedManager::SetRngType (oldType);
+}
+
 class RandomVariableStreamTestSuite : public TestSuite
 {
 public:
@@ -2930,6 +3069,8 @@ RandomVariableStreamTestSuite::RandomVariableStreamTestSuite ()
   AddTestCase (new RandomVariableStreamDeterministicTestCase, TestCase::QUICK);
   AddTestCase (new RandomVariableStreamEmpiricalTestCase, TestCase::QUICK);
   AddTestCase (new RandomVariableStreamEmpiricalAntitheticTestCase, TestCase::QUICK);
+  AddTestCase (new RandomVariableStreamRngStateTestCase, TestCase::QUICK);
+  AddTestCase (new RandomVariableStreamBatchTestCase, TestCase::QUICK);
 }
 
 static RandomVariableStreamTestSuite randomVariableStreamTestSuite;
@@ -25,6 +25,7 @@
 #include "ns3/double.h"
 #include "ns3/random-variable-stream.h"
 #include "ns3/rng-seed-manager.h"
+#include "ns3/rng-stream.h"
 
 using namespace ns3;
 
@@ -51,17 +52,22 @@ public:
   static const uint32_t N_BINS = 50;
   static const uint32_t N_MEASUREMENTS = 1000000;
 
-  RngUniformTestCase ();
+  RngUniformTestCase (enum RngStream::Type type = RngStream::MRG32K3A);
   virtual ~RngUniformTestCase ();
 
   double ChiSquaredTest (Ptr<UniformRandomVariable> u);
 
 private:
   virtual void DoRun (void);
+
+  enum RngStream::Type m_type;
 };
 
-RngUniformTestCase::RngUniformTestCase ()
-  : TestCase ("Uniform Random Number Generator")
+RngUniformTestCase::RngUniformTestCase (enum RngStream::Type type)
+  : TestCase (type == RngStream::PHILOX4X32
+              ? "Uniform Random Number Generator with Philox4x32"
+              : "Uniform Random Number Generator"),
+    m_type (type)
 {
 }
 
@@ -108,6 +114,8 @@ void
 RngUniformTestCase::DoRun (void)
 {
   RngSeedManager::SetSeed (static_cast<uint32_t> (time (0)));
+  enum RngStream::Type oldType = RngSeedManager::GetRngType ();
+  RngSeedManager::SetRngType (m_type);
 
   double sum = 0.;
   double maxStatistic = gsl_cdf_chisq_Qinv (0.05, N_BINS);
@@ -120,6 +128,7 @@ RngUniformTestCase::DoRun (void)
     }
 
   sum /= (double)N_RUNS;
+  RngSeedManager::SetRngType (oldType);
 
   NS_TEST_ASSERT_MSG_LT (sum, maxStatistic, "Chi-squared statistic out of range");
 }
@@ -417,6 +426,118 @@ RngParetoTestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_LT (sum, maxStatistic, "Chi-squared statistic out of range");
 }
 
+// ===========================================================================
+// Test case for the Philox4x32 counter-based generator
+// ===========================================================================
+class RngPhiloxTestCase : public TestCase
+{
+public:
+  RngPhiloxTestCase ();
+  virtual ~RngPhiloxTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+RngPhiloxTestCase::RngPhiloxTestCase ()
+  : TestCase ("Philox4x32 known answers and stream positioning")
+{
+}
+
+RngPhiloxTestCase::~RngPhiloxTestCase ()
+{
+}
+
+void
+RngPhiloxTestCase::DoRun (void)
+{
+  RngStream rng (1, 0, 0, RngStream::PHILOX4X32);
+  NS_TEST_ASSERT_MSG_EQ (rng.GetType (), RngStream::PHILOX4X32, "Wrong generator type");
+
+  // Known answer for key {0, 0}, counter {0, 0, 0, 0}, from the
+  // Random123 kat_vectors.
+  const uint32_t zero[6] = { 0, 0, 0, 0, 0, 0 };
+  rng.SetState (zero);
+  const uint32_t expected[4] = { 0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8 };
+  for (uint32_t i = 0; i < 4; ++i)
+    {
+      double word = rng.RandU01 () * 4294967296.0 - 0.5;
+      NS_TEST_ASSERT_MSG_EQ (static_cast<uint32_t> (word), expected[i],
+                             "Philox4x32-10 known answer " << i);
+    }
+
+  // Jumping to a position gives the same values as drawing up to it.
+  RngStream a (12345, 7, 3, RngStream::PHILOX4X32);
+  for (uint32_t i = 0; i < 1001; ++i)
+    {
+      a.RandU01 ();
+    }
+  uint32_t state[6];
+  a.GetState (state);
+  NS_TEST_ASSERT_MSG_EQ (state[4], 1001, "Wrong position");
+
+  RngStream b (12345, 7, 3, RngStream::PHILOX4X32);
+  b.SetState (state);
+  for (uint32_t i = 0; i < 100; ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (b.RandU01 (), a.RandU01 (), "Jump diverged at " << i);
+    }
+
+  // Streams and substreams must differ.
+  RngStream c (12345, 8, 3, RngStream::PHILOX4X32);
+  RngStream d (12345, 7, 4, RngStream::PHILOX4X32);
+  RngStream e (12345, 7, 3, RngStream::PHILOX4X32);
+  double ve = e.RandU01 ();
+  NS_TEST_ASSERT_MSG_NE (c.RandU01 (), ve, "Streams not independent");
+  NS_TEST_ASSERT_MSG_NE (d.RandU01 (), ve, "Substreams not independent");
+}
+
+// ===========================================================================
+// Test case for drawing uniform values in batches
+// ===========================================================================
+class RngBatchTestCase : public TestCase
+{
+public:
+  RngBatchTestCase ();
+  virtual ~RngBatchTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+RngBatchTestCase::RngBatchTestCase ()
+  : TestCase ("Batches of uniform values match single draws")
+{
+}
+
+RngBatchTestCase::~RngBatchTestCase ()
+{
+}
+
+void
+RngBatchTestCase::DoRun (void)
+{
+  const enum RngStream::Type types[2] = { RngStream::MRG32K3A, RngStream::PHILOX4X32 };
+  // batch sizes which start and end inside and on Philox blocks
+  const uint32_t sizes[8] = { 1, 3, 4, 0, 5, 17, 64, 2 };
+  for (uint32_t t = 0; t < 2; ++t)
+    {
+      RngStream single (12345, 7, 3, types[t]);
+      RngStream batch (12345, 7, 3, types[t]);
+      double values[64];
+      for (uint32_t i = 0; i < 8; ++i)
+        {
+          batch.RandU01 (values, sizes[i]);
+          for (uint32_t j = 0; j < sizes[i]; ++j)
+            {
+              NS_TEST_ASSERT_MSG_EQ (values[j], single.RandU01 (),
+                                     "Batch " << i << " diverged at " << j << " with generator " << t);
+            }
+        }
+      NS_TEST_ASSERT_MSG_EQ (batch.RandU01 (), single.RandU01 (), "Diverged after the batches");
+    }
+}
+
 class RngTestSuite : public TestSuite
 {
 public:
@@ -427,6 +548,9 @@ RngTestSuite::RngTestSuite ()
   : TestSuite ("random-number-generators", UNIT)
 {
   AddTestCase (new RngUniformTestCase, TestCase::QUICK);
+  AddTestCase (new RngUniformTestCase (RngStream::PHILOX4X32), TestCase::QUICK);
+  AddTestCase (new RngPhiloxTestCase, TestCase::QUICK);
+  AddTestCase (new RngBatchTestCase, TestCase::QUICK);
   AddTestCase (new RngNormalTestCase, TestCase::QUICK);
   AddTestCase (new RngExponentialTestCase, TestCase::QUICK);
   AddTestCase (new RngParetoTestCase, TestCase::QUICK);
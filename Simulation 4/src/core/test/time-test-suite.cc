@@ -20,8 +20,10 @@
  * TimeStep support by Emmanuelle Laprise <emmanuelle.laprise@bluekazoo.ca>
  */
 
+#include <cmath>
 #include <iomanip>
 #include <iostream>
+#include <limits>
 #include <string>
 #include <sstream>
 
@@ -229,7 +231,64 @@ TimeInputOutputTestCase::DoRun (void)
 
   std::cout << std::endl;
 }
-    
+
+class TimeToDoubleTestCase : public TestCase
+{
+public:
+  TimeToDoubleTestCase ();
+private:
+  virtual void DoRun (void);
+  void Check (const Time & t, const enum Time::Unit unit);
+};
+
+TimeToDoubleTestCase::TimeToDoubleTestCase ()
+  : TestCase ("Check the ToDouble fast path against int64x64_t")
+{
+}
+
+void
+TimeToDoubleTestCase::Check (const Time & t, const enum Time::Unit unit)
+{
+  const double fast = t.ToDouble (unit);
+  if (std::fabs (fast) >= std::ldexp (1.0, 62))
+    {
+      // Out of range for int64x64_t, nothing to compare against
+      return;
+    }
+  const double slow = t.To (unit).GetDouble ();
+  // The fast path is correctly rounded, the int64x64_t path is only
+  // good to a few bits of the Q64.64 fraction.
+  const double tolerance =
+    2 * std::fabs (slow) * std::numeric_limits<double>::epsilon ()
+    + std::ldexp (1.0, -62);
+  NS_TEST_ASSERT_MSG_EQ_TOL (fast, slow, tolerance,
+                             "ToDouble (" << unit << ") of " << t.GetTimeStep ());
+}
+
+void
+TimeToDoubleTestCase::DoRun (void)
+{
+  const int64_t steps[] = {
+    0, 1, -1, 7, 999, 1000, 1001, 123456789, -987654321,
+    1000000000LL, 3600000000000LL, 86399999999999LL,
+    9007199254740992LL, -9007199254740992LL,
+    // Beyond 2^53, take the int64x64_t path
+    9007199254740993LL, 4611686018427387904LL, -4611686018427387904LL
+  };
+  for (uint32_t i = 0; i < sizeof (steps) / sizeof (steps[0]); ++i)
+    {
+      const Time t = TimeStep (steps[i]);
+      for (int unit = Time::Y; unit < Time::LAST; ++unit)
+        {
+          Check (t, static_cast<enum Time::Unit> (unit));
+        }
+    }
+
+  NS_TEST_ASSERT_MSG_EQ (Seconds (1.5).GetSeconds (), 1.5, "1.5 s exactly");
+  NS_TEST_ASSERT_MSG_EQ (MilliSeconds (-250).GetSeconds (), -0.25, "-0.25 s exactly");
+  NS_TEST_ASSERT_MSG_EQ (NanoSeconds (1).ToDouble (Time::PS), 1000.0, "1000 ps exactly");
+}
+
 static class TimeTestSuite : public TestSuite
 {
 public:
@@ -238,6 +297,7 @@ public:
   {
     AddTestCase (new TimeWithSignTestCase (), TestCase::QUICK);
     AddTestCase (new TimeInputOutputTestCase (), TestCase::QUICK);
+    AddTestCase (new TimeToDoubleTestCase (), TestCase::QUICK);
     // This should be last, since it changes the resolution
     AddTestCase (new TimeSimpleTestCase (), TestCase::QUICK);
   }
@@ -18,6 +18,10 @@
 
 #include "ns3/test.h"
 #include "ns3/traced-callback.h"
+#include "ns3/traced-value.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/simple-ref-count.h"
+#include <iostream>
 
 using namespace ns3;
 
@@ -108,6 +112,201 @@ BasicTracedCallbackTestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ (m_two, true, "Callback CbTwo not called");
 }
 
+/**
+ * A sink which tells when it is destroyed.
+ */
+class TracedCallbackSink : public SimpleRefCount<TracedCallbackSink>
+{
+public:
+  /**
+   * Constructor
+   * \param destroyed set when the sink is destroyed
+   */
+  TracedCallbackSink (bool *destroyed)
+    : m_destroyed (destroyed)
+  {
+  }
+  ~TracedCallbackSink ()
+  {
+    *m_destroyed = true;
+  }
+  /**
+   * The sink
+   * \param a the value traced
+   */
+  void Cb (uint32_t a)
+  {
+  }
+
+private:
+  bool *m_destroyed; ///< set when the sink is destroyed
+};
+
+class ReentrantTracedCallbackTestCase : public TestCase
+{
+public:
+  ReentrantTracedCallbackTestCase ();
+  virtual ~ReentrantTracedCallbackTestCase () {}
+
+private:
+  virtual void DoRun (void);
+
+  void CbDisconnect (uint32_t a);
+  void CbDisconnectCount (uint32_t a);
+  void CbConnect (uint32_t a);
+  void CbCount (uint32_t a);
+  void CbThrow (uint32_t a);
+  void CbValue (uint32_t oldValue, uint32_t newValue);
+
+  TracedCallback<uint32_t> m_trace;
+  uint32_t m_count;
+  uint32_t m_values;
+};
+
+ReentrantTracedCallbackTestCase::ReentrantTracedCallbackTestCase ()
+  : TestCase ("Check TracedCallback changes from a Callback, and TracedValue with no Callback")
+{
+}
+
+void
+ReentrantTracedCallbackTestCase::CbDisconnect (uint32_t a)
+{
+  m_trace.DisconnectWithoutContext (MakeCallback (&ReentrantTracedCallbackTestCase::CbDisconnect, this));
+}
+
+void
+ReentrantTracedCallbackTestCase::CbDisconnectCount (uint32_t a)
+{
+  m_trace.DisconnectWithoutContext (MakeCallback (&ReentrantTracedCallbackTestCase::CbCount, this));
+}
+
+void
+ReentrantTracedCallbackTestCase::CbConnect (uint32_t a)
+{
+  m_trace.ConnectWithoutContext (MakeCallback (&ReentrantTracedCallbackTestCase::CbCount, this));
+}
+
+void
+ReentrantTracedCallbackTestCase::CbCount (uint32_t a)
+{
+  m_count++;
+}
+
+void
+ReentrantTracedCallbackTestCase::CbThrow (uint32_t a)
+{
+  throw a;
+}
+
+void
+ReentrantTracedCallbackTestCase::CbValue (uint32_t oldValue, uint32_t newValue)
+{
+  m_values++;
+}
+
+void
+ReentrantTracedCallbackTestCase::DoRun (void)
+{
+  NS_TEST_ASSERT_MSG_EQ (m_trace.IsEmpty (), true, "New TracedCallback is not empty");
+
+  //
+  // A Callback which disconnects itself.
+  //
+  m_trace.ConnectWithoutContext (MakeCallback (&ReentrantTracedCallbackTestCase::CbCount, this));
+  m_trace.ConnectWithoutContext (MakeCallback (&ReentrantTracedCallbackTestCase::CbDisconnect, this));
+  NS_TEST_ASSERT_MSG_EQ (m_trace.IsEmpty (), false, "TracedCallback with Callbacks is empty");
+  m_count = 0;
+  m_trace (1);
+  m_trace (2);
+  NS_TEST_ASSERT_MSG_EQ (m_count, 2, "Callback before a disconnected Callback not called");
+  m_trace.DisconnectWithoutContext (MakeCallback (&ReentrantTracedCallbackTestCase::CbCount, this));
+  NS_TEST_ASSERT_MSG_EQ (m_trace.IsEmpty (), true, "TracedCallback without Callbacks is not empty");
+
+  //
+  // A Callback which disconnects itself before the others: the
+  // Callbacks after it are all called.
+  //
+  m_trace.ConnectWithoutContext (MakeCallback (&ReentrantTracedCallbackTestCase::CbDisconnect, this));
+  m_trace.ConnectWithoutContext (MakeCallback (&ReentrantTracedCallbackTestCase::CbCount, this));
+  m_trace.ConnectWithoutContext (MakeCallback (&ReentrantTracedCallbackTestCase::CbCount, this));
+  m_count = 0;
+  m_trace (1);
+  NS_TEST_ASSERT_MSG_EQ (m_count, 2, "Callback after a disconnected Callback not called");
+  m_trace (2);
+  NS_TEST_ASSERT_MSG_EQ (m_count, 4, "Callback after a disconnected Callback not called");
+
+  //
+  // A Callback which disconnects the Callbacks after it: they are not
+  // called, in this firing or the next ones.
+  //
+  m_trace.ConnectWithoutContext (MakeCallback (&ReentrantTracedCallbackTestCase::CbDisconnectCount, this));
+  m_count = 0;
+  m_trace (3);
+  NS_TEST_ASSERT_MSG_EQ (m_count, 2, "Callbacks before the disconnection not called");
+  m_trace.DisconnectWithoutContext (MakeCallback (&ReentrantTracedCallbackTestCase::CbDisconnectCount, this));
+  m_trace.ConnectWithoutContext (MakeCallback (&ReentrantTracedCallbackTestCase::CbDisconnectCount, this));
+  m_trace.ConnectWithoutContext (MakeCallback (&ReentrantTracedCallbackTestCase::CbCount, this));
+  m_trace.ConnectWithoutContext (MakeCallback (&ReentrantTracedCallbackTestCase::CbCount, this));
+  m_count = 0;
+  m_trace (4);
+  m_trace (5);
+  NS_TEST_ASSERT_MSG_EQ (m_count, 0, "Disconnected Callbacks called");
+  NS_TEST_ASSERT_MSG_EQ (m_trace.IsEmpty (), false, "TracedCallback with a Callback is empty");
+  m_trace.DisconnectWithoutContext (MakeCallback (&ReentrantTracedCallbackTestCase::CbDisconnectCount, this));
+  NS_TEST_ASSERT_MSG_EQ (m_trace.IsEmpty (), true, "TracedCallback without Callbacks is not empty");
+
+  //
+  // A Callback which connects a new Callback every time, however the
+  // storage of the chain moves.  The new Callback is called right away.
+  //
+  m_trace.ConnectWithoutContext (MakeCallback (&ReentrantTracedCallbackTestCase::CbConnect, this));
+  for (uint32_t i = 0; i < 100; i++)
+    {
+      m_trace (3);
+    }
+  m_count = 0;
+  m_trace (4);
+  NS_TEST_ASSERT_MSG_EQ (m_count, 101, "Wrong number of Callbacks called");
+
+  //
+  // A Callback which throws ends the firing: a Callback disconnected
+  // afterwards is released at once.
+  //
+  TracedCallback<uint32_t> trace;
+  bool destroyed = false;
+  Ptr<TracedCallbackSink> sink = Create<TracedCallbackSink> (&destroyed);
+  trace.ConnectWithoutContext (MakeCallback (&TracedCallbackSink::Cb, sink));
+  trace.ConnectWithoutContext (MakeCallback (&ReentrantTracedCallbackTestCase::CbThrow, this));
+  bool thrown = false;
+  try
+    {
+      trace (5);
+    }
+  catch (uint32_t a)
+    {
+      thrown = true;
+    }
+  NS_TEST_ASSERT_MSG_EQ (thrown, true, "Exception of a Callback not propagated");
+  trace.DisconnectWithoutContext (MakeCallback (&TracedCallbackSink::Cb, sink));
+  sink = 0;
+  NS_TEST_ASSERT_MSG_EQ (destroyed, true, "Callback disconnected after an exception still held");
+
+  //
+  // A TracedValue keeps its value with or without Callback.
+  //
+  TracedValue<uint32_t> value = 1;
+  value++;
+  value += 3;
+  NS_TEST_ASSERT_MSG_EQ (value.Get (), 5, "Wrong value of an unconnected TracedValue");
+  m_values = 0;
+  value.ConnectWithoutContext (MakeCallback (&ReentrantTracedCallbackTestCase::CbValue, this));
+  value = 5;
+  NS_TEST_ASSERT_MSG_EQ (m_values, 0, "Callback called for an unchanged value");
+  ++value;
+  NS_TEST_ASSERT_MSG_EQ (m_values, 1, "Callback not called for a changed value");
+  NS_TEST_ASSERT_MSG_EQ (value.Get (), 6, "Wrong value of a connected TracedValue");
+}
+
 class TracedCallbackTestSuite : public TestSuite
 {
 public:
@@ -118,6 +317,133 @@ TracedCallbackTestSuite::TracedCallbackTestSuite ()
   : TestSuite ("traced-callback", UNIT)
 {
   AddTestCase (new BasicTracedCallbackTestCase, TestCase::QUICK);
+  AddTestCase (new ReentrantTracedCallbackTestCase, TestCase::QUICK);
 }
 
 static TracedCallbackTestSuite tracedCallbackTestSuite;
+
+
+//----------------------------
+//
+// Performance test
+
+/**
+ * Measure the cost of firing trace sources, with and without
+ * Callbacks connected.
+ */
+class TracedCallbackPerformanceTestCase : public TestCase
+{
+public:
+  TracedCallbackPerformanceTestCase ();
+  virtual ~TracedCallbackPerformanceTestCase () {}
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Print the time taken by a number of operations.
+   * \param how what was measured.
+   * \param clock the clock started before the operations.
+   */
+  void Report (std::string how, SystemWallClockMs &clock) const;
+
+  void CbOne (uint32_t a, double b);
+  void CbValue (uint32_t oldValue, uint32_t newValue);
+
+  enum { REPETITIONS = 10000000 };
+
+  uint64_t m_calls;
+};
+
+TracedCallbackPerformanceTestCase::TracedCallbackPerformanceTestCase ()
+  : TestCase ("Measure the cost of TracedCallback and TracedValue")
+{
+}
+
+void
+TracedCallbackPerformanceTestCase::CbOne (uint32_t a, double b)
+{
+  m_calls++;
+}
+
+void
+TracedCallbackPerformanceTestCase::CbValue (uint32_t oldValue, uint32_t newValue)
+{
+  m_calls++;
+}
+
+void
+TracedCallbackPerformanceTestCase::Report (std::string how, SystemWallClockMs &clock) const
+{
+  int64_t ms = clock.End ();
+  std::cout << "traced-callback-perf: " << how << ": "
+            << ms << " ms, "
+            << (ms * 1e6 / REPETITIONS) << " ns/call"
+            << std::endl;
+}
+
+void
+TracedCallbackPerformanceTestCase::DoRun (void)
+{
+  SystemWallClockMs clock;
+  m_calls = 0;
+
+  TracedCallback<uint32_t, double> trace;
+  clock.Start ();
+  for (uint32_t i = 0; i < REPETITIONS; ++i)
+    {
+      trace (i, 1.0);
+    }
+  Report ("TracedCallback, no Callback", clock);
+
+  trace.ConnectWithoutContext (MakeCallback (&TracedCallbackPerformanceTestCase::CbOne, this));
+  clock.Start ();
+  for (uint32_t i = 0; i < REPETITIONS; ++i)
+    {
+      trace (i, 1.0);
+    }
+  Report ("TracedCallback, 1 Callback", clock);
+
+  for (uint32_t k = 0; k < 3; ++k)
+    {
+      trace.ConnectWithoutContext (MakeCallback (&TracedCallbackPerformanceTestCase::CbOne, this));
+    }
+  clock.Start ();
+  for (uint32_t i = 0; i < REPETITIONS; ++i)
+    {
+      trace (i, 1.0);
+    }
+  Report ("TracedCallback, 4 Callbacks", clock);
+
+  TracedValue<uint32_t> value = 0;
+  clock.Start ();
+  for (uint32_t i = 0; i < REPETITIONS; ++i)
+    {
+      ++value;
+    }
+  Report ("TracedValue, no Callback", clock);
+
+  value.ConnectWithoutContext (MakeCallback (&TracedCallbackPerformanceTestCase::CbValue, this));
+  clock.Start ();
+  for (uint32_t i = 0; i < REPETITIONS; ++i)
+    {
+      ++value;
+    }
+  Report ("TracedValue, 1 Callback", clock);
+
+  NS_TEST_ASSERT_MSG_EQ (m_calls, 6ULL * REPETITIONS, "Wrong number of Callbacks called");
+}
+
+class TracedCallbackPerformanceTestSuite : public TestSuite
+{
+public:
+  TracedCallbackPerformanceTestSuite ();
+};
+
+TracedCallbackPerformanceTestSuite::TracedCallbackPerformanceTestSuite ()
+  : TestSuite ("traced-callback-perf", PERFORMANCE)
+{
+  AddTestCase (new TracedCallbackPerformanceTestCase, TestCase::QUICK);
+}
+
+static TracedCallbackPerformanceTestSuite tracedCallbackPerformanceTestSuite;
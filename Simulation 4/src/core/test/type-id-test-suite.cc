@@ -21,8 +21,10 @@
 #include <iostream>
 #include <iomanip>
 #include <ctime>
+#include <vector>
 
 #include "ns3/type-id.h"
+#include "ns3/trace-source-accessor.h"
 #include "ns3/test.h"
 #include "ns3/log.h"
 
@@ -188,6 +190,91 @@ CollisionTestCase::DoRun (void)
 }
   
   
+//----------------------------
+//
+// Test the by-name lookups against a linear search
+
+class NameLookupTestCase : public TestCase
+{
+public:
+  NameLookupTestCase ();
+  virtual ~NameLookupTestCase ();
+private:
+  virtual void DoRun (void);
+};
+
+NameLookupTestCase::NameLookupTestCase ()
+  : TestCase ("Check TypeId, Attribute and TraceSource lookup by name")
+{
+}
+
+NameLookupTestCase::~NameLookupTestCase ()
+{
+}
+
+void
+NameLookupTestCase::DoRun (void)
+{
+  uint32_t nids = TypeId::GetRegisteredN ();
+  for (uint32_t i = 0; i < nids; ++i)
+    {
+      const TypeId tid = TypeId::GetRegistered (i);
+
+      // Run after the CollisionTestCase, so this includes chained TypeIds
+      NS_TEST_ASSERT_MSG_EQ (tid.GetUid (),
+                             TypeId::LookupByName (tid.GetName ()).GetUid (),
+                             "LookupByName returned different TypeId for "
+                             << tid.GetName ());
+
+      for (uint32_t j = 0; j < tid.GetAttributeN (); ++j)
+        {
+          struct TypeId::AttributeInformation expected = tid.GetAttribute (j);
+          struct TypeId::AttributeInformation info;
+          bool found = tid.LookupAttributeByName (expected.name, &info);
+          NS_TEST_ASSERT_MSG_EQ (found, true,
+                                 "Attribute " << expected.name
+                                 << " not found in " << tid.GetName ());
+          NS_TEST_ASSERT_MSG_EQ (info.name, expected.name,
+                                 "Wrong Attribute found in " << tid.GetName ());
+          NS_TEST_ASSERT_MSG_EQ (info.accessor, expected.accessor,
+                                 "Wrong Attribute " << expected.name
+                                 << " found in " << tid.GetName ());
+        }
+      for (uint32_t j = 0; j < tid.GetTraceSourceN (); ++j)
+        {
+          struct TypeId::TraceSourceInformation expected = tid.GetTraceSource (j);
+          NS_TEST_ASSERT_MSG_EQ (tid.LookupTraceSourceByName (expected.name),
+                                 expected.accessor,
+                                 "Wrong TraceSource " << expected.name
+                                 << " found in " << tid.GetName ());
+        }
+
+      // Inherited names are found through the parent
+      TypeId parent = tid.GetParent ();
+      if (parent.GetUid () != 0 && parent != tid && parent.GetAttributeN () > 0)
+        {
+          struct TypeId::AttributeInformation info;
+          std::string name = parent.GetAttribute (0).name;
+          NS_TEST_ASSERT_MSG_EQ (tid.LookupAttributeByName (name, &info), true,
+                                 "Inherited Attribute " << name
+                                 << " not found in " << tid.GetName ());
+        }
+
+      struct TypeId::AttributeInformation info;
+      NS_TEST_ASSERT_MSG_EQ (tid.LookupAttributeByName ("NoSuchAttribute", &info),
+                             false,
+                             "Bogus Attribute found in " << tid.GetName ());
+      NS_TEST_ASSERT_MSG_EQ (tid.LookupTraceSourceByName ("NoSuchTraceSource"),
+                             0,
+                             "Bogus TraceSource found in " << tid.GetName ());
+    }
+
+  TypeId tid;
+  NS_TEST_ASSERT_MSG_EQ (TypeId::LookupByNameFailSafe ("ns3::NoSuchTypeId", &tid),
+                         false, "Bogus TypeId found");
+}
+
+
 //----------------------------
 //
 // Performance test
@@ -201,6 +288,8 @@ private:
   void DoRun (void);
   void DoSetup (void);
   void Report (const std::string how, const uint32_t delta) const ;
+  void Report (const std::string how, const uint32_t delta,
+               const double lookups) const ;
 
   enum { REPETITIONS = 100000 };
 };
@@ -245,7 +334,47 @@ LookupTimeTestCase::DoRun (void)
   }
   stop = clock ();
   Report ("hash", stop - start);
-  
+
+  // Attribute and TraceSource names, looked up from the TypeId which
+  // declares them, as ObjectBase::SetAttribute and Config do.
+  std::vector<std::pair<TypeId, std::string> > attributes;
+  std::vector<std::pair<TypeId, std::string> > sources;
+  for (uint32_t i = 0; i < nids; ++i)
+    {
+      const TypeId tid = TypeId::GetRegistered (i);
+      for (uint32_t k = 0; k < tid.GetAttributeN (); ++k)
+        {
+          attributes.push_back (std::make_pair (tid, tid.GetAttribute (k).name));
+        }
+      for (uint32_t k = 0; k < tid.GetTraceSourceN (); ++k)
+        {
+          sources.push_back (std::make_pair (tid, tid.GetTraceSource (k).name));
+        }
+    }
+  uint32_t reps = REPETITIONS / 10;
+
+  struct TypeId::AttributeInformation info;
+  start = clock ();
+  for (uint32_t j = 0; j < reps; ++j)
+    {
+      for (uint32_t i = 0; i < attributes.size (); ++i)
+        {
+          attributes[i].first.LookupAttributeByName (attributes[i].second, &info);
+        }
+    }
+  stop = clock ();
+  Report ("attribute name", stop - start, double (attributes.size ()) * reps);
+
+  start = clock ();
+  for (uint32_t j = 0; j < reps; ++j)
+    {
+      for (uint32_t i = 0; i < sources.size (); ++i)
+        {
+          sources[i].first.LookupTraceSourceByName (sources[i].second);
+        }
+    }
+  stop = clock ();
+  Report ("trace source name", stop - start, double (sources.size ()) * reps);
 }
 
 void
@@ -264,8 +393,14 @@ LookupTimeTestCase::Report (const std::string how,
                             const uint32_t    delta) const
 {
   double nids = TypeId::GetRegisteredN ();
-  double reps = nids * REPETITIONS;
-  
+  Report (how, delta, nids * REPETITIONS);
+}
+
+void
+LookupTimeTestCase::Report (const std::string how,
+                            const uint32_t    delta,
+                            const double      reps) const
+{
   double per = 1E6 * double(delta) / (reps * double(CLOCKS_PER_SEC));
   
   cout << suite << "Lookup time: by " << how << ": "
@@ -298,6 +433,7 @@ TypeIdTestSuite::TypeIdTestSuite ()
   // as chained.
   AddTestCase (new UniqueTypeIdTestCase, QUICK);
   AddTestCase (new CollisionTestCase, QUICK);
+  AddTestCase (new NameLookupTestCase, QUICK);
 }
 
 static TypeIdTestSuite g_TypeIdTestSuite;  
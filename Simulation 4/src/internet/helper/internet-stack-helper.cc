@@ -178,6 +178,7 @@
 #include "ns3/traffic-control-layer.h"
 #include <limits>
 #include <map>
+#include <sstream>
 
 namespace ns3 {
 
@@ -193,6 +194,24 @@ NS_LOG_COMPONENT_DEFINE ("InternetStackHelper");
 //
 #define INTERFACE_CONTEXT
 
+/**
+ * \brief Context of a trace event in the binary trace files.
+ * \param context the context of the trace source
+ * \param interface the interface of the event
+ * \returns the context as written to the ascii traces
+ */
+static std::string
+InterfaceContext (std::string const &context, uint32_t interface)
+{
+#ifdef INTERFACE_CONTEXT
+  std::ostringstream oss;
+  oss << context << "(" << interface << ")";
+  return oss.str ();
+#else
+  return context;
+#endif
+}
+
 //
 // Things are going to work differently here with respect to trace file handling
 // than in most places because the Tx and Rx trace sources we are interested in
@@ -718,6 +737,12 @@ Ipv4L3ProtocolDropSinkWithoutContext (
 
   Ptr<Packet> p = packet->Copy ();
   p->AddHeader (header);
+  Ptr<BinaryTraceWriter> binary = stream->GetBinaryTrace ();
+  if (binary != 0)
+    {
+      binary->Record ('d', p);
+      return;
+    }
   *stream->GetStream () << "d " << Simulator::Now ().GetSeconds () << " " << *p << std::endl;
 }
 
@@ -742,6 +767,12 @@ Ipv4L3ProtocolTxSinkWithoutContext (
       return;
     }
 
+  Ptr<BinaryTraceWriter> binary = stream->GetBinaryTrace ();
+  if (binary != 0)
+    {
+      binary->Record ('t', packet);
+      return;
+    }
   *stream->GetStream () << "t " << Simulator::Now ().GetSeconds () << " " << *packet << std::endl;
 }
 
@@ -766,6 +797,12 @@ Ipv4L3ProtocolRxSinkWithoutContext (
       return;
     }
 
+  Ptr<BinaryTraceWriter> binary = stream->GetBinaryTrace ();
+  if (binary != 0)
+    {
+      binary->Record ('r', packet);
+      return;
+    }
   *stream->GetStream () << "r " << Simulator::Now ().GetSeconds () << " " << *packet << std::endl;
 }
 
@@ -804,6 +841,12 @@ Ipv4L3ProtocolDropSinkWithContext (
 
   Ptr<Packet> p = packet->Copy ();
   p->AddHeader (header);
+  Ptr<BinaryTraceWriter> binary = stream->GetBinaryTrace ();
+  if (binary != 0)
+    {
+      binary->Record ('d', InterfaceContext (context, interface), p);
+      return;
+    }
 #ifdef INTERFACE_CONTEXT
   *stream->GetStream () << "d " << Simulator::Now ().GetSeconds () << " " << context << "(" << interface << ") " 
                         << *p << std::endl;
@@ -835,6 +878,12 @@ Ipv4L3ProtocolTxSinkWithContext (
       return;
     }
 
+  Ptr<BinaryTraceWriter> binary = stream->GetBinaryTrace ();
+  if (binary != 0)
+    {
+      binary->Record ('t', InterfaceContext (context, interface), packet);
+      return;
+    }
 #ifdef INTERFACE_CONTEXT
   *stream->GetStream () << "t " << Simulator::Now ().GetSeconds () << " " << context << "(" << interface << ") " 
                         << *packet << std::endl;
@@ -866,6 +915,12 @@ Ipv4L3ProtocolRxSinkWithContext (
       return;
     }
 
+  Ptr<BinaryTraceWriter> binary = stream->GetBinaryTrace ();
+  if (binary != 0)
+    {
+      binary->Record ('r', InterfaceContext (context, interface), packet);
+      return;
+    }
 #ifdef INTERFACE_CONTEXT
   *stream->GetStream () << "r " << Simulator::Now ().GetSeconds () << " " << context << "(" << interface << ") " 
                         << *packet << std::endl;
@@ -1056,6 +1111,12 @@ Ipv6L3ProtocolDropSinkWithoutContext (
 
   Ptr<Packet> p = packet->Copy ();
   p->AddHeader (header);
+  Ptr<BinaryTraceWriter> binary = stream->GetBinaryTrace ();
+  if (binary != 0)
+    {
+      binary->Record ('d', p);
+      return;
+    }
   *stream->GetStream () << "d " << Simulator::Now ().GetSeconds () << " " << *p << std::endl;
 }
 
@@ -1080,6 +1141,12 @@ Ipv6L3ProtocolTxSinkWithoutContext (
       return;
     }
 
+  Ptr<BinaryTraceWriter> binary = stream->GetBinaryTrace ();
+  if (binary != 0)
+    {
+      binary->Record ('t', packet);
+      return;
+    }
   *stream->GetStream () << "t " << Simulator::Now ().GetSeconds () << " " << *packet << std::endl;
 }
 
@@ -1104,6 +1171,12 @@ Ipv6L3ProtocolRxSinkWithoutContext (
       return;
     }
 
+  Ptr<BinaryTraceWriter> binary = stream->GetBinaryTrace ();
+  if (binary != 0)
+    {
+      binary->Record ('r', packet);
+      return;
+    }
   *stream->GetStream () << "r " << Simulator::Now ().GetSeconds () << " " << *packet << std::endl;
 }
 
@@ -1142,6 +1215,12 @@ Ipv6L3ProtocolDropSinkWithContext (
 
   Ptr<Packet> p = packet->Copy ();
   p->AddHeader (header);
+  Ptr<BinaryTraceWriter> binary = stream->GetBinaryTrace ();
+  if (binary != 0)
+    {
+      binary->Record ('d', InterfaceContext (context, interface), p);
+      return;
+    }
 #ifdef INTERFACE_CONTEXT
   *stream->GetStream () << "d " << Simulator::Now ().GetSeconds () << " " << context << "(" << interface << ") " 
                         << *p << std::endl;
@@ -1173,6 +1252,12 @@ Ipv6L3ProtocolTxSinkWithContext (
       return;
     }
 
+  Ptr<BinaryTraceWriter> binary = stream->GetBinaryTrace ();
+  if (binary != 0)
+    {
+      binary->Record ('t', InterfaceContext (context, interface), packet);
+      return;
+    }
 #ifdef INTERFACE_CONTEXT
   *stream->GetStream () << "t " << Simulator::Now ().GetSeconds () << " " << context << "(" << interface << ") " 
                         << *packet << std::endl;
@@ -1204,6 +1289,12 @@ Ipv6L3ProtocolRxSinkWithContext (
       return;
     }
 
+  Ptr<BinaryTraceWriter> binary = stream->GetBinaryTrace ();
+  if (binary != 0)
+    {
+      binary->Record ('r', InterfaceContext (context, interface), packet);
+      return;
+    }
 #ifdef INTERFACE_CONTEXT
   *stream->GetStream () << "r " << Simulator::Now ().GetSeconds () << " " << context << "(" << interface << ") " 
                         << *packet << std::endl;
@@ -0,0 +1,77 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+//
+//  This program turns the binary ascii trace files of the coexistence
+//  scenarios back into the text the ascii traces would have had.
+//
+//  The scenarios write binary trace files instead of text when run with
+//  the global value AsciiTraceFormat set to Binary, e.g.
+//
+//    ./waf --run "laa-wifi-simple --asciiEnabled=1 --AsciiTraceFormat=Binary"
+//    ./waf --run "decode-binary-trace --input=laa-wifi-ap-0-0.tr --output=ap.tr"
+//
+//  The packets of a trace can only be printed by a program that knows
+//  all their headers, so this one is linked with the modules of the
+//  scenarios.
+//
+
+#include <iostream>
+#include <fstream>
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/laa-wifi-coexistence-helper.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/applications-module.h"
+
+using namespace ns3;
+
+int
+main (int argc, char *argv[])
+{
+  std::string input;
+  std::string output;
+
+  CommandLine cmd;
+  cmd.AddValue ("input", "the binary trace file to decode", input);
+  cmd.AddValue ("output", "the text file to write, or empty for the standard output", output);
+  cmd.Parse (argc, argv);
+
+  if (input.empty ())
+    {
+      std::cerr << "decode-binary-trace: --input is required" << std::endl;
+      return 1;
+    }
+
+  std::ofstream file;
+  if (!output.empty ())
+    {
+      file.open (output.c_str ());
+      if (!file.is_open ())
+        {
+          std::cerr << "decode-binary-trace: cannot open " << output << std::endl;
+          return 1;
+        }
+    }
+  std::ostream &os = output.empty () ? std::cout : file;
+
+  if (!BinaryTraceReader::Decode (input, os))
+    {
+      std::cerr << "decode-binary-trace: " << input << " is not a binary trace file or is truncated" << std::endl;
+      return 1;
+    }
+  return 0;
+}
@@ -242,6 +242,15 @@ static ns3::GlobalValue g_outputDir ("outputDir",
                                      ns3::StringValue ("./"),
                                      ns3::MakeStringChecker ());
 
+// Scaling the topology is meant for measuring scenario setup time, e.g.
+// ./waf --run "laa-wifi-indoor --nodeScale=10 --reportSetupTime=1"
+// builds 10 times as many cells and UEs as the TR36.889 layout.  The
+// extra cells continue the grid, outside of the building.
+static ns3::GlobalValue g_nodeScale ("nodeScale",
+                                     "Multiply the number of cells per operator, and so of UEs, by this factor",
+                                     ns3::UintegerValue (1),
+                                     ns3::MakeUintegerChecker<uint32_t> (1));
+
 static ns3::GlobalValue g_cwUpdateRule ("cwUpdateRule",
                                          "Rule that will be used to update contention window of LAA node",
                                          ns3::EnumValue (LbtAccessManager::NACKS_80_PERCENT),
@@ -275,6 +284,9 @@ main (int argc, char *argv[])
   DoubleValue doubleValue;
   BooleanValue booleanValue;
   StringValue stringValue;
+  UintegerValue uintegerValue;
+  GlobalValue::GetValueByName ("nodeScale", uintegerValue);
+  numCells *= uintegerValue.Get ();
   GlobalValue::GetValueByName ("ChannelAccessManager", enumValue);
   enum Config_ChannelAccessManager channelAccessManager = (Config_ChannelAccessManager) enumValue.Get ();
   GlobalValue::GetValueByName ("cellConfigA", enumValue);
@@ -230,6 +230,12 @@ static ns3::GlobalValue g_dropPackets ("dropPackets",
                                          ns3::BooleanValue (false),
                                          ns3::MakeBooleanChecker ());
 
+static ns3::GlobalValue g_txopAwareScheduling ("txopAwareScheduling",
+                                         "applicable to impl2; if true, the scheduler only fills the subframes that are free, "
+                                         "the subframes scheduled without channel access are transmitted at the start of the next TXOP",
+                                         ns3::BooleanValue (false),
+                                         ns3::MakeBooleanChecker ());
+
 static ns3::GlobalValue g_lteChannelAccessImpl ("lteChannelAccessImpl",
                                          "if true, (impl1) it will be used lte channel access implemenation that stops scheduler when no channel access, thus has 2ms delay"
                                          "if false, (impl2) it will be used lte channel acces implementation that does not stop scheduler, always schedules, transmits only when "
@@ -248,6 +254,11 @@ static ns3::GlobalValue g_rlcReportBufferStatusTimer ("rlcAmRbsTimer",
                                                       ns3::UintegerValue (20),
                                                       ns3::MakeUintegerChecker<uint32_t> ());
 
+static ns3::GlobalValue g_reportSetupTime ("reportSetupTime",
+                                           "Print the wall clock time spent configuring the scenario before running it",
+                                           ns3::BooleanValue (false),
+                                           ns3::MakeBooleanChecker ());
+
 // Parse context strings of the form "/NodeList/3/DeviceList/1/Mac/Assoc"
 // to extract the NodeId
 uint32_t
@@ -787,104 +798,133 @@ HarqFeedbackDisconnect (Ptr<NetDevice> lteEnbNetDevice)
   NS_ASSERT (success);
 }
 
+// The log connect/disconnect functions below toggle the same wildcard
+// paths during the run; compile them once rather than resolving the
+// whole NodeList on every toggle.
+static Config::CompiledPath g_apBackoffPath ("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/Mac/$ns3::ApWifiMac/BE_EdcaTxopN/$ns3::EdcaTxopN/BackoffTrace");
+static Config::CompiledPath g_staBackoffPath ("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/Mac/$ns3::StaWifiMac/BE_EdcaTxopN/$ns3::EdcaTxopN/BackoffTrace");
+static Config::CompiledPath g_apCwPath ("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/Mac/$ns3::ApWifiMac/BE_EdcaTxopN/$ns3::EdcaTxopN/CwTrace");
+static Config::CompiledPath g_staCwPath ("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/Mac/$ns3::StaWifiMac/BE_EdcaTxopN/$ns3::EdcaTxopN/CwTrace");
+static Config::CompiledPath g_wifiFailRetriesPath ("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/RemoteStationManager/MacTxFinalDataFailed");
+static Config::CompiledPath g_wifiRetriesPath ("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/RemoteStationManager/MacTxDataFailed");
+static Config::CompiledPath g_wifiPhyPath ("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/Phy/$ns3::SpectrumWifiPhy/SignalArrival");
+static Config::CompiledPath g_txopPath ("/NodeList/*/DeviceList/*/$ns3::LteNetDevice/$ns3::LteEnbNetDevice/LteEnbPhy/Txop");
+static Config::CompiledPath g_dataTxPath ("/NodeList/*/DeviceList/*/LteEnbPhy/DataSent");
+static Config::CompiledPath g_beaconPath ("/NodeList/*/DeviceList/*/Mac/$ns3::StaWifiMac/BeaconArrival");
+
+void
+ResetCompiledLogPaths (void)
+{
+  g_apBackoffPath.Reset ();
+  g_staBackoffPath.Reset ();
+  g_apCwPath.Reset ();
+  g_staCwPath.Reset ();
+  g_wifiFailRetriesPath.Reset ();
+  g_wifiRetriesPath.Reset ();
+  g_wifiPhyPath.Reset ();
+  g_txopPath.Reset ();
+  g_dataTxPath.Reset ();
+  g_beaconPath.Reset ();
+}
+
 void
 ScheduleWifiBackoffLogConnect (void)
 {
-  Config::Connect ("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/Mac/$ns3::ApWifiMac/BE_EdcaTxopN/$ns3::EdcaTxopN/BackoffTrace", MakeCallback (&BackoffChangeCb));
-  Config::Connect ("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/Mac/$ns3::StaWifiMac/BE_EdcaTxopN/$ns3::EdcaTxopN/BackoffTrace", MakeCallback (&BackoffChangeCb));
+  g_apBackoffPath.Connect (MakeCallback (&BackoffChangeCb));
+  g_staBackoffPath.Connect (MakeCallback (&BackoffChangeCb));
 }
 
 void
 ScheduleWifiBackoffLogDisconnect (void)
 {
-  Config::Disconnect ("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/Mac/$ns3::ApWifiMac/BE_EdcaTxopN/$ns3::EdcaTxopN/BackoffTrace", MakeCallback (&BackoffChangeCb));
-  Config::Disconnect ("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/Mac/$ns3::StaWifiMac/BE_EdcaTxopN/$ns3::EdcaTxopN/BackoffTrace", MakeCallback (&BackoffChangeCb));
+  g_apBackoffPath.Disconnect (MakeCallback (&BackoffChangeCb));
+  g_staBackoffPath.Disconnect (MakeCallback (&BackoffChangeCb));
 }
 
 void
 ScheduleCwChangesLogConnect (void)
 {
-  Config::Connect ("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/Mac/$ns3::ApWifiMac/BE_EdcaTxopN/$ns3::EdcaTxopN/CwTrace", MakeCallback (&CwChangeCb));
-  Config::Connect ("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/Mac/$ns3::StaWifiMac/BE_EdcaTxopN/$ns3::EdcaTxopN/CwTrace", MakeCallback (&CwChangeCb));
+  g_apCwPath.Connect (MakeCallback (&CwChangeCb));
+  g_staCwPath.Connect (MakeCallback (&CwChangeCb));
 }
 
 void
 ScheduleCwChangesLogDisconnect (void)
 {
-  Config::Disconnect ("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/Mac/$ns3::ApWifiMac/BE_EdcaTxopN/$ns3::EdcaTxopN/CwTrace", MakeCallback (&CwChangeCb));
-  Config::Disconnect ("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/Mac/$ns3::StaWifiMac/BE_EdcaTxopN/$ns3::EdcaTxopN/CwTrace", MakeCallback (&CwChangeCb));
+  g_apCwPath.Disconnect (MakeCallback (&CwChangeCb));
+  g_staCwPath.Disconnect (MakeCallback (&CwChangeCb));
 }
 
 void
 ScheduleWifiFailRetriesLogConnect (void)
 {
-  Config::Connect ("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/RemoteStationManager/MacTxFinalDataFailed", MakeCallback (&WifiFailRetriesCb));
+  g_wifiFailRetriesPath.Connect (MakeCallback (&WifiFailRetriesCb));
 }
 
 void
 ScheduleWifiFailRetriesLogDisconnect (void)
 {
-  Config::Disconnect ("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/RemoteStationManager/MacTxFinalDataFailed", MakeCallback (&WifiFailRetriesCb));
+  g_wifiFailRetriesPath.Disconnect (MakeCallback (&WifiFailRetriesCb));
 }
 
 void
 ScheduleWifiRetriesLogConnect (void)
 {
-  Config::Connect ("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/RemoteStationManager/MacTxDataFailed", MakeCallback (&WifiRetriesCb));
+  g_wifiRetriesPath.Connect (MakeCallback (&WifiRetriesCb));
 }
 
 void
 ScheduleWifiRetriesLogDisconnect (void)
 {
-  Config::Disconnect ("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/RemoteStationManager/MacTxDataFailed", MakeCallback (&WifiRetriesCb));
+  g_wifiRetriesPath.Disconnect (MakeCallback (&WifiRetriesCb));
 }
 
 void
 SchedulePhyLogConnect (void)
 {
-  Config::Connect ("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/Phy/$ns3::SpectrumWifiPhy/SignalArrival", MakeCallback (&SignalCb));
+  g_wifiPhyPath.Connect (MakeCallback (&SignalCb));
 }
 
 void
 SchedulePhyLogDisconnect (void)
 {
-  Config::Disconnect ("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/Phy/$ns3::SpectrumWifiPhy/SignalArrival", MakeCallback (&SignalCb));
+  g_wifiPhyPath.Disconnect (MakeCallback (&SignalCb));
 }
 
 void
 ScheduleTxopLogConnect (void)
 {
-  Config::Connect ("/NodeList/*/DeviceList/*/$ns3::LteNetDevice/$ns3::LteEnbNetDevice/LteEnbPhy/Txop", MakeCallback (&TxopReceived));
+  g_txopPath.Connect (MakeCallback (&TxopReceived));
 }
 
 void
 ScheduleTxopLogDisconnect (void)
 {
-  Config::Disconnect ("/NodeList/*/DeviceList/*/$ns3::LteNetDevice/$ns3::LteEnbNetDevice/LteEnbPhy/Txop", MakeCallback (&TxopReceived));
+  g_txopPath.Disconnect (MakeCallback (&TxopReceived));
 }
 
 void
 ScheduleDataTxConnect (void)
 {
-  Config::Connect ("/NodeList/*/DeviceList/*/LteEnbPhy/DataSent", MakeCallback (&LteDataTxCallback));
+  g_dataTxPath.Connect (MakeCallback (&LteDataTxCallback));
 }
 
 void
 ScheduleDataTxDisconnect (void)
 {
-  Config::Disconnect ("/NodeList/*/DeviceList/*/LteEnbPhy/DataSent", MakeCallback (&LteDataTxCallback));
+  g_dataTxPath.Disconnect (MakeCallback (&LteDataTxCallback));
 }
 
 void
 ScheduleBeaconLogConnect (void)
 {
-  Config::Connect ("/NodeList/*/DeviceList/*/Mac/$ns3::StaWifiMac/BeaconArrival", MakeCallback (&BeaconArrivalCb));
+  g_beaconPath.Connect (MakeCallback (&BeaconArrivalCb));
 }
 
 void
 ScheduleBeaconLogDisconnect (void)
 {
-  Config::Disconnect ("/NodeList/*/DeviceList/*/Mac/$ns3::StaWifiMac/BeaconArrival", MakeCallback (&BeaconArrivalCb));
+  g_beaconPath.Disconnect (MakeCallback (&BeaconArrivalCb));
 }
 
 void
@@ -2225,6 +2265,9 @@ ConfigureAndRunScenario (Config_e cellConfigA,
                          std::string outFileName,
                          std::string simulationParams)
 {
+  SystemWallClockMs setupClock;
+  setupClock.Start ();
+
   DoubleValue doubleValue;
   BooleanValue booleanValue;
   StringValue stringValue;
@@ -2271,6 +2314,8 @@ ConfigureAndRunScenario (Config_e cellConfigA,
   // in situation when packets are ready, but no channel access, whether to drop packets, used only with impl2 (lteChannelAccessImpl = false)
   GlobalValue::GetValueByName ("dropPackets", booleanValue);
   Config::SetDefault ("ns3::LteEnbPhy::DropPackets", booleanValue);
+  GlobalValue::GetValueByName ("txopAwareScheduling", booleanValue);
+  Config::SetDefault ("ns3::LteEnbPhy::TxopAwareScheduling", booleanValue);
 
 
   GlobalValue::GetValueByName("rlcAmRbsTimer", uValue);
@@ -2991,6 +3036,13 @@ ConfigureAndRunScenario (Config_e cellConfigA,
       Simulator::Schedule (clientStopTime, &ScheduleCwChangesLogDisconnect);
     }
 
+  GlobalValue::GetValueByName ("reportSetupTime", booleanValue);
+  if (booleanValue.Get () == true)
+    {
+      std::cout << "Scenario setup of " << NodeList::GetNNodes () << " nodes took "
+                << setupClock.End () << " ms" << std::endl;
+    }
+
   //
   // Running the simulation
   //
@@ -3088,6 +3140,8 @@ ConfigureAndRunScenario (Config_e cellConfigA,
       SaveVoiceSummaryStats (outFileName + "_operatorB_voice_summary_log", endpointNodesB);
       SaveVoiceStats (outFileName + "_operatorB_voice_log", endpointNodesB, g_voiceRxLog);
     }
+  // Release the devices referenced by the cached log paths
+  ResetCompiledLogPaths ();
   Simulator::Destroy ();
 
 }
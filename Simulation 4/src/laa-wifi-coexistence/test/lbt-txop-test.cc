@@ -110,13 +110,18 @@ class LbtTxopTestCase : public TestCase
 		  double d1,
 		  double d2,
 		  Time udpInterval,
-		  Transport_e traffic);
+		  Transport_e traffic,
+		  bool txopAwareScheduling);
   virtual ~LbtTxopTestCase ();
 
   void CheckState (LbtAccessManager::LbtState state, bool duringReservationSignal);
   void DataTracedCallback (uint32_t bytes);
   void ReservationSignalCheck (Time startTime, Time duration);
   void TxopCheck (Time startTime, Time duration, Time nextSubframeStarts);
+  void DlSchedulingCheck (uint32_t frame, uint32_t subframe, uint16_t rnti,
+                          uint8_t mcs0, uint16_t tbs0Size, uint8_t mcs1, uint16_t tbs1Size);
+  void UlSchedulingCheck (uint32_t frame, uint32_t subframe, uint16_t rnti,
+                          uint8_t mcs, uint16_t tbsSize);
 
 private:
 
@@ -132,9 +137,26 @@ private:
   Time m_ttiDuration;
   uint32_t m_bytesTransmitedCounter;
   Transport_e m_transport;
+  bool m_txopAwareScheduling;
   Ptr<LteEnbPhy> m_ltePhy;
+  Time m_txopStart;           ///< start of the last TXOP
+  Time m_txopEnd;             ///< end of the last TXOP, as granted
+  uint32_t m_dataSubframes;   ///< data subframes checked against the grant
+  Time m_lastDlScheduling;    ///< last DL allocation of the MAC
+  Time m_maxDlSchedulingGap;  ///< longest time without DL allocations
+  Time m_lastUlScheduling;    ///< last UL allocation of the MAC
+  Time m_maxUlSchedulingGap;  ///< longest time without UL allocations
 };
 
+/// Delay of the data from the start of the subframe, 3 OFDM symbols of control
+static const Time DL_CTRL_DELAY = NanoSeconds (214286);
+/// Start of the UL traffic of the TXOP aware case
+static const Time UL_START_TIME = Seconds (0.5);
+/// Interval of the UL packets of the TXOP aware case
+static const Time UL_INTERVAL = MilliSeconds (2);
+/// Longest time the MAC may go without scheduling while there is traffic
+static const Time MAX_SCHEDULING_GAP = MilliSeconds (20);
+
 
 void
 LteTestReservationSignalCallback (LbtTxopTestCase *testcase, std::string path, Time startTime, Time duration)
@@ -164,19 +186,22 @@ LteTestTxOpCallback (LbtTxopTestCase *testcase, std::string path, Time startTime
 LbtTxopTestSuite::LbtTxopTestSuite ()
   : TestSuite ("lbt-txop-test", SYSTEM)
 {
-  AddTestCase (new LbtTxopTestCase ("txop=4,  d1=50, d2=50", true, 4.0, 10.0, 50.0, MicroSeconds(106), UDP ), TestCase::QUICK);
-  AddTestCase (new LbtTxopTestCase ("txop=5,  d1=50, d2=50", true, 5.0, 10.0, 50.0, MicroSeconds(106), UDP), TestCase::EXTENSIVE);
-  AddTestCase (new LbtTxopTestCase ("txop=10, d1=50, d2=50", true, 10.0, 10.0, 50.0, MicroSeconds(106), UDP), TestCase::EXTENSIVE);
-  AddTestCase (new LbtTxopTestCase ("txop=13, d1=50, d2=50", true, 13.0, 10.0, 50.0, MicroSeconds(106), UDP), TestCase::EXTENSIVE);
-  AddTestCase (new LbtTxopTestCase ("txop=20, d1=50, d2=50", true, 20.0, 10.0, 50.0, MicroSeconds(106), UDP), TestCase::EXTENSIVE);
-  //AddTestCase (new LbtTxopTestCase ("txop=20, d1=50, d2=50", true, 20.0, 10.0, 50.0, MilliSeconds(10), UDP), TestCase::EXTENSIVE);
+  AddTestCase (new LbtTxopTestCase ("txop=4,  d1=50, d2=50", true, 4.0, 10.0, 50.0, MicroSeconds(106), UDP, false), TestCase::QUICK);
+  AddTestCase (new LbtTxopTestCase ("txop=5,  d1=50, d2=50", true, 5.0, 10.0, 50.0, MicroSeconds(106), UDP, false), TestCase::EXTENSIVE);
+  AddTestCase (new LbtTxopTestCase ("txop=10, d1=50, d2=50", true, 10.0, 10.0, 50.0, MicroSeconds(106), UDP, false), TestCase::EXTENSIVE);
+  AddTestCase (new LbtTxopTestCase ("txop=13, d1=50, d2=50", true, 13.0, 10.0, 50.0, MicroSeconds(106), UDP, false), TestCase::EXTENSIVE);
+  AddTestCase (new LbtTxopTestCase ("txop=20, d1=50, d2=50", true, 20.0, 10.0, 50.0, MicroSeconds(106), UDP, false), TestCase::EXTENSIVE);
+  //AddTestCase (new LbtTxopTestCase ("txop=20, d1=50, d2=50", true, 20.0, 10.0, 50.0, MilliSeconds(10), UDP, false), TestCase::EXTENSIVE);
 
   // when testing TCP increase m_startTime and m_StopTime
-  AddTestCase (new LbtTxopTestCase ("txop=4,  d1=50, d2=50", true, 4.0, 10.0, 50.0, MicroSeconds(106), TCP), TestCase::QUICK);
-  AddTestCase (new LbtTxopTestCase ("txop=5,  d1=50, d2=50", true, 5.0, 10.0, 50.0, MicroSeconds(106), TCP), TestCase::EXTENSIVE);
-  AddTestCase (new LbtTxopTestCase ("txop=10, d1=50, d2=50", true, 10.0, 10.0, 50.0, MicroSeconds(106), TCP), TestCase::EXTENSIVE);
-  AddTestCase (new LbtTxopTestCase ("txop=13, d1=50, d2=50", true, 13.0, 10.0, 50.0, MicroSeconds(106), TCP), TestCase::EXTENSIVE);
-  AddTestCase (new LbtTxopTestCase ("txop=20, d1=50, d2=50", true, 20.0, 10.0, 50.0, MicroSeconds(106), TCP), TestCase::EXTENSIVE);
+  AddTestCase (new LbtTxopTestCase ("txop=4,  d1=50, d2=50", true, 4.0, 10.0, 50.0, MicroSeconds(106), TCP, false), TestCase::QUICK);
+  AddTestCase (new LbtTxopTestCase ("txop=5,  d1=50, d2=50", true, 5.0, 10.0, 50.0, MicroSeconds(106), TCP, false), TestCase::EXTENSIVE);
+  AddTestCase (new LbtTxopTestCase ("txop=10, d1=50, d2=50", true, 10.0, 10.0, 50.0, MicroSeconds(106), TCP, false), TestCase::EXTENSIVE);
+  AddTestCase (new LbtTxopTestCase ("txop=13, d1=50, d2=50", true, 13.0, 10.0, 50.0, MicroSeconds(106), TCP, false), TestCase::EXTENSIVE);
+  AddTestCase (new LbtTxopTestCase ("txop=20, d1=50, d2=50", true, 20.0, 10.0, 50.0, MicroSeconds(106), TCP, false), TestCase::EXTENSIVE);
+
+  // the scheduler only fills the subframes that are transmitted in a TXOP
+  AddTestCase (new LbtTxopTestCase ("txop=4,  d1=50, d2=50, txop aware", true, 4.0, 10.0, 50.0, MicroSeconds(106), UDP, true), TestCase::QUICK);
 
 }
 
@@ -186,14 +211,15 @@ static LbtTxopTestSuite lbtTxopTestSuite;
 /**
  * TestCase
  */
-LbtTxopTestCase::LbtTxopTestCase (std::string name, bool useReservationSignal, double txop, double d1, double d2, Time udpInterval, Transport_e transport)
-  :TestCase (name), m_useReservationSignal (useReservationSignal), m_txop (txop), m_d1 (d1), m_d2 (d2), m_udpInterval (udpInterval), m_transport(transport)
+LbtTxopTestCase::LbtTxopTestCase (std::string name, bool useReservationSignal, double txop, double d1, double d2, Time udpInterval, Transport_e transport, bool txopAwareScheduling)
+  :TestCase (name), m_useReservationSignal (useReservationSignal), m_txop (txop), m_d1 (d1), m_d2 (d2), m_udpInterval (udpInterval), m_transport(transport), m_txopAwareScheduling (txopAwareScheduling)
 {
   m_startTime = Seconds(0.3);
   m_stopTime = Seconds(2);
   m_ttiDuration = MilliSeconds(1);
   m_txopCounter = 0;
   m_bytesTransmitedCounter = 0;
+  m_dataSubframes = 0;
 }
 
 LbtTxopTestCase::~LbtTxopTestCase (){}
@@ -237,7 +263,10 @@ LbtTxopTestCase::DoRun (void)
   Config::SetDefault ("ns3::Ieee80211axIndoorPropagationLossModel::Sigma", DoubleValue (0));
   Config::SetDefault ("ns3::LteEnbPhy::TxPower", DoubleValue (phyParams.m_bsTxPower));
   Config::SetDefault ("ns3::LteUePhy::TxPower", DoubleValue (phyParams.m_ueTxPower));
-  Config::SetDefault ("ns3::LteEnbPhy::ImplWith2msDelay", BooleanValue(true));
+  Config::SetDefault ("ns3::LteEnbPhy::ImplWith2msDelay", BooleanValue(!m_txopAwareScheduling));
+  Config::SetDefault ("ns3::LteEnbPhy::TxopAwareScheduling", BooleanValue(m_txopAwareScheduling));
+  // the TXOP aware scheduler is checked with the channel access manager in use from its installation
+  Config::SetDefault ("ns3::LteEnbPhy::ChannelAccessManagerStartTime", TimeValue (m_txopAwareScheduling ? MilliSeconds (300) : Seconds (2)));
 
   if (UDP)
     {
@@ -377,6 +406,25 @@ LbtTxopTestCase::DoRun (void)
       Simulator::Schedule (m_startTime + Seconds (firstArrival), &StartFileTransfer, ftpArrivals, tcpClientApps, nextClient, m_stopTime);
     }
 
+  Ptr<UdpServer> ulServer;
+  if (m_txopAwareScheduling)
+    {
+      // UL traffic, whose grants go out only with the DL control of the
+      // subframes that the PHY holds while it waits for channel access
+      UdpServerHelper ulServerHelper (9);
+      ApplicationContainer ulServerApps = ulServerHelper.Install (clientNode);
+      ulServerApps.Start (m_startTime);
+      ulServerApps.Stop (m_stopTime);
+      ulServer = DynamicCast<UdpServer> (ulServerApps.Get (0));
+      UdpClientHelper ulClientHelper (internetIpIfaces.GetAddress (1), 9);
+      ulClientHelper.SetAttribute ("MaxPackets", UintegerValue (1e6));
+      ulClientHelper.SetAttribute ("Interval", TimeValue (UL_INTERVAL));
+      ulClientHelper.SetAttribute ("PacketSize", UintegerValue (1000));
+      ApplicationContainer ulClientApps = ulClientHelper.Install (ueNode);
+      ulClientApps.Start (UL_START_TIME);
+      ulClientApps.Stop (m_stopTime);
+    }
+
   FlowMonitorHelper flowmonHelper;
   NodeContainer endPointNodes;
   endPointNodes.Add (clientNode);
@@ -391,10 +439,32 @@ LbtTxopTestCase::DoRun (void)
   Config::Connect ("/NodeList/0/DeviceList/0/LteEnbPhy/DataSent",
                      MakeBoundCallback (&LteDataTracedCallback, this));
   Config::Connect ("/NodeList/0/DeviceList/0/LteEnbPhy/Txop",
-                     MakeBoundCallback (&LteTestTxOpCallback, this));
+                   MakeBoundCallback (&LteTestTxOpCallback, this));
+  if (m_txopAwareScheduling)
+    {
+      Ptr<LteEnbMac> mac = lteEnbNetDevice->GetMac ();
+      mac->TraceConnectWithoutContext ("DlScheduling", MakeCallback (&LbtTxopTestCase::DlSchedulingCheck, this));
+      mac->TraceConnectWithoutContext ("UlScheduling", MakeCallback (&LbtTxopTestCase::UlSchedulingCheck, this));
+    }
 
   Simulator::Stop (m_stopTime);
   Simulator::Run ();
+
+  if (m_txopAwareScheduling)
+    {
+      NS_TEST_ASSERT_MSG_GT (m_bytesTransmitedCounter, 0, "No data transmitted");
+      NS_TEST_ASSERT_MSG_GT (m_dataSubframes, 0, "No data subframe checked against the grant");
+      // the MAC keeps scheduling both directions while the PHY withholds
+      // the subframe indications of the subframes it holds, so the DL
+      // HARQ processes are freed by the feedback and the UL grants go out
+      m_maxDlSchedulingGap = std::max (m_maxDlSchedulingGap, m_stopTime - m_lastDlScheduling);
+      m_maxUlSchedulingGap = std::max (m_maxUlSchedulingGap, m_stopTime - m_lastUlScheduling);
+      NS_TEST_ASSERT_MSG_LT_OR_EQ (m_maxDlSchedulingGap, MAX_SCHEDULING_GAP, "DL scheduling stalled");
+      NS_TEST_ASSERT_MSG_LT_OR_EQ (m_maxUlSchedulingGap, MAX_SCHEDULING_GAP, "UL scheduling stalled");
+      // the UL packets missing are the ones still in flight
+      uint32_t ulSent = (m_stopTime - UL_START_TIME).GetInteger () / UL_INTERVAL.GetInteger ();
+      NS_TEST_ASSERT_MSG_LT_OR_EQ (ulSent, ulServer->GetReceived () + 10, "UL packets lost");
+    }
   Simulator::Destroy ();
 }
 
@@ -413,6 +483,18 @@ LbtTxopTestCase::DataTracedCallback (uint32_t bytes)
 {
   NS_LOG_INFO(this<<"DATA at:"<<Simulator::Now().GetMicroSeconds()<<", size:"<<bytes<<" bytes.");
   m_bytesTransmitedCounter+=bytes;
+  if (m_txopAwareScheduling && Simulator::Now () > m_startTime)
+    {
+      // the whole subframe lies in the last TXOP, and the PHY has not
+      // released the grant before its end
+      Time subframeStart = Simulator::Now () - DL_CTRL_DELAY;
+      Time subframeEnd = subframeStart + m_ttiDuration;
+      NS_TEST_ASSERT_MSG_GT (m_txopCounter, 0, "Data sent without a TXOP at " << subframeStart.GetMicroSeconds ());
+      NS_TEST_ASSERT_MSG_LT_OR_EQ (m_txopStart, subframeStart, "Data subframe starts before the TXOP");
+      NS_TEST_ASSERT_MSG_LT_OR_EQ (subframeEnd, m_txopEnd, "Data subframe ends after the TXOP");
+      NS_TEST_ASSERT_MSG_LT_OR_EQ (subframeEnd, m_ltePhy->GetGrantTimeout (), "Data subframe ends after the grant timeout");
+      m_dataSubframes++;
+    }
   Simulator::Schedule (NanoSeconds(1), &LbtTxopTestCase::CheckState, this, LbtAccessManager::BUSY, true);
 }
 
@@ -428,9 +510,36 @@ LbtTxopTestCase::TxopCheck (Time startTime, Time duration, Time firstSubframeSta
 {
   NS_LOG_INFO(this<<"Txop "<<m_txopCounter<<" at:"<<Simulator::Now().GetMicroSeconds()<<" with duration of "<<duration.GetMilliSeconds()<<". Next subrame starts at:"<<firstSubframeStarts.GetMicroSeconds());
   m_txopCounter++;
-  // check if reservation signal started immediately after txop
-  if (m_ltePhy->GetGrantTimeout() > Simulator::Now() + NanoSeconds(1))
+  m_txopStart = startTime;
+  m_txopEnd = startTime + duration;
+  // check if reservation signal started immediately after txop; without the
+  // 2 ms delay, a subframe with only control messages releases the grant
+  // after the control region instead of reserving the channel
+  if (!m_txopAwareScheduling && m_ltePhy->GetGrantTimeout() > Simulator::Now() + NanoSeconds(1))
     {
       Simulator::Schedule ((firstSubframeStarts-startTime)/2, &LbtTxopTestCase::CheckState, this, LbtAccessManager::BUSY, false);
     }
 }
+
+void
+LbtTxopTestCase::DlSchedulingCheck (uint32_t frame, uint32_t subframe, uint16_t rnti,
+                                    uint8_t mcs0, uint16_t tbs0Size, uint8_t mcs1, uint16_t tbs1Size)
+{
+  // all the DL clients have started after m_startTime + 1 s
+  if (m_lastDlScheduling >= m_startTime + Seconds (1))
+    {
+      m_maxDlSchedulingGap = std::max (m_maxDlSchedulingGap, Simulator::Now () - m_lastDlScheduling);
+    }
+  m_lastDlScheduling = Simulator::Now ();
+}
+
+void
+LbtTxopTestCase::UlSchedulingCheck (uint32_t frame, uint32_t subframe, uint16_t rnti,
+                                    uint8_t mcs, uint16_t tbsSize)
+{
+  if (m_lastUlScheduling >= UL_START_TIME + MilliSeconds (100))
+    {
+      m_maxUlSchedulingGap = std::max (m_maxUlSchedulingGap, Simulator::Now () - m_lastUlScheduling);
+    }
+  m_lastUlScheduling = Simulator::Now ();
+}
@@ -0,0 +1,63 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Convert a text fading trace, as written by fading_trace_generator.m,
+// to the binary format which TraceFadingLossModel memory maps.  The
+// binary trace records its own size, so that the RbNum and SamplesNum
+// attributes of the model need not be set to load it.
+//
+//   ./waf --run "lena-fading-trace-converter --input=fading_trace_EPA_3kmph.fad
+//                --output=fading_trace_EPA_3kmph.fadb --rbNum=100 --samplesNum=10000"
+
+#include "ns3/core-module.h"
+#include "ns3/lte-module.h"
+#include <iostream>
+#include <string>
+
+using namespace ns3;
+
+int main (int argc, char *argv[])
+{
+  std::string input;
+  std::string output;
+  uint32_t rbNum = 100;
+  uint32_t samplesNum = 10000;
+
+  CommandLine cmd;
+  cmd.AddValue ("input", "text trace to convert", input);
+  cmd.AddValue ("output", "binary trace to write", output);
+  cmd.AddValue ("rbNum", "number of RBs of the trace", rbNum);
+  cmd.AddValue ("samplesNum", "number of samples per RB of the trace", samplesNum);
+  cmd.Parse (argc, argv);
+
+  if (input.empty () || output.empty ())
+    {
+      std::cerr << "both --input and --output must be given" << std::endl;
+      return 1;
+    }
+  if (rbNum == 0 || rbNum > 255 || samplesNum == 0)
+    {
+      std::cerr << "invalid trace size " << rbNum << " x " << samplesNum << std::endl;
+      return 1;
+    }
+  if (!TraceFadingLossModel::ConvertTrace (input, output, rbNum, samplesNum))
+    {
+      std::cerr << "could not convert " << input << " to " << output << std::endl;
+      return 1;
+    }
+  std::cout << "wrote " << rbNum << " x " << samplesNum << " samples to " << output << std::endl;
+  return 0;
+}
@@ -0,0 +1,284 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Cost of an FF MAC scheduler alone: the scheduler is driven TTI by TTI
+// through its SAPs, as by the eNB MAC, with a fixed trace of DL CQIs,
+// SRS reports, RLC buffer reports and BSRs of --ues UEs, and the DL
+// HARQ processes are acknowledged.  The trace is generated before the
+// clock is started.
+//
+//   ./waf --run "lena-ff-mac-scheduler-benchmark --ues=10"
+//   ./waf --run "lena-ff-mac-scheduler-benchmark --ues=400 --scheduler=ns3::PssFfMacScheduler"
+
+#include "ns3/core-module.h"
+#include "ns3/lte-module.h"
+#include "ns3/lte-vendor-specific-parameters.h"
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * The eNB MAC side of the SAPs of the scheduler, which counts the
+ * allocations and keeps the DL ones to acknowledge them
+ */
+class BenchSchedSapUser : public FfMacSchedSapUser,
+                          public FfMacCschedSapUser
+{
+public:
+  BenchSchedSapUser ()
+    : m_dlAllocations (0),
+      m_ulAllocations (0)
+  {
+  }
+
+  virtual void SchedDlConfigInd (const struct SchedDlConfigIndParameters& params)
+  {
+    m_dlAllocations += params.m_buildDataList.size ();
+    for (uint32_t i = 0; i < params.m_buildDataList.size (); i++)
+      {
+        const DlDciListElement_s &dci = params.m_buildDataList.at (i).m_dci;
+        DlInfoListElement_s info;
+        info.m_rnti = dci.m_rnti;
+        info.m_harqProcessId = dci.m_harqProcess;
+        info.m_harqStatus.resize (dci.m_tbsSize.size (), DlInfoListElement_s::ACK);
+        m_dlInfo.push_back (info);
+      }
+  }
+  virtual void SchedUlConfigInd (const struct SchedUlConfigIndParameters& params)
+  {
+    m_ulAllocations += params.m_dciList.size ();
+  }
+  virtual void CschedCellConfigCnf (const struct CschedCellConfigCnfParameters& params)
+  {
+  }
+  virtual void CschedUeConfigCnf (const struct CschedUeConfigCnfParameters& params)
+  {
+  }
+  virtual void CschedLcConfigCnf (const struct CschedLcConfigCnfParameters& params)
+  {
+  }
+  virtual void CschedLcReleaseCnf (const struct CschedLcReleaseCnfParameters& params)
+  {
+  }
+  virtual void CschedUeReleaseCnf (const struct CschedUeReleaseCnfParameters& params)
+  {
+  }
+  virtual void CschedUeConfigUpdateInd (const struct CschedUeConfigUpdateIndParameters& params)
+  {
+  }
+  virtual void CschedCellConfigUpdateInd (const struct CschedCellConfigUpdateIndParameters& params)
+  {
+  }
+
+  uint64_t m_dlAllocations;                 ///< number of DL allocations
+  uint64_t m_ulAllocations;                 ///< number of UL allocations
+  std::vector<DlInfoListElement_s> m_dlInfo; ///< feedback of the DL allocations of the last TTI
+};
+
+/// The reports of a TTI
+struct TtiTrace
+{
+  FfMacSchedSapProvider::SchedDlCqiInfoReqParameters dlCqi;                 ///< the DL CQIs
+  std::vector<FfMacSchedSapProvider::SchedUlCqiInfoReqParameters> ulCqi;   ///< the SRS reports
+  std::vector<FfMacSchedSapProvider::SchedDlRlcBufferReqParameters> rlc;   ///< the RLC buffer reports
+  FfMacSchedSapProvider::SchedUlMacCtrlInfoReqParameters bsr;              ///< the BSRs
+};
+
+static std::vector<TtiTrace>
+MakeTrace (uint32_t nUes, uint32_t nTtis, uint8_t bandwidth)
+{
+  Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable> ();
+  rng->SetStream (1);
+  std::vector<TtiTrace> trace (nTtis);
+  for (uint32_t t = 0; t < nTtis; t++)
+    {
+      for (uint16_t rnti = 1; rnti <= nUes; rnti++)
+        {
+          // each UE reports its CQI every 5 TTIs, its SRS every 20, and
+          // its buffers every 10, at an offset given by its RNTI
+          if ((t + rnti) % 5 == 0)
+            {
+              CqiListElement_s cqi;
+              cqi.m_rnti = rnti;
+              cqi.m_ri = 1;
+              cqi.m_cqiType = CqiListElement_s::P10;
+              cqi.m_wbCqi.push_back (rng->GetInteger (1, 15));
+              cqi.m_wbPmi = 0;
+              trace[t].dlCqi.m_cqiList.push_back (cqi);
+            }
+          if ((t + rnti) % 20 == 0)
+            {
+              FfMacSchedSapProvider::SchedUlCqiInfoReqParameters srs;
+              srs.m_ulCqi.m_type = UlCqi_s::SRS;
+              double sinr = rng->GetValue (-5.0, 25.0);
+              for (uint32_t i = 0; i < bandwidth; i++)
+                {
+                  srs.m_ulCqi.m_sinr.push_back (LteFfConverter::double2fpS11dot3 (sinr + rng->GetValue (-2.0, 2.0)));
+                }
+              VendorSpecificListElement_s vsp;
+              vsp.m_type = SRS_CQI_RNTI_VSP;
+              vsp.m_length = sizeof (SrsCqiRntiVsp);
+              vsp.m_value = Create<SrsCqiRntiVsp> (rnti);
+              srs.m_vendorSpecificList.push_back (vsp);
+              trace[t].ulCqi.push_back (srs);
+            }
+          if ((t + rnti) % 10 == 0)
+            {
+              FfMacSchedSapProvider::SchedDlRlcBufferReqParameters rlc;
+              rlc.m_rnti = rnti;
+              rlc.m_logicalChannelIdentity = 3;
+              rlc.m_rlcTransmissionQueueSize = rng->GetInteger (0, 20000);
+              rlc.m_rlcTransmissionQueueHolDelay = rng->GetInteger (0, 100);
+              rlc.m_rlcRetransmissionQueueSize = 0;
+              rlc.m_rlcRetransmissionHolDelay = 0;
+              rlc.m_rlcStatusPduSize = 0;
+              trace[t].rlc.push_back (rlc);
+
+              MacCeListElement_s bsr;
+              bsr.m_rnti = rnti;
+              bsr.m_macCeType = MacCeListElement_s::BSR;
+              bsr.m_macCeValue.m_phr = 0;
+              bsr.m_macCeValue.m_crnti = 0;
+              bsr.m_macCeValue.m_bufferStatus.resize (4, 0);
+              bsr.m_macCeValue.m_bufferStatus.at (0) = rng->GetInteger (0, 40);
+              trace[t].bsr.m_macCeList.push_back (bsr);
+            }
+        }
+    }
+  return trace;
+}
+
+static void
+Bench (Ptr<FfMacScheduler> sched, BenchSchedSapUser *user, uint32_t nUes,
+       const std::vector<TtiTrace> &trace, uint8_t bandwidth)
+{
+  FfMacCschedSapProvider *csched = sched->GetFfMacCschedSapProvider ();
+  FfMacSchedSapProvider *schedSap = sched->GetFfMacSchedSapProvider ();
+
+  FfMacCschedSapProvider::CschedCellConfigReqParameters cell = FfMacCschedSapProvider::CschedCellConfigReqParameters ();
+  cell.m_dlBandwidth = bandwidth;
+  cell.m_ulBandwidth = bandwidth;
+  csched->CschedCellConfigReq (cell);
+  for (uint16_t rnti = 1; rnti <= nUes; rnti++)
+    {
+      FfMacCschedSapProvider::CschedUeConfigReqParameters ue = FfMacCschedSapProvider::CschedUeConfigReqParameters ();
+      ue.m_rnti = rnti;
+      ue.m_transmissionMode = 0;
+      csched->CschedUeConfigReq (ue);
+
+      FfMacCschedSapProvider::CschedLcConfigReqParameters lc = FfMacCschedSapProvider::CschedLcConfigReqParameters ();
+      lc.m_rnti = rnti;
+      LogicalChannelConfigListElement_s lcConfig = LogicalChannelConfigListElement_s ();
+      lcConfig.m_logicalChannelIdentity = 3;
+      lcConfig.m_logicalChannelGroup = 0;
+      lcConfig.m_direction = LogicalChannelConfigListElement_s::DIR_BOTH;
+      lcConfig.m_qosBearerType = LogicalChannelConfigListElement_s::QBT_NON_GBR;
+      lcConfig.m_qci = 9;
+      lc.m_logicalChannelConfigList.push_back (lcConfig);
+      csched->CschedLcConfigReq (lc);
+    }
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  uint32_t frame = 1;
+  uint32_t subframe = 1;
+  for (uint32_t t = 0; t < trace.size (); t++)
+    {
+      uint16_t sfnSf = ((0x3FF & frame) << 4) | (0xF & subframe);
+      if (!trace[t].dlCqi.m_cqiList.empty ())
+        {
+          FfMacSchedSapProvider::SchedDlCqiInfoReqParameters dlCqi = trace[t].dlCqi;
+          dlCqi.m_sfnSf = sfnSf;
+          schedSap->SchedDlCqiInfoReq (dlCqi);
+        }
+      for (uint32_t i = 0; i < trace[t].rlc.size (); i++)
+        {
+          schedSap->SchedDlRlcBufferReq (trace[t].rlc[i]);
+        }
+      FfMacSchedSapProvider::SchedDlTriggerReqParameters dl;
+      dl.m_sfnSf = sfnSf;
+      dl.m_dlInfoList.swap (user->m_dlInfo);
+      schedSap->SchedDlTriggerReq (dl);
+
+      for (uint32_t i = 0; i < trace[t].ulCqi.size (); i++)
+        {
+          FfMacSchedSapProvider::SchedUlCqiInfoReqParameters ulCqi = trace[t].ulCqi[i];
+          ulCqi.m_sfnSf = sfnSf;
+          schedSap->SchedUlCqiInfoReq (ulCqi);
+        }
+      if (!trace[t].bsr.m_macCeList.empty ())
+        {
+          FfMacSchedSapProvider::SchedUlMacCtrlInfoReqParameters bsr = trace[t].bsr;
+          bsr.m_sfnSf = sfnSf;
+          schedSap->SchedUlMacCtrlInfoReq (bsr);
+        }
+      FfMacSchedSapProvider::SchedUlTriggerReqParameters ul;
+      ul.m_sfnSf = sfnSf;
+      schedSap->SchedUlTriggerReq (ul);
+
+      if (++subframe > 10)
+        {
+          subframe = 1;
+          frame++;
+        }
+    }
+  int64_t ms = clock.End ();
+
+  std::cout << std::left << std::setw (26) << sched->GetInstanceTypeId ().GetName ()
+            << std::right << std::setw (5) << nUes << " UEs "
+            << std::setw (8) << ms << " ms "
+            << std::setw (10) << (ms * 1e3 / trace.size ()) << " us/TTI "
+            << std::setw (10) << (ms * 1e6 / trace.size () / nUes) << " ns/TTI/UE   "
+            << user->m_dlAllocations << " DL, " << user->m_ulAllocations << " UL allocations" << std::endl;
+}
+
+int main (int argc, char *argv[])
+{
+  std::string scheduler = "ns3::PfFfMacScheduler";
+  uint32_t nUes = 100;
+  uint32_t nTtis = 10000;
+  uint32_t bandwidth = 100;
+
+  CommandLine cmd;
+  cmd.AddValue ("scheduler", "type of the scheduler", scheduler);
+  cmd.AddValue ("ues", "number of UEs of the cell", nUes);
+  cmd.AddValue ("ttis", "number of TTIs", nTtis);
+  cmd.AddValue ("bandwidth", "DL and UL bandwidth in RBs", bandwidth);
+  cmd.Parse (argc, argv);
+
+  ObjectFactory factory;
+  factory.SetTypeId (scheduler);
+  Ptr<FfMacScheduler> sched = factory.Create<FfMacScheduler> ();
+  Ptr<LteFfrAlgorithm> ffr = CreateObject<LteFrNoOpAlgorithm> ();
+  sched->SetLteFfrSapProvider (ffr->GetLteFfrSapProvider ());
+  ffr->SetLteFfrSapUser (sched->GetLteFfrSapUser ());
+  BenchSchedSapUser user;
+  sched->SetFfMacSchedSapUser (&user);
+  sched->SetFfMacCschedSapUser (&user);
+
+  std::vector<TtiTrace> trace = MakeTrace (nUes, nTtis, bandwidth);
+
+  // run inside the simulation, as the schedulers read the time
+  Simulator::ScheduleNow (&Bench, sched, &user, nUes, trace, bandwidth);
+  Simulator::Run ();
+  sched->Dispose ();
+  ffr->Dispose ();
+  Simulator::Destroy ();
+  return 0;
+}
@@ -0,0 +1,202 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Cost of the RLC of a single bearer: a transmitting and a receiving
+// RLC entity of the given mode are connected back to back through
+// their MAC SAPs, without losses.  At every TTI the transmitter is
+// topped up to --backlog SDUs of --sduSize bytes and given a TX
+// opportunity of --txOpportunity bytes, and in AM the receiver is given
+// one for its STATUS PDU.  The PDUs are delivered at the end of the TTI.
+//
+//   ./waf --run "lena-rlc-benchmark --rlc=um"
+//   ./waf --run "lena-rlc-benchmark --rlc=am --backlog=5000 --txOpportunity=20000"
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/lte-module.h"
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * The MAC of one side of the bearer, which keeps the PDUs of the RLC
+ * until the end of the TTI, and the PDCP, which counts the SDUs
+ */
+class BenchRlcSide : public LteMacSapProvider,
+                     public LteRlcSapUser
+{
+public:
+  BenchRlcSide ()
+    : m_statusPduSize (0),
+      m_pdus (0),
+      m_rxSdus (0),
+      m_rxBytes (0)
+  {
+  }
+
+  virtual void TransmitPdu (TransmitPduParameters params)
+  {
+    m_pdus++;
+    m_txPdus.push_back (params.pdu);
+  }
+  virtual void ReportBufferStatus (ReportBufferStatusParameters params)
+  {
+    m_statusPduSize = params.statusPduSize;
+  }
+  virtual void ReceivePdcpPdu (Ptr<Packet> p)
+  {
+    m_rxSdus++;
+    m_rxBytes += p->GetSize ();
+  }
+
+  uint16_t m_statusPduSize;                ///< size of the STATUS PDU last reported
+  uint64_t m_pdus;                         ///< number of PDUs sent
+  uint64_t m_rxSdus;                       ///< number of SDUs received
+  uint64_t m_rxBytes;                      ///< number of bytes of the SDUs received
+  std::vector<Ptr<Packet> > m_txPdus;      ///< PDUs sent during the TTI
+};
+
+/// The parameters and the state of the run
+struct BenchParams
+{
+  uint32_t sduSize;       ///< size of the SDUs
+  uint32_t backlog;       ///< number of SDUs queued at the start of each TTI
+  uint32_t txOpportunity; ///< size of the TX opportunity of each TTI
+  uint32_t ttis;          ///< number of TTIs
+  Ptr<LteRlc> tx;         ///< transmitting RLC
+  Ptr<LteRlc> rx;         ///< receiving RLC
+  BenchRlcSide *txSide;   ///< side of the transmitting RLC
+  BenchRlcSide *rxSide;   ///< side of the receiving RLC
+  uint32_t queued;        ///< number of SDUs given to the transmitting RLC
+};
+
+/**
+ * Deliver the PDUs sent by a side to the other
+ * \param from the sending side
+ * \param to the RLC of the receiving side
+ */
+static void
+Deliver (BenchRlcSide *from, Ptr<LteRlc> to)
+{
+  for (uint32_t i = 0; i < from->m_txPdus.size (); i++)
+    {
+      to->GetLteMacSapUser ()->ReceivePdu (from->m_txPdus[i]);
+    }
+  from->m_txPdus.clear ();
+}
+
+static void
+Tti (BenchParams *b, uint32_t tti)
+{
+  // top up the transmission buffer: the SDUs not received yet are
+  // still in it, whole or in part
+  while (b->queued < b->rxSide->m_rxSdus + b->backlog)
+    {
+      LteRlcSapProvider::TransmitPdcpPduParameters sdu;
+      sdu.rnti = 1;
+      sdu.lcid = 3;
+      sdu.pdcpPdu = Create<Packet> (b->sduSize);
+      b->tx->GetLteRlcSapProvider ()->TransmitPdcpPdu (sdu);
+      b->queued++;
+    }
+  b->tx->GetLteMacSapUser ()->NotifyTxOpportunity (b->txOpportunity, 0, 0);
+  if (b->rxSide->m_statusPduSize > 0)
+    {
+      b->rx->GetLteMacSapUser ()->NotifyTxOpportunity (b->rxSide->m_statusPduSize, 0, 0);
+    }
+  Deliver (b->txSide, b->rx);
+  Deliver (b->rxSide, b->tx);
+  if (tti + 1 < b->ttis)
+    {
+      Simulator::Schedule (MilliSeconds (1), &Tti, b, tti + 1);
+    }
+}
+
+int main (int argc, char *argv[])
+{
+  std::string rlc = "um";
+  BenchParams params;
+  params.sduSize = 1400;
+  params.backlog = 1000;
+  params.txOpportunity = 10000;
+  params.ttis = 10000;
+
+  CommandLine cmd;
+  cmd.AddValue ("rlc", "RLC mode: um or am", rlc);
+  cmd.AddValue ("sduSize", "size of the SDUs in bytes", params.sduSize);
+  cmd.AddValue ("backlog", "number of SDUs in the transmission buffer at each TTI", params.backlog);
+  cmd.AddValue ("txOpportunity", "size of the TX opportunity of each TTI in bytes", params.txOpportunity);
+  cmd.AddValue ("ttis", "number of TTIs", params.ttis);
+  cmd.Parse (argc, argv);
+
+  Ptr<LteRlc> tx;
+  Ptr<LteRlc> rx;
+  if (rlc == "am")
+    {
+      tx = CreateObject<LteRlcAm> ();
+      rx = CreateObject<LteRlcAm> ();
+    }
+  else if (rlc == "um")
+    {
+      Config::SetDefault ("ns3::LteRlcUm::MaxTxBufferSize", UintegerValue (0xFFFFFFFF));
+      tx = CreateObject<LteRlcUm> ();
+      rx = CreateObject<LteRlcUm> ();
+    }
+  else
+    {
+      NS_FATAL_ERROR ("unknown RLC mode " << rlc);
+    }
+  BenchRlcSide txSide;
+  BenchRlcSide rxSide;
+  Ptr<LteRlc> entities[2] = { tx, rx };
+  BenchRlcSide *sides[2] = { &txSide, &rxSide };
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      entities[i]->SetRnti (1);
+      entities[i]->SetLcId (3);
+      entities[i]->SetLteMacSapProvider (sides[i]);
+      entities[i]->SetLteRlcSapUser (sides[i]);
+    }
+
+  params.tx = tx;
+  params.rx = rx;
+  params.txSide = &txSide;
+  params.rxSide = &rxSide;
+  params.queued = 0;
+  Simulator::Schedule (MilliSeconds (1), &Tti, &params, 0);
+  Simulator::Stop (MilliSeconds (params.ttis + 1));
+  SystemWallClockMs clock;
+  clock.Start ();
+  Simulator::Run ();
+  int64_t ms = clock.End ();
+
+  std::cout << "RLC " << rlc << ", " << params.sduSize << " byte SDUs, "
+            << params.backlog << " SDU backlog, "
+            << params.txOpportunity << " byte TX opportunities" << std::endl
+            << std::setw (10) << ms << " ms "
+            << std::setw (10) << (ms * 1e3 / params.ttis) << " us/TTI "
+            << std::setw (10) << (ms > 0 ? rxSide.m_rxBytes / 1e3 / ms : 0) << " MB/s   "
+            << txSide.m_pdus << " PDUs, " << rxSide.m_rxSdus << " SDUs, "
+            << (rxSide.m_rxBytes * 8.0 / params.ttis / 1e3) << " Mbit/s simulated" << std::endl;
+
+  tx->Dispose ();
+  rx->Dispose ();
+  Simulator::Destroy ();
+  return 0;
+}
@@ -23,11 +23,48 @@
 #define FF_MAC_SCHEDULER_H
 
 #include <ns3/object.h>
+#include <ns3/ptr.h>
+#include <ns3/ff-mac-common.h>
+#include <ns3/ff-mac-csched-sap.h>
+#include <ns3/ff-mac-sched-sap.h>
+#include <ns3/lte-amc.h>
+#include <ns3/rnti-map.h>
+#include <map>
+#include <vector>
 
+// value for SINR outside the range defined by FF-API, used to indicate that there
+// is no CQI for this element
+#define NO_SINR -5000
+
+
+#define HARQ_PROC_NUM 8
+#define HARQ_DL_TIMEOUT 11
 
 namespace ns3 {
 
 
+typedef std::vector < uint8_t > DlHarqProcessesStatus_t;
+typedef std::vector < uint8_t > DlHarqProcessesTimer_t;
+typedef std::vector < DlDciListElement_s > DlHarqProcessesDciBuffer_t;
+typedef std::vector < std::vector <struct RlcPduListElement_s> > RlcPduList_t; // vector of the LCs and layers per UE
+typedef std::vector < RlcPduList_t > DlHarqRlcPduListBuffer_t; // vector of the 8 HARQ processes per UE
+
+typedef std::vector < UlDciListElement_s > UlHarqProcessesDciBuffer_t;
+typedef std::vector < uint8_t > UlHarqProcessesStatus_t;
+
+/**
+ * \ingroup ff-api
+ *
+ * A UE competing for the free RBGs of a DL subframe
+ */
+struct DlRbgCandidate
+{
+  uint32_t index;               ///< the position of the UE in the list of the UEs competing
+  uint16_t rnti;                ///< the RNTI of the UE
+  uint8_t nLayer;               ///< the number of layers of its transmission mode
+  const SbMeasResult_s *sbMeas; ///< its last A30 CQI report, 0 if none
+};
+
 
 class FfMacCschedSapUser;
 class FfMacSchedSapUser;
@@ -48,7 +85,10 @@ class LteFfrSapUser;
  * the helper object can plug on the MAC a scheduler implementation based on the
  * FF MAC Sched API.
  *
- *
+ * It also holds the state and the primitives common to the schedulers: the
+ * HARQ processes, the DL and UL CQIs with their timers, the buffer status
+ * reports and the RACH requests, and an allocation of the DL RBGs by a
+ * per-RBG metric given by each scheduler (see AllocateDlRbgs).
  */
 class FfMacScheduler : public Object
 {
@@ -126,12 +166,316 @@ public:
   
   bool IsThereData();
 
+  /**
+   * \brief Notify the MAC of a new transmission mode of a UE
+   *
+   * \param rnti the RNTI of the UE
+   * \param txMode the transmission mode
+   */
+  void TransmissionModeConfigurationUpdate (uint16_t rnti, uint8_t txMode);
+
 protected:
-    
+  //
+  // Implementation of the CSCHED and SCHED API primitives which do the
+  // same bookkeeping in all the schedulers
+  //
+
+  void DoCschedCellConfigReq (const struct FfMacCschedSapProvider::CschedCellConfigReqParameters& params);
+
+  void DoSchedDlPagingBufferReq (const struct FfMacSchedSapProvider::SchedDlPagingBufferReqParameters& params);
+
+  void DoSchedDlMacBufferReq (const struct FfMacSchedSapProvider::SchedDlMacBufferReqParameters& params);
+
+  void DoSchedDlRachInfoReq (const struct FfMacSchedSapProvider::SchedDlRachInfoReqParameters& params);
+
+  void DoSchedDlCqiInfoReq (const struct FfMacSchedSapProvider::SchedDlCqiInfoReqParameters& params);
+
+  void DoSchedUlNoiseInterferenceReq (const struct FfMacSchedSapProvider::SchedUlNoiseInterferenceReqParameters& params);
+
+  void DoSchedUlSrInfoReq (const struct FfMacSchedSapProvider::SchedUlSrInfoReqParameters& params);
+
+  void DoSchedUlMacCtrlInfoReq (const struct FfMacSchedSapProvider::SchedUlMacCtrlInfoReqParameters& params);
+
+  void DoSchedUlCqiInfoReq (const struct FfMacSchedSapProvider::SchedUlCqiInfoReqParameters& params);
+
+  /**
+   * \brief Store the UL CQIs of a SCHED_UL_CQI_INFO_REQ
+   *
+   * \param params the parameters of the primitive
+   * \param defaultSinr the SINR given to the RBs of a UE without a
+   *        measurement when its first UL CQI is received
+   */
+  void UpdateUlCqi (const struct FfMacSchedSapProvider::SchedUlCqiInfoReqParameters& params, double defaultSinr);
+
+  /**
+   * \param dlbandwidth the DL bandwidth in RBs
+   * \return the size of the RBGs of the resource allocation type 0
+   */
+  int GetRbgSize (int dlbandwidth);
+
+  /**
+   * \param rnti the RNTI of the UE
+   * \param rb the RB
+   * \return the UL SINR of the RB, estimated from the UL CQIs of the UE
+   */
+  double EstimateUlSinr (uint16_t rnti, uint16_t rb);
+
+  /// Expire the DL CQIs not refreshed within the CQI timer threshold
+  void RefreshDlCqiMaps (void);
+  /// Expire the UL CQIs not refreshed within the CQI timer threshold
+  void RefreshUlCqiMaps (void);
+
+  /**
+   * \brief Update the buffer status of a UE with the size of a UL grant
+   *
+   * \param rnti the RNTI of the UE
+   * \param size the size of the grant in bytes
+   */
+  void UpdateUlRlcBufferInfo (uint16_t rnti, uint16_t size);
+
+  /**
+  * \brief Update and return a new process Id for the RNTI specified
+  *
+  * \param rnti the RNTI of the UE to be updated
+  * \return the process id  value
+  */
+  uint8_t UpdateHarqProcessId (uint16_t rnti);
+
+  /**
+  * \brief Return the availability of free process for the RNTI specified
+  *
+  * \param rnti the RNTI of the UE to be updated
+  * \return the process id  value
+  */
+  uint8_t HarqProcessAvailability (uint16_t rnti);
+
+  /**
+  * \brief Refresh HARQ processes according to the timers
+  *
+  */
+  void RefreshHarqProcesses ();
+
+  /**
+   * \brief Allocate the free RBGs of a DL subframe, each to the UE with
+   * the highest metric on it
+   *
+   * The transmission mode and the A30 CQI report of the UEs are looked up
+   * once, and the rate of an RBG at each CQI once, so that the metric of
+   * all the UEs on an RBG is evaluated in a single pass over a contiguous
+   * array.  Ties go to the UE found first in \p rntis.
+   *
+   * The Metric class provides:
+   * - bool IsEligible (const DlRbgCandidate &ue, uint32_t rbg): whether the
+   *   UE may be allocated the RBG;
+   * - double Evaluate (const DlRbgCandidate &ue, uint32_t rbg, double rate):
+   *   the metric of the UE on the RBG, given the achievable rate of the
+   *   UE on it, in bytes/s, for the eligible UEs with a CQI in range on
+   *   the RBG; a UE is allocated an RBG only if its metric is positive;
+   * - void Allocate (const DlRbgCandidate &ue, uint32_t rbg, const std::vector<uint16_t> &rbgs):
+   *   called after the UE is allocated the RBG, with all the RBGs it has.
+   *
+   * \param rntis the UEs competing for the RBGs, in the order of the flows
+   *        of the scheduler
+   * \param rbgSize the size of the RBGs
+   * \param rbgMap the map of the allocated RBGs, updated
+   * \param allocationMap the RBGs of each UE, updated
+   * \param metric the metric
+   */
+  template <class Metric>
+  void AllocateDlRbgs (const std::vector<uint16_t> &rntis, int rbgSize,
+                       std::vector <bool> &rbgMap,
+                       std::map <uint16_t, std::vector <uint16_t> > &allocationMap,
+                       Metric &metric);
+
+  /**
+   * \param rntis the UEs
+   * \param candidates the candidates of the UEs, in the same order
+   */
+  void GetDlRbgCandidates (const std::vector<uint16_t> &rntis, std::vector<DlRbgCandidate> &candidates);
+
+  /**
+   * \param rbgSize the size of the RBGs
+   * \param rates the rate of a layer on an RBG at each CQI from 0 to 15,
+   *        followed by the rate at the lowest MCS, in bytes/s
+   */
+  void GetDlRbgRates (int rbgSize, std::vector<double> &rates);
+
+  /**
+   * \param ue a candidate
+   * \param rbg the RBG
+   * \param rates the rates returned by GetDlRbgRates
+   * \return the achievable rate of the UE on the RBG, or a negative value if
+   *         its CQI on the RBG is out of range
+   */
+  static double GetDlRbgRate (const DlRbgCandidate &ue, uint32_t rbg, const std::vector<double> &rates);
+
   UlCqiFilter_t m_ulCqiFilter;
 
+  Ptr<LteAmc> m_amc;
+
+  // MAC and FFR SAPs
+  FfMacCschedSapUser* m_cschedSapUser;
+  LteFfrSapProvider* m_ffrSapProvider;
+
+  // Internal parameters
+  FfMacCschedSapProvider::CschedCellConfigReqParameters m_cschedCellConfig;
+
+  /*
+  * Map of UE's DL CQI P01 received
+  */
+  RntiMap <uint8_t> m_p10CqiRxed;
+  /*
+  * Map of UE's timers on DL CQI P01 received
+  */
+  RntiMap <uint32_t> m_p10CqiTimers;
+
+  /*
+  * Map of UE's DL CQI A30 received
+  */
+  RntiMap <SbMeasResult_s> m_a30CqiRxed;
+  /*
+  * Map of UE's timers on DL CQI A30 received
+  */
+  RntiMap <uint32_t> m_a30CqiTimers;
+
+  /*
+  * Map of previous allocated UE per RBG
+  * (used to retrieve info from UL-CQI)
+  */
+  std::map <uint16_t, std::vector <uint16_t> > m_allocationMaps;
+
+  /*
+  * Map of UEs' UL-CQI per RBG
+  */
+  RntiMap <std::vector <double> > m_ueCqi;
+  /*
+  * Map of UEs' timers on UL-CQI per RBG
+  */
+  RntiMap <uint32_t> m_ueCqiTimers;
+
+  /*
+  * Map of UE's buffer status reports received
+  */
+  RntiMap <uint32_t> m_ceBsrRxed;
+
+  uint32_t m_cqiTimersThreshold; // # of TTIs for which a CQI canbe considered valid
+
+  RntiMap <uint8_t> m_uesTxMode; // txMode of the UEs
+
+  // HARQ attributes
+  /**
+  * m_harqOn when false inhibit te HARQ mechanisms (by default active)
+  */
+  bool m_harqOn;
+  RntiMap <uint8_t> m_dlHarqCurrentProcessId;
+  //HARQ status
+  // 0: process Id available
+  // x>0: process Id equal to `x` trasmission count
+  RntiMap <DlHarqProcessesStatus_t> m_dlHarqProcessesStatus;
+  RntiMap <DlHarqProcessesTimer_t> m_dlHarqProcessesTimer;
+  RntiMap <DlHarqProcessesDciBuffer_t> m_dlHarqProcessesDciBuffer;
+  RntiMap <DlHarqRlcPduListBuffer_t> m_dlHarqProcessesRlcPduListBuffer;
+  std::vector <DlInfoListElement_s> m_dlInfoListBuffered; // HARQ retx buffered
+
+  RntiMap <uint8_t> m_ulHarqCurrentProcessId;
+  //HARQ status
+  // 0: process Id available
+  // x>0: process Id equal to `x` trasmission count
+  RntiMap <UlHarqProcessesStatus_t> m_ulHarqProcessesStatus;
+  RntiMap <UlHarqProcessesDciBuffer_t> m_ulHarqProcessesDciBuffer;
+
+  // RACH attributes
+  std::vector <struct RachListElement_s> m_rachList;
+  std::vector <uint16_t> m_rachAllocationMap;
+
 };
 
+inline double
+FfMacScheduler::GetDlRbgRate (const DlRbgCandidate &ue, uint32_t rbg, const std::vector<double> &rates)
+{
+  double rate = 0.0;
+  if (ue.sbMeas == 0)
+    {
+      // no subband CQI: start with the lowest value on all the layers
+      for (uint8_t k = 0; k < ue.nLayer; k++)
+        {
+          rate += rates[1];
+        }
+      return rate;
+    }
+  const std::vector <uint8_t> &sbCqi = ue.sbMeas->m_higherLayerSelected.at (rbg).m_sbCqi;
+  uint8_t cqi1 = sbCqi.at (0);
+  uint8_t cqi2 = (sbCqi.size () > 1) ? sbCqi.at (1) : 1;
+  if ((cqi1 == 0) && (cqi2 == 0))
+    {
+      // CQI == 0 means "out of range" (see table 7.2.3-1 of 36.213)
+      return -1.0;
+    }
+  for (uint8_t k = 0; k < ue.nLayer; k++)
+    {
+      if (k < sbCqi.size ())
+        {
+          NS_ASSERT_MSG (sbCqi[k] <= 15, "CQI must be in [0..15] = " << (uint16_t) sbCqi[k]);
+          rate += rates[sbCqi[k]];
+        }
+      else
+        {
+          // no info on this subband -> worst MCS
+          rate += rates[16];
+        }
+    }
+  return rate;
+}
+
+template <class Metric>
+void
+FfMacScheduler::AllocateDlRbgs (const std::vector<uint16_t> &rntis, int rbgSize,
+                                std::vector <bool> &rbgMap,
+                                std::map <uint16_t, std::vector <uint16_t> > &allocationMap,
+                                Metric &metric)
+{
+  std::vector<DlRbgCandidate> candidates;
+  GetDlRbgCandidates (rntis, candidates);
+  std::vector<double> rates;
+  GetDlRbgRates (rbgSize, rates);
+
+  uint32_t rbgNum = m_cschedCellConfig.m_dlBandwidth / rbgSize;
+  for (uint32_t i = 0; i < rbgNum; i++)
+    {
+      if (rbgMap.at (i))
+        {
+          continue;
+        }
+      uint32_t best = candidates.size ();
+      double bestMetric = 0.0;
+      for (uint32_t c = 0; c < candidates.size (); c++)
+        {
+          if (!metric.IsEligible (candidates[c], i))
+            {
+              continue;
+            }
+          double rate = GetDlRbgRate (candidates[c], i, rates);
+          if (rate < 0)
+            {
+              continue;
+            }
+          double value = metric.Evaluate (candidates[c], i, rate);
+          if (value > bestMetric)
+            {
+              bestMetric = value;
+              best = c;
+            }
+        }
+      if (best < candidates.size ())
+        {
+          rbgMap.at (i) = true;
+          std::vector <uint16_t> &rbgs = allocationMap[candidates[best].rnti];
+          rbgs.push_back (i);
+          metric.Allocate (candidates[best], i, rbgs);
+        }
+    }
+}
+
 }  // namespace ns3
 
 #endif /* FF_MAC_SCHEDULER_H */
@@ -26,6 +26,7 @@
 #include <ns3/assert.h>
 #include <ns3/math.h>
 #include <vector>
+#include <limits>
 #include <ns3/spectrum-value.h>
 #include <ns3/double.h>
 #include "ns3/enum.h"
@@ -87,6 +88,15 @@ static const double SpectralEfficiencyForMcs[32] = {
   0, 0, 0
 };
 
+/**
+ * Table of CQI index and the MCS index chosen for it, i.e., the highest MCS
+ * whose spectral efficiency in SpectralEfficiencyForMcs does not exceed the
+ * one of the CQI in SpectralEfficiencyForCqi.
+ */
+static const int McsForCqi[16] = {
+  0, 0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28
+};
+
 /**
  * Table of MCS index (IMCS) and its TBS index (ITBS). Taken from 3GPP TS
  * 36.213 v8.8.0 Table 7.1.7.1-1: _Modulation and TBS index table for PDSCH_.
@@ -221,6 +231,7 @@ static const int TransportBlockSizeTable [110][27] = {
 
 
 LteAmc::LteAmc ()
+  : m_cqiSinrThresholdsBer (-1.0)
 {
 }
 
@@ -256,10 +267,11 @@ LteAmc::GetCqiFromSpectralEfficiency (double s)
 {
   NS_LOG_FUNCTION (s);
   NS_ASSERT_MSG (s >= 0.0, "negative spectral efficiency = " << s);
+  // the table is increasing: count the CQIs below s
   int cqi = 0;
-  while ((cqi < 15) && (SpectralEfficiencyForCqi[cqi + 1] < s))
+  for (int i = 1; i < 16; i++)
     {
-      ++cqi;
+      cqi += (SpectralEfficiencyForCqi[i] < s);
     }
   NS_LOG_LOGIC ("cqi = " << cqi);
   return cqi;
@@ -271,12 +283,7 @@ LteAmc::GetMcsFromCqi (int cqi)
 {
   NS_LOG_FUNCTION (cqi);
   NS_ASSERT_MSG (cqi >= 0 && cqi <= 15, "CQI must be in [0..15] = " << cqi);
-  double spectralEfficiency = SpectralEfficiencyForCqi[cqi];
-  int mcs = 0;
-  while ((mcs < 28) && (SpectralEfficiencyForMcs[mcs + 1] <= spectralEfficiency))
-    {
-      ++mcs;
-    }
+  int mcs = McsForCqi[cqi];
   NS_LOG_LOGIC ("mcs = " << mcs);
   return mcs;
 }
@@ -314,36 +321,11 @@ LteAmc::CreateCqiFeedbacks (const SpectrumValue& sinr, uint8_t rbgSize)
   
   if (m_amcModel == PiroEW2010)
     {
-
-      for (it = sinr.ConstValuesBegin (); it != sinr.ConstValuesEnd (); it++)
+      std::vector<double> values (sinr.ConstValuesBegin (), sinr.ConstValuesEnd ());
+      cqi.resize (values.size ());
+      if (!values.empty ())
         {
-          double sinr_ = (*it);
-          if (sinr_ == 0.0)
-            {
-              cqi.push_back (-1); // SINR == 0 (linear units) means no signal in this RB
-            }
-          else
-            {
-              /*
-              * Compute the spectral efficiency from the SINR
-              *                                        SINR
-              * spectralEfficiency = log2 (1 + -------------------- )
-              *                                    -ln(5*BER)/1.5
-              * NB: SINR must be expressed in linear units
-              */
-
-              double s = log2 ( 1 + ( sinr_ / ( (-std::log (5.0 * m_ber )) / 1.5) ));
-
-              int cqi_ = GetCqiFromSpectralEfficiency (s);
-
-              NS_LOG_LOGIC (" PRB =" << cqi.size ()
-                                    << ", sinr = " << sinr_
-                                    << " (=" << 10 * std::log10 (sinr_) << " dB)"
-                                    << ", spectral efficiency =" << s
-                                    << ", CQI = " << cqi_ << ", BER = " << m_ber);
-
-              cqi.push_back (cqi_);
-            }
+          CreateCqiFeedbacks (&values[0], values.size (), &cqi[0]);
         }
     }
   else if (m_amcModel == MiErrorModel)
@@ -411,4 +393,82 @@ LteAmc::CreateCqiFeedbacks (const SpectrumValue& sinr, uint8_t rbgSize)
   return cqi;
 }
 
+void
+LteAmc::UpdateCqiSinrThresholds (void)
+{
+  if (m_cqiSinrThresholdsBer == m_ber)
+    {
+      return;
+    }
+  NS_LOG_FUNCTION (this << m_ber);
+  m_cqiSinrThresholdsBer = m_ber;
+  /*
+   * The spectral efficiency exceeds the one of CQI i when
+   *
+   *   SINR > (2^SpectralEfficiencyForCqi[i] - 1) * -ln(5*BER)/1.5
+   *
+   * The threshold is widened by a relative margin much larger than the
+   * rounding errors of both sides, so that a SINR outside of the margin
+   * gives the CQI which the formula gives.
+   */
+  double gap = (-std::log (5.0 * m_ber)) / 1.5;
+  for (int i = 0; i < 15; i++)
+    {
+      double threshold = (std::pow (2.0, SpectralEfficiencyForCqi[i + 1]) - 1) * gap;
+      m_cqiSinrLow[i] = threshold * (1 - 1e-9);
+      m_cqiSinrHigh[i] = threshold * (1 + 1e-9);
+    }
+  m_cqiSinrLow[15] = std::numeric_limits<double>::infinity ();
+}
+
+bool
+LteAmc::CreateCqiFeedbacks (const double *sinr, uint32_t nRb, int *cqi)
+{
+  NS_LOG_FUNCTION (this << nRb);
+
+  if (m_amcModel != PiroEW2010)
+    {
+      return false;
+    }
+  UpdateCqiSinrThresholds ();
+  for (uint32_t i = 0; i < nRb; i++)
+    {
+      double sinr_ = sinr[i];
+      NS_ASSERT_MSG (sinr_ >= 0.0, "negative SINR = " << sinr_);
+      /*
+       * The CQI is the number of CQIs whose spectral efficiency is below
+       *                                        SINR
+       * spectralEfficiency = log2 (1 + -------------------- )
+       *                                    -ln(5*BER)/1.5
+       * (SINR in linear units), i.e., the number of SINR thresholds below
+       * the SINR, found by a binary search without branches.
+       */
+      int low = 0;
+      low += (sinr_ > m_cqiSinrLow[low + 7]) * 8;
+      low += (sinr_ > m_cqiSinrLow[low + 3]) * 4;
+      low += (sinr_ > m_cqiSinrLow[low + 1]) * 2;
+      low += (sinr_ > m_cqiSinrLow[low]);
+      if (sinr_ == 0.0)
+        {
+          cqi[i] = -1; // SINR == 0 (linear units) means no signal in this RB
+        }
+      else if (low == 0 || sinr_ > m_cqiSinrHigh[low - 1])
+        {
+          cqi[i] = low;
+        }
+      else
+        {
+          // too close to a threshold, use the formula
+          double s = log2 ( 1 + ( sinr_ / ( (-std::log (5.0 * m_ber )) / 1.5) ));
+          cqi[i] = GetCqiFromSpectralEfficiency (s);
+        }
+
+      NS_LOG_LOGIC (" PRB =" << i
+                            << ", sinr = " << sinr_
+                            << " (=" << 10 * std::log10 (sinr_) << " dB)"
+                            << ", CQI = " << cqi[i] << ", BER = " << m_ber);
+    }
+  return true;
+}
+
 } // namespace ns3
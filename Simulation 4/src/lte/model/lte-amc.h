@@ -99,6 +99,18 @@ public:
   /*static*/ std::vector<int> CreateCqiFeedbacks (const SpectrumValue& sinr,
                                                   uint8_t rbgSize = 0);
 
+  /**
+   * \brief Compute the CQI of each RB from an array of SINR values, as
+   * CreateCqiFeedbacks does with the PiroEW2010 model
+   * \param sinr the SINR of each RB, in linear units
+   * \param nRb the number of RBs
+   * \param cqi the array receiving the CQI of each RB, -1 for an RB without
+   *        signal
+   * \return false if the AMC model does not evaluate the RBs one by one
+   *         (MiErrorModel), in which case cqi is left untouched
+   */
+  bool CreateCqiFeedbacks (const double *sinr, uint32_t nRb, int *cqi);
+
   /**
    * \brief Get a proper CQI for the spectrale efficiency value.
    * In order to assure a fewer block error rate, the AMC chooses the lower CQI value
@@ -109,6 +121,12 @@ public:
   /*static*/ int GetCqiFromSpectralEfficiency (double s);
   
 private:
+
+  /**
+   * Compute the SINR thresholds of the CQIs for the current BER, if it
+   * changed since they were last computed
+   */
+  void UpdateCqiSinrThresholds (void);
   
   /**
    * The `Ber` attribute.
@@ -124,6 +142,20 @@ private:
    */
   AmcModel m_amcModel;
 
+  /// BER for which the SINR thresholds of the CQIs were computed
+  double m_cqiSinrThresholdsBer;
+
+  /**
+   * Lower bound of the SINR above which the spectral efficiency exceeds
+   * the one of CQI i + 1, followed by infinity. The SINRs between the lower
+   * and the upper bound are too close to the threshold to be decided
+   * without the exact formula.
+   */
+  double m_cqiSinrLow[16];
+
+  /// Upper bound of the SINR above which the spectral efficiency exceeds the one of CQI i + 1
+  double m_cqiSinrHigh[15];
+
 }; // end of `class LteAmc`
 
 
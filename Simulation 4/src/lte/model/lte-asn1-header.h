@@ -25,6 +25,7 @@
 
 #include <bitset>
 #include <string>
+#include <vector>
 
 namespace ns3 {
 
@@ -55,7 +56,7 @@ public:
     
   /**
    * This function serializes class attributes to m_serializationResult
-   * local Buffer.  As ASN1 encoding produces a bitstream that does not have
+   * local octet vector.  As ASN1 encoding produces a bitstream that does not have
    * a fixed length, this function is needed to store the result, so
    * its length can be retrieved with Header::GetSerializedSize() function.
    * This method is pure virtual in this class (needs to be implemented
@@ -68,7 +69,7 @@ protected:
   mutable uint8_t m_serializationPendingBits; //!< pending bits
   mutable uint8_t m_numSerializationPendingBits; //!< number of pending bits
   mutable bool m_isDataSerialized; //!< true if data is serialized
-  mutable Buffer m_serializationResult; //!< serialization result
+  mutable std::vector<uint8_t> m_serializationResult; //!< serialization result
 
   /**
    * Function to write in m_serializationResult, after resizing its size
@@ -76,6 +77,15 @@ protected:
    */
   void WriteOctet (uint8_t octet) const;
 
+  /**
+   * Serialize the least significant bits of a value, most significant
+   * first. All the other serialization functions end up here, so that
+   * whole octets are written at once instead of single bits.
+   * \param value value to serialize
+   * \param numBits number of bits to serialize, at most 32
+   */
+  void SerializeBits (uint32_t value, int numBits) const;
+
   // Serialization functions
 
   /**
@@ -120,6 +130,15 @@ protected:
    * Finalizes an in progress serialization.
    */
   void FinalizeSerialization () const;
+  /**
+   * Finalizes an in progress deserialization, dropping the padding bits
+   * of the last octet read.
+   * \param bIteratorStart buffer iterator at the start of the header
+   * \param bIterator buffer iterator after the last octet read
+   * \returns the number of octets read
+   */
+  uint32_t FinalizeDeserialization (Buffer::Iterator bIteratorStart,
+                                    Buffer::Iterator bIterator);
 
   /**
    * Serialize a bitset
@@ -255,6 +274,15 @@ protected:
   void SerializeBitstring (std::bitset<32> bitstring) const;
 
   // Deserialization functions
+  /**
+   * Deserialize bits, most significant first
+   * \param value buffer to store the result
+   * \param numBits number of bits to deserialize, at most 32
+   * \param bIterator buffer iterator
+   * \returns the modified buffer iterator
+   */
+  Buffer::Iterator DeserializeBits (uint32_t *value, int numBits,
+                                    Buffer::Iterator bIterator);
 
   /**
    * Deserialize a bitset
@@ -1012,6 +1012,7 @@ LteEnbMac::DoReportBufferStatus (LteMacSapProvider::ReportBufferStatusParameters
   req.m_rlcRetransmissionHolDelay = params.retxQueueHolDelay;
   req.m_rlcStatusPduSize = params.statusPduSize;
   m_schedSapProvider->SchedDlRlcBufferReq (req);
+  m_enbPhySapProvider->WakeUp ();
 }
 
 
@@ -61,6 +61,13 @@ public:
   */
   virtual uint8_t GetMacChTtiDelay () = 0;
 
+  /**
+   * \brief Notify the PHY that the MAC has new work, such as a change of
+   * the RLC buffer status, so that a subframe loop suspended while the
+   * cell is idle resumes at the next subframe
+   */
+  virtual void WakeUp () = 0;
+
 
 };
 
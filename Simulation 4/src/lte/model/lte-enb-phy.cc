@@ -23,6 +23,7 @@
 #include <ns3/log.h>
 #include <cfloat>
 #include <cmath>
+#include <algorithm>
 #include <ns3/simulator.h>
 #include <ns3/attribute-accessor-helper.h>
 #include <ns3/double.h>
@@ -82,6 +83,7 @@ public:
   virtual void SetCellId (uint16_t cellId);
   virtual void SendLteControlMessage (Ptr<LteControlMessage> msg);
   virtual uint8_t GetMacChTtiDelay ();
+  virtual void WakeUp ();
 
 
 private:
@@ -123,6 +125,12 @@ EnbMemberLteEnbPhySapProvider::GetMacChTtiDelay ()
   return (m_phy->DoGetMacChTtiDelay ());
 }
 
+void
+EnbMemberLteEnbPhySapProvider::WakeUp ()
+{
+  m_phy->DoWakeUp ();
+}
+
 
 ////////////////////////////////////////
 // generic LteEnbPhy methods
@@ -147,7 +155,10 @@ LteEnbPhy::LteEnbPhy (Ptr<LteSpectrumPhy> dlPhy, Ptr<LteSpectrumPhy> ulPhy)
     m_currentSrsOffset (0),
     m_interferenceSampleCounter (0),
     m_grantTimeout (Seconds(0)),
-    m_isWaitingForChannelAccessGrant (false)
+    m_isWaitingForChannelAccessGrant (false),
+    m_idle (false),
+    m_wokenUp (false),
+    m_resumeSubFrame (0)
 {
   m_enbPhySapProvider = new EnbMemberLteEnbPhySapProvider (this);
   m_enbCphySapProvider = new MemberLteEnbCphySapProvider<LteEnbPhy> (this);
@@ -289,11 +300,31 @@ LteEnbPhy::GetTypeId (void)
                 BooleanValue(false),
                 MakeBooleanAccessor(&LteEnbPhy::m_dropPackets),
                 MakeBooleanChecker())
+  .AddAttribute ("TxopAwareScheduling",
+                 "Meant to be used only when channel access manager is set and ImplWith2msDelay is false; "
+                 "if true, the MAC is triggered only when the subframe it schedules is free: the subframes "
+                 "scheduled while there is no channel access are held and transmitted at the start of the next "
+                 "TXOP, and the end of a TXOP too short for data carries the pending control messages. "
+                 "This reduces, but does not eliminate, the scheduling outside the TXOPs: the MAC is still "
+                 "triggered when there is no grant, at most one subframe ahead, and the scheduler is not told "
+                 "the start or the duration of the grant. DropPackets is ignored.",
+                 BooleanValue (false),
+                 MakeBooleanAccessor (&LteEnbPhy::m_txopAwareScheduling),
+                 MakeBooleanChecker ())
   .AddAttribute ("ChannelAccessManagerStartTime",
                  "Time at which will start to use channel access manager if available. ",
                  TimeValue(Seconds(2)),
                  MakeTimeAccessor(&LteEnbPhy::m_channelAccessManagerStartTime),
-                 MakeTimeChecker());
+                 MakeTimeChecker())
+  .AddAttribute ("IdleFastForward",
+                 "If true, skip the subframes of an idle cell up to the next MIB, SIB1 "
+                 "or DRS, or until the MAC or an UE has something to do. "
+                 "The frame and subframe numbers are kept, but the reference signals "
+                 "are only sent in the subframes that run, and the TTI-counted timers "
+                 "of the MAC schedulers do not advance in the skipped subframes.",
+                 BooleanValue (false),
+                 MakeBooleanAccessor (&LteEnbPhy::m_idleFastForward),
+                 MakeBooleanChecker ());
   return tid;
 }
 
@@ -325,6 +356,7 @@ void
 LteEnbPhy::DoDispose ()
 {
   NS_LOG_FUNCTION (this);
+  m_resumeEvent.Cancel ();
 
   if (m_generateCtrlAndRbStats)
     {
@@ -574,6 +606,7 @@ void
 LteEnbPhy::PhyPduReceived (Ptr<Packet> p)
 {
   NS_LOG_FUNCTION (this);
+  DoWakeUp ();
   m_enbPhySapUser->ReceivePhyPdu (p);
 }
 
@@ -675,6 +708,7 @@ LteEnbPhy::ReceiveLteControlMessageList (std::list<Ptr<LteControlMessage> > msgL
         case LteControlMessage::RACH_PREAMBLE:
           {
             Ptr<RachPreambleLteControlMessage> rachPreamble = DynamicCast<RachPreambleLteControlMessage> (*it);
+            DoWakeUp ();
             m_enbPhySapUser->ReceiveRachPreamble (rachPreamble->GetRapId ());
           }
           break;
@@ -696,6 +730,7 @@ LteEnbPhy::ReceiveLteControlMessageList (std::list<Ptr<LteControlMessage> > msgL
             // check whether the UE is connected
             if (m_ueAttached.find (bsr.m_rnti) != m_ueAttached.end ())
               {
+                DoWakeUp ();
                 m_enbPhySapUser->ReceiveLteControlMessage (*it);
               }
           }
@@ -707,6 +742,7 @@ LteEnbPhy::ReceiveLteControlMessageList (std::list<Ptr<LteControlMessage> > msgL
             // check whether the UE is connected
             if (m_ueAttached.find (dlharq.m_rnti) != m_ueAttached.end ())
               {
+                DoWakeUp ();
                 m_enbPhySapUser->ReceiveLteControlMessage (*it);
               }
           }
@@ -760,6 +796,7 @@ LteEnbPhy::StartSubFrame (void)
 
   ++m_nrSubFrames;
   m_ttiBegin = Simulator::Now();
+  m_wokenUp = false;
 
   // piece of code that needs to be executed each subframe, no mather if we are are transmiting subframe or not
 
@@ -891,6 +928,12 @@ LteEnbPhy::StartSubFrame (void)
           Simulator::Schedule (Seconds (GetTti ()), &LteEnbPhy::EndSubFrame, this);
           return;
         }
+      else if (m_txopAwareScheduling)  // implementation 3 - the scheduler only fills subframes that will be transmitted
+        {
+          StartTxopAwareSubFrame ();
+          Simulator::Schedule (Seconds (GetTti ()), &LteEnbPhy::EndSubFrame, this);
+          return;
+        }
       else  // implementation 2 - without 2ms delay, scheduler is not being stopped
         {
           // if there is no data neither ctrl messages ready to be transmitted shift the queues
@@ -1174,6 +1217,58 @@ LteEnbPhy::TransmitPartialSubFrame (void)
 }
 */
 
+bool
+LteEnbPhy::IsNextScheduledSubFrameFree (void) const
+{
+  return m_packetBurstQueue.back ()->GetNPackets () == 0
+         && m_controlMessagesQueue.back ().empty ();
+}
+
+void
+LteEnbPhy::StartTxopAwareSubFrame (void)
+{
+  NS_LOG_FUNCTION (this);
+  bool data = IsNonEmptyPacketBurst ();
+
+  if (!data && !IsNonEmptyCtrMessage ())
+    {
+      // nothing to transmit, shift the queues and release the grant
+      GetControlMessages ();
+      GetPacketBurst ();
+      m_grantTimeout = std::min (m_grantTimeout, m_ttiBegin);
+    }
+  else
+    {
+      // a subframe with data needs the whole subframe in the grant, one
+      // with only control messages just its control region, so that it
+      // can be sent in the partial subframe at the end of a TXOP
+      Time needed = data ? Seconds (GetTti ()) : DL_CTRL_DELAY_FROM_SUBFRAME_START;
+      if (m_grantTimeout - m_ttiBegin < needed && !m_isWaitingForChannelAccessGrant)
+        {
+          m_grantTimeout = std::min (m_grantTimeout, m_ttiBegin);
+          // this may invoke immediately ReceiveAccessGranted
+          RequestChannelAccess ();
+        }
+
+      if (m_grantTimeout - m_ttiBegin >= needed)
+        {
+          // without data TransmitSubFrame only sends the control channels
+          // and releases the rest of the grant
+          TransmitSubFrame ();
+        }
+      // else hold the queues, the subframes already scheduled are
+      // transmitted back to back at the start of the next TXOP
+    }
+
+  // trigger the MAC only if the subframe it schedules is free: while
+  // the queues are held the MAC would pile up allocations on the same
+  // subframe, of which only the RBs of one can be transmitted
+  if (IsNextScheduledSubFrameFree ())
+    {
+      m_enbPhySapUser->SubframeIndication (m_nrFrames, m_nrSubFrames);
+    }
+}
+
 
 
 void
@@ -1254,6 +1349,27 @@ LteEnbPhy::EndSubFrame (void)
 {
   NS_LOG_FUNCTION (this << Simulator::Now ().GetSeconds ());
 
+  if (m_idleFastForward && IsIdle ())
+    {
+      uint64_t index = m_nrFrames * 10ULL + m_nrSubFrames;
+      uint64_t resume = GetNextMandatorySubFrame (index);
+      if (resume != index)
+        {
+          // suspend the subframe loop until the next mandatory subframe,
+          // or until woken up
+          NS_LOG_LOGIC ("cell " << m_cellId << " idle, resume at subframe " << resume);
+          m_idle = true;
+          m_resumeSubFrame = resume;
+          if (resume != 0)
+            {
+              Time tti = Seconds (GetTti ());
+              m_resumeEvent = Simulator::Schedule (TimeStep (tti.GetTimeStep () * (resume - index)),
+                                                   &LteEnbPhy::ResumeSubFrames, this, resume);
+            }
+          return;
+        }
+    }
+
   if (m_nrSubFrames == 10)
     {
       Simulator::ScheduleNow (&LteEnbPhy::EndFrame, this);
@@ -1272,6 +1388,122 @@ LteEnbPhy::EndFrame (void)
   Simulator::ScheduleNow (&LteEnbPhy::StartFrame, this);
 }
 
+bool
+LteEnbPhy::IsIdle (void)
+{
+  if (m_wokenUp || HasQueuedTransmissions ())
+    {
+      return false;
+    }
+  for (uint32_t i = 0; i < m_ulDciQueue.size (); i++)
+    {
+      if (!m_ulDciQueue.at (i).empty ())
+        {
+          return false;
+        }
+    }
+  if (m_channelAccessManager != 0 && Simulator::Now () >= m_channelAccessManagerStartTime
+      && (m_isWaitingForChannelAccessGrant || m_grantTimeout > Simulator::Now ()))
+    {
+      return false;
+    }
+  return !IsThereData ();
+}
+
+uint64_t
+LteEnbPhy::GetNextMandatorySubFrame (uint64_t index) const
+{
+  // the periods are at most 160 TTIs, i.e. 16 frames
+  uint64_t current = m_nrFrames * 10ULL + m_nrSubFrames - 1;
+  Time tti = Seconds (GetTti ());
+  for (uint64_t frame = index / 10; frame <= index / 10 + 16; frame++)
+    {
+      // MIB in subframe 1, SIB1 and DRS in subframe 6
+      uint64_t first = frame * 10;
+      uint64_t sixth = frame * 10 + 5;
+      if (first >= index)
+        {
+          Time start = m_ttiBegin + TimeStep (tti.GetTimeStep () * (first - current));
+          bool mibAndSib = m_disableMibAndSibStartupTime == Seconds (0) || start <= m_disableMibAndSibStartupTime;
+          if (mibAndSib && (frame % (m_mibPeriod / 10)) == 0)
+            {
+              return first;
+            }
+        }
+      if (sixth >= index)
+        {
+          Time start = m_ttiBegin + TimeStep (tti.GetTimeStep () * (sixth - current));
+          bool mibAndSib = m_disableMibAndSibStartupTime == Seconds (0) || start <= m_disableMibAndSibStartupTime;
+          if ((mibAndSib && (frame % (m_sibPeriod / 10)) == 1)
+              || (m_drsMessagesEnabled && (frame % (m_drsPeriod / 10)) == 1))
+            {
+              return sixth;
+            }
+        }
+    }
+  return 0;
+}
+
+void
+LteEnbPhy::SkipSubFrames (uint64_t index)
+{
+  uint64_t current = m_nrFrames * 10ULL + m_nrSubFrames - 1;
+  NS_ASSERT (index >= current);
+  if (index == current)
+    {
+      return;
+    }
+  m_nrFrames = index / 10;
+  m_nrSubFrames = index % 10 + 1;
+  Time tti = Seconds (GetTti ());
+  m_ttiBegin += TimeStep (tti.GetTimeStep () * (index - current));
+  // the UL HARQ buffers are shifted once per subframe, and are 8 subframes long
+  for (uint64_t i = current; i < index && i < current + 8; i++)
+    {
+      m_harqPhyModule->SubframeIndication (m_nrFrames, m_nrSubFrames);
+    }
+}
+
+void
+LteEnbPhy::ResumeSubFrames (uint64_t index)
+{
+  NS_LOG_FUNCTION (this << index);
+  NS_ASSERT (m_idle);
+  m_idle = false;
+  SkipSubFrames (index - 1);
+  if (m_nrSubFrames == 10)
+    {
+      StartFrame ();
+    }
+  else
+    {
+      StartSubFrame ();
+    }
+}
+
+void
+LteEnbPhy::DoWakeUp ()
+{
+  m_wokenUp = true;
+  if (!m_idle)
+    {
+      return;
+    }
+  // resume at the start of the next subframe
+  uint64_t current = m_nrFrames * 10ULL + m_nrSubFrames - 1;
+  int64_t tti = Seconds (GetTti ()).GetTimeStep ();
+  int64_t elapsed = (Simulator::Now () - m_ttiBegin).GetTimeStep ();
+  uint64_t next = current + std::max<int64_t> (1, (elapsed + tti - 1) / tti);
+  if (m_resumeSubFrame == 0 || next < m_resumeSubFrame)
+    {
+      NS_LOG_LOGIC ("cell " << m_cellId << " woken up, resume at subframe " << next);
+      m_resumeEvent.Cancel ();
+      m_resumeSubFrame = next;
+      m_resumeEvent = Simulator::Schedule (m_ttiBegin + TimeStep (tti * (next - current)) - Simulator::Now (),
+                                           &LteEnbPhy::ResumeSubFrames, this, next);
+    }
+}
+
 void
 LteEnbPhy::RequestChannelAccess(void)
 {
@@ -1458,6 +1690,14 @@ LteEnbPhy::CreateSrsCqiReport (const SpectrumValue& sinr)
       i++;
     }
   // Insert the user generated the srs as a vendor specific parameter
+  if (m_idle)
+    {
+      // bring the subframe number of the suspended loop to the one of the
+      // SRS, which ends with its subframe
+      int64_t tti = Seconds (GetTti ()).GetTimeStep ();
+      int64_t elapsed = (Simulator::Now () - m_ttiBegin).GetTimeStep ();
+      SkipSubFrames (m_nrFrames * 10ULL + m_nrSubFrames - 1 + (elapsed > 0 ? (elapsed - 1) / tti : 0));
+    }
   // update crrentSrsOffset
   m_currentSrsOffset = (((m_nrFrames-1)*10 + (m_nrSubFrames-1)) % m_srsPeriodicity);
   NS_LOG_DEBUG (this << " ENB RX UL-CQI of " << m_srsUeOffset.at (m_currentSrsOffset));
@@ -1613,6 +1853,7 @@ void
 LteEnbPhy::ReceiveLteUlHarqFeedback (UlInfoListElement_s mes)
 {
   NS_LOG_FUNCTION (this);
+  DoWakeUp ();
   // forward to scheduler
   m_enbPhySapUser->UlInfoListElementHarqFeeback (mes);
 }
@@ -275,6 +275,17 @@ Time GetGrantTimeout() const;
 
   //void TransmitPartialSubFrame (void);
 
+  /**
+   * \brief Start a subframe in the TXOP aware mode, see the
+   * TxopAwareScheduling attribute
+   */
+  void StartTxopAwareSubFrame (void);
+  /**
+   * \return true if nothing is queued yet for the subframe that the MAC
+   * schedules at this subframe
+   */
+  bool IsNextScheduledSubFrameFree (void) const;
+
   /**
    * \brief End a LTE sub frame
    */
@@ -283,6 +294,32 @@ Time GetGrantTimeout() const;
    * \brief End a LTE frame
    */
   void EndFrame (void);
+  /**
+   * \brief Check whether the subframes can be skipped: the MAC has no
+   * data, nothing happened since the start of the subframe, nothing is
+   * queued for transmission or reception and no channel access grant is
+   * held or awaited
+   * \return true if the cell is idle
+   */
+  bool IsIdle (void);
+  /**
+   * \param index the index of a subframe, counted from subframe 1 of frame 0
+   * \return the index of the first subframe from the given one that has
+   * to run even in an idle cell, to send the MIB, the SIB1 or a DRS, or 0
+   * if there is none
+   */
+  uint64_t GetNextMandatorySubFrame (uint64_t index) const;
+  /**
+   * \brief Move the frame and subframe numbers of a suspended subframe loop
+   * to a later subframe, as if the subframes in between had run idle
+   * \param index the index of the subframe
+   */
+  void SkipSubFrames (uint64_t index);
+  /**
+   * \brief Resume the subframe loop suspended while the cell was idle
+   * \param index the index of the subframe to start
+   */
+  void ResumeSubFrames (uint64_t index);
   /*
    * \brief Request channel access from channel access manager.
    */
@@ -394,6 +431,11 @@ private:
   void DoSendMacPdu (Ptr<Packet> p);
   void DoSendLteControlMessage (Ptr<LteControlMessage> msg);
   uint8_t DoGetMacChTtiDelay ();
+  /**
+   * Note that there is something to process in the next subframe, and
+   * resume the subframe loop at the next subframe if it is suspended.
+   */
+  void DoWakeUp ();
 
   /**
    * Add the given RNTI to the list of attached UE #m_ueAttached.
@@ -574,11 +616,30 @@ private:
   bool m_generateCtrlAndRbStats;
   bool m_channelAccessImplWith2msDelay;
   bool m_dropPackets;
+  /**
+   * The `TxopAwareScheduling` attribute. If true, the MAC only schedules
+   * subframes that are free, and the held ones are sent in the next TXOP.
+   */
+  bool m_txopAwareScheduling;
   std::map<Time, double> m_logTimeToRbUsage;
   std::map<int,int> m_ctrlTypesCount;
   int m_ctrMsgCounter;
   Time m_lastDrsMessageSent;
   Time m_channelAccessManagerStartTime;
+
+  /**
+   * The `IdleFastForward` attribute. If true, the subframes of an idle cell
+   * are skipped up to the next MIB, SIB1 or DRS, or to the next activity.
+   */
+  bool m_idleFastForward;
+  /// True while the subframe loop is suspended.
+  bool m_idle;
+  /// True if the MAC has something to process in the next subframe.
+  bool m_wokenUp;
+  /// The index of the subframe at which the suspended loop resumes.
+  uint64_t m_resumeSubFrame;
+  /// The event resuming the suspended loop.
+  EventId m_resumeEvent;
 }; // end of `class LteEnbPhy`
 
 
@@ -217,6 +217,26 @@ bool LtePhy::IsNonEmptyPacketBurst()
     }
 }
 
+bool
+LtePhy::HasQueuedTransmissions (void) const
+{
+  for (uint32_t i = 0; i < m_controlMessagesQueue.size (); i++)
+    {
+      if (!m_controlMessagesQueue.at (i).empty ())
+        {
+          return true;
+        }
+    }
+  for (uint32_t i = 0; i < m_packetBurstQueue.size (); i++)
+    {
+      if (m_packetBurstQueue.at (i)->GetNPackets () > 0)
+        {
+          return true;
+        }
+    }
+  return false;
+}
+
 Ptr<PacketBurst>
 LtePhy::GetPacketBurst (void)
 {
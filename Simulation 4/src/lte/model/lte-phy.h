@@ -168,6 +168,11 @@ public:
    * \returns true if packet ctrl queue contains ctrl messages to be transmitted, otherwise it returns false
    */
   bool IsNonEmptyCtrMessage();
+  /**
+   * \returns true if a control message or a MAC PDU is queued for any of
+   * the coming subframes, otherwise it returns false
+   */
+  bool HasQueuedTransmissions (void) const;
 
   /**
   * \returns the packet burst to be sent
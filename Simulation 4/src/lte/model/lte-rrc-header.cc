@@ -3923,7 +3923,7 @@ RrcConnectionRequestHeader::Print (std::ostream &os) const
 void
 RrcConnectionRequestHeader::PreSerialize () const
 {
-  m_serializationResult = Buffer ();
+  m_serializationResult.clear ();
 
   SerializeUlCcchMessage (1);
 
@@ -3966,6 +3966,7 @@ RrcConnectionRequestHeader::PreSerialize () const
 uint32_t
 RrcConnectionRequestHeader::Deserialize (Buffer::Iterator bIterator)
 {
+  Buffer::Iterator bIteratorStart = bIterator;
   std::bitset<1> dummy;
   std::bitset<0> optionalOrDefaultMask;
   int selectedOption;
@@ -3999,7 +4000,7 @@ RrcConnectionRequestHeader::Deserialize (Buffer::Iterator bIterator)
   // Deserialize spare
   bIterator = DeserializeBitstring (&dummy,bIterator);
 
-  return GetSerializedSize ();
+  return FinalizeDeserialization (bIteratorStart, bIterator);
 }
 
 void
@@ -4052,7 +4053,7 @@ RrcConnectionSetupHeader::Print (std::ostream &os) const
 void
 RrcConnectionSetupHeader::PreSerialize () const
 {
-  m_serializationResult = Buffer ();
+  m_serializationResult.clear ();
 
   SerializeDlCcchMessage (3);
 
@@ -4092,6 +4093,7 @@ RrcConnectionSetupHeader::PreSerialize () const
 uint32_t
 RrcConnectionSetupHeader::Deserialize (Buffer::Iterator bIterator)
 {
+  Buffer::Iterator bIteratorStart = bIterator;
   int n;
 
   std::bitset<0> bitset0;
@@ -4137,18 +4139,17 @@ RrcConnectionSetupHeader::Deserialize (Buffer::Iterator bIterator)
           // Deserialize radioResourceConfigDedicated
           bIterator = DeserializeRadioResourceConfigDedicated (&m_radioResourceConfigDedicated,bIterator);
 
-          if (bitset1[0])
-            {
-              // Deserialize nonCriticalExtension
-              // 2 optional fields, no extension marker.
-              bIterator = DeserializeSequence (&bitset2,false,bIterator);
+          // Deserialize nonCriticalExtension
+          // 2 optional fields, no extension marker.
+          // PreSerialize writes this sequence even if bitset1[0] marks it
+          // absent, so it is always read to consume the whole header.
+          bIterator = DeserializeSequence (&bitset2,false,bIterator);
 
-              // Deserialization of lateR8NonCriticalExtension and nonCriticalExtension
-              // ...
-            }
+          // Deserialization of lateR8NonCriticalExtension and nonCriticalExtension
+          // ...
         }
     }
-  return GetSerializedSize ();
+  return FinalizeDeserialization (bIteratorStart, bIterator);
 }
 
 void
@@ -4223,7 +4224,7 @@ RrcConnectionSetupCompleteHeader::~RrcConnectionSetupCompleteHeader ()
 void
 RrcConnectionSetupCompleteHeader::PreSerialize () const
 {
-  m_serializationResult = Buffer ();
+  m_serializationResult.clear ();
 
   // Serialize DCCH message
   SerializeUlDcchMessage (4);
@@ -4252,6 +4253,7 @@ RrcConnectionSetupCompleteHeader::PreSerialize () const
 uint32_t
 RrcConnectionSetupCompleteHeader::Deserialize (Buffer::Iterator bIterator)
 {
+  Buffer::Iterator bIteratorStart = bIterator;
   std::bitset<0> bitset0;
 
   bIterator = DeserializeUlDcchMessage (bIterator);
@@ -4286,7 +4288,7 @@ RrcConnectionSetupCompleteHeader::Deserialize (Buffer::Iterator bIterator)
         }
     }
 
-  return GetSerializedSize ();
+  return FinalizeDeserialization (bIteratorStart, bIterator);
 }
 
 void
@@ -4329,7 +4331,7 @@ RrcConnectionReconfigurationCompleteHeader::~RrcConnectionReconfigurationComplet
 void
 RrcConnectionReconfigurationCompleteHeader::PreSerialize () const
 {
-  m_serializationResult = Buffer ();
+  m_serializationResult.clear ();
 
   // Serialize DCCH message
   SerializeUlDcchMessage (2);
@@ -4355,6 +4357,7 @@ RrcConnectionReconfigurationCompleteHeader::PreSerialize () const
 uint32_t
 RrcConnectionReconfigurationCompleteHeader::Deserialize (Buffer::Iterator bIterator)
 {
+  Buffer::Iterator bIteratorStart = bIterator;
   std::bitset<0> bitset0;
   int n;
 
@@ -4377,7 +4380,7 @@ RrcConnectionReconfigurationCompleteHeader::Deserialize (Buffer::Iterator bItera
       // ...
     }
 
-  return GetSerializedSize ();
+  return FinalizeDeserialization (bIteratorStart, bIterator);
 }
 
 void
@@ -4420,7 +4423,7 @@ RrcConnectionReconfigurationHeader::~RrcConnectionReconfigurationHeader ()
 void
 RrcConnectionReconfigurationHeader::PreSerialize () const
 {
-  m_serializationResult = Buffer ();
+  m_serializationResult.clear ();
 
   SerializeDlDcchMessage (4);
 
@@ -4562,6 +4565,7 @@ RrcConnectionReconfigurationHeader::PreSerialize () const
 uint32_t
 RrcConnectionReconfigurationHeader::Deserialize (Buffer::Iterator bIterator)
 {
+  Buffer::Iterator bIteratorStart = bIterator;
   std::bitset<0> bitset0;
 
   bIterator = DeserializeDlDcchMessage (bIterator);
@@ -4749,7 +4753,7 @@ RrcConnectionReconfigurationHeader::Deserialize (Buffer::Iterator bIterator)
         }
     }
 
-  return GetSerializedSize ();
+  return FinalizeDeserialization (bIteratorStart, bIterator);
 }
 
 void
@@ -5101,7 +5105,7 @@ HandoverPreparationInfoHeader::HandoverPreparationInfoHeader ()
 void
 HandoverPreparationInfoHeader::PreSerialize () const
 {
-  m_serializationResult = Buffer ();
+  m_serializationResult.clear ();
 
   // Serialize HandoverPreparationInformation sequence:
   // no default or optional fields. Extension marker not present.
@@ -5175,6 +5179,7 @@ HandoverPreparationInfoHeader::PreSerialize () const
 uint32_t
 HandoverPreparationInfoHeader::Deserialize (Buffer::Iterator bIterator)
 {
+  Buffer::Iterator bIteratorStart = bIterator;
   std::bitset<0> bitset0;
   int n;
 
@@ -5285,7 +5290,7 @@ HandoverPreparationInfoHeader::Deserialize (Buffer::Iterator bIterator)
         }
     }
 
-  return GetSerializedSize ();
+  return FinalizeDeserialization (bIteratorStart, bIterator);
 }
 
 void
@@ -5337,7 +5342,7 @@ RrcConnectionReestablishmentRequestHeader::~RrcConnectionReestablishmentRequestH
 void
 RrcConnectionReestablishmentRequestHeader::PreSerialize () const
 {
-  m_serializationResult = Buffer ();
+  m_serializationResult.clear ();
 
   SerializeUlCcchMessage (0);
 
@@ -5388,6 +5393,7 @@ RrcConnectionReestablishmentRequestHeader::PreSerialize () const
 uint32_t
 RrcConnectionReestablishmentRequestHeader::Deserialize (Buffer::Iterator bIterator)
 {
+  Buffer::Iterator bIteratorStart = bIterator;
   std::bitset<0> bitset0;
   int n;
 
@@ -5449,7 +5455,7 @@ RrcConnectionReestablishmentRequestHeader::Deserialize (Buffer::Iterator bIterat
       bIterator = DeserializeBitstring (&spare,bIterator);
     }
 
-  return GetSerializedSize ();
+  return FinalizeDeserialization (bIteratorStart, bIterator);
 }
 
 void
@@ -5503,7 +5509,7 @@ RrcConnectionReestablishmentHeader::~RrcConnectionReestablishmentHeader ()
 void
 RrcConnectionReestablishmentHeader::PreSerialize () const
 {
-  m_serializationResult = Buffer ();
+  m_serializationResult.clear ();
 
   SerializeDlCcchMessage (0);
 
@@ -5537,6 +5543,7 @@ RrcConnectionReestablishmentHeader::PreSerialize () const
 uint32_t
 RrcConnectionReestablishmentHeader::Deserialize (Buffer::Iterator bIterator)
 {
+  Buffer::Iterator bIteratorStart = bIterator;
   std::bitset<0> bitset0;
   int n;
 
@@ -5582,7 +5589,7 @@ RrcConnectionReestablishmentHeader::Deserialize (Buffer::Iterator bIterator)
         }
     }
 
-  return GetSerializedSize ();
+  return FinalizeDeserialization (bIteratorStart, bIterator);
 }
 
 void
@@ -5631,7 +5638,7 @@ RrcConnectionReestablishmentCompleteHeader::RrcConnectionReestablishmentComplete
 void
 RrcConnectionReestablishmentCompleteHeader::PreSerialize () const
 {
-  m_serializationResult = Buffer ();
+  m_serializationResult.clear ();
 
   // Serialize DCCH message
   SerializeUlDcchMessage (3);
@@ -5657,6 +5664,7 @@ RrcConnectionReestablishmentCompleteHeader::PreSerialize () const
 uint32_t
 RrcConnectionReestablishmentCompleteHeader::Deserialize (Buffer::Iterator bIterator)
 {
+  Buffer::Iterator bIteratorStart = bIterator;
   std::bitset<0> bitset0;
   int n;
 
@@ -5690,7 +5698,7 @@ RrcConnectionReestablishmentCompleteHeader::Deserialize (Buffer::Iterator bItera
         }
     }
 
-  return GetSerializedSize ();
+  return FinalizeDeserialization (bIteratorStart, bIterator);
 }
 
 void
@@ -5733,7 +5741,7 @@ RrcConnectionReestablishmentRejectHeader::~RrcConnectionReestablishmentRejectHea
 void
 RrcConnectionReestablishmentRejectHeader::PreSerialize () const
 {
-  m_serializationResult = Buffer ();
+  m_serializationResult.clear ();
 
   // Serialize CCCH message
   SerializeDlCcchMessage (1);
@@ -5756,6 +5764,7 @@ RrcConnectionReestablishmentRejectHeader::PreSerialize () const
 uint32_t
 RrcConnectionReestablishmentRejectHeader::Deserialize (Buffer::Iterator bIterator)
 {
+  Buffer::Iterator bIteratorStart = bIterator;
   std::bitset<0> bitset0;
 
   bIterator = DeserializeDlCcchMessage (bIterator);
@@ -5784,7 +5793,7 @@ RrcConnectionReestablishmentRejectHeader::Deserialize (Buffer::Iterator bIterato
         }
     }
 
-  return GetSerializedSize ();
+  return FinalizeDeserialization (bIteratorStart, bIterator);
 }
 
 void
@@ -5818,7 +5827,7 @@ RrcConnectionReleaseHeader::~RrcConnectionReleaseHeader ()
 void
 RrcConnectionReleaseHeader::PreSerialize () const
 {
-  m_serializationResult = Buffer ();
+  m_serializationResult.clear ();
 
   // Serialize DCCH message
   SerializeDlDcchMessage (5);
@@ -5850,6 +5859,7 @@ RrcConnectionReleaseHeader::PreSerialize () const
 uint32_t
 RrcConnectionReleaseHeader::Deserialize (Buffer::Iterator bIterator)
 {
+  Buffer::Iterator bIteratorStart = bIterator;
   std::bitset<0> bitset0;
   int n;
 
@@ -5909,7 +5919,7 @@ RrcConnectionReleaseHeader::Deserialize (Buffer::Iterator bIterator)
         }
     }
 
-  return GetSerializedSize ();
+  return FinalizeDeserialization (bIteratorStart, bIterator);
 }
 
 void
@@ -5943,7 +5953,7 @@ RrcConnectionRejectHeader::~RrcConnectionRejectHeader ()
 void
 RrcConnectionRejectHeader::PreSerialize () const
 {
-  m_serializationResult = Buffer ();
+  m_serializationResult.clear ();
 
   // Serialize CCCH message
   SerializeDlCcchMessage (2);
@@ -5972,6 +5982,7 @@ RrcConnectionRejectHeader::PreSerialize () const
 uint32_t
 RrcConnectionRejectHeader::Deserialize (Buffer::Iterator bIterator)
 {
+  Buffer::Iterator bIteratorStart = bIterator;
   std::bitset<0> bitset0;
   int n;
 
@@ -6016,7 +6027,7 @@ RrcConnectionRejectHeader::Deserialize (Buffer::Iterator bIterator)
         }
     }
 
-  return GetSerializedSize ();
+  return FinalizeDeserialization (bIteratorStart, bIterator);
 }
 
 void
@@ -6051,7 +6062,7 @@ MeasurementReportHeader::~MeasurementReportHeader ()
 void
 MeasurementReportHeader::PreSerialize () const
 {
-  m_serializationResult = Buffer ();
+  m_serializationResult.clear ();
 
   // Serialize DCCH message
   SerializeUlDcchMessage (1);
@@ -6082,6 +6093,7 @@ MeasurementReportHeader::PreSerialize () const
 uint32_t
 MeasurementReportHeader::Deserialize (Buffer::Iterator bIterator)
 {
+  Buffer::Iterator bIteratorStart = bIterator;
   std::bitset<0> bitset0;
 
   bIterator = DeserializeSequence (&bitset0,false,bIterator);
@@ -6124,7 +6136,7 @@ MeasurementReportHeader::Deserialize (Buffer::Iterator bIterator)
         }
     }
 
-  return GetSerializedSize ();
+  return FinalizeDeserialization (bIteratorStart, bIterator);
 }
 
 void
@@ -153,6 +153,7 @@ public:
   virtual void ReceivePhyPdu (Ptr<Packet> p);
   virtual void SubframeIndication (uint32_t frameNo, uint32_t subframeNo);
   virtual void ReceiveLteControlMessage (Ptr<LteControlMessage> msg);
+  virtual bool IsIdle (void);
 
 private:
   LteUeMac* m_mac;
@@ -182,6 +183,12 @@ UeMemberLteUePhySapUser::ReceiveLteControlMessage (Ptr<LteControlMessage> msg)
   m_mac->DoReceiveLteControlMessage (msg);
 }
 
+bool
+UeMemberLteUePhySapUser::IsIdle (void)
+{
+  return m_mac->DoIsIdle ();
+}
+
 
 
 
@@ -308,6 +315,7 @@ LteUeMac::DoReportBufferStatus (LteMacSapProvider::ReportBufferStatusParameters
       m_ulBsrReceived.insert (std::pair<uint8_t, LteMacSapProvider::ReportBufferStatusParameters> (params.lcid, params));
     }
   m_freshUlBsr = true;
+  m_uePhySapProvider->WakeUp ();
 }
 
 
@@ -385,7 +393,11 @@ LteUeMac::SendRaPreamble (bool contention)
   // the RACH preamble is sent on 6RB bandwidth so the uplink
   // bandwidth does not need to be configured. 
   NS_ASSERT (m_subframeNo > 0); // sanity check for subframe starting at 1
-  m_raRnti = m_subframeNo - 1;
+  // count the subframes skipped by an idle PHY since the last indication
+  int64_t tti = Seconds (m_uePhySapProvider->GetTti ()).GetTimeStep ();
+  int64_t elapsed = (Simulator::Now () - m_subframeTime).GetTimeStep ();
+  uint32_t skipped = (elapsed > 0) ? (elapsed - 1) / tti : 0;
+  m_raRnti = (m_subframeNo - 1 + skipped) % 10;
   m_uePhySapProvider->SendRachPreamble (m_raPreambleId, m_raRnti);
   NS_LOG_INFO (this << " sent preamble id " << (uint32_t) m_raPreambleId << ", RA-RNTI " << (uint32_t) m_raRnti);
   // 3GPP 36.321 5.1.4 
@@ -777,6 +789,7 @@ LteUeMac::DoSubframeIndication (uint32_t frameNo, uint32_t subframeNo)
   NS_LOG_FUNCTION (this);
   m_frameNo = frameNo;
   m_subframeNo = subframeNo;
+  m_subframeTime = Simulator::Now ();
   RefreshHarqProcessesPacketBuffer ();
   if ((Simulator::Now () >= m_bsrLast + m_bsrPeriodicity) && (m_freshUlBsr == true))
     {
@@ -787,6 +800,24 @@ LteUeMac::DoSubframeIndication (uint32_t frameNo, uint32_t subframeNo)
     }
 }
 
+bool
+LteUeMac::DoIsIdle (void) const
+{
+  if (m_freshUlBsr || m_noRaResponseReceivedEvent.IsRunning ())
+    {
+      return false;
+    }
+  for (uint16_t i = 0; i < m_miUlHarqProcessesPacketTimer.size (); i++)
+    {
+      if (m_miUlHarqProcessesPacketTimer.at (i) > 0
+          || m_miUlHarqProcessesPacket.at (i)->GetNPackets () > 0)
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
 int64_t
 LteUeMac::AssignStreams (int64_t stream)
 {
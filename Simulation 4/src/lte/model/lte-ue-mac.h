@@ -103,6 +103,7 @@ private:
   // forwarded from PHY SAP
   void DoReceivePhyPdu (Ptr<Packet> p);
   void DoReceiveLteControlMessage (Ptr<LteControlMessage> msg);
+  bool DoIsIdle (void) const;
   
   // internal methods
   void RandomlySelectAndSendRaPreamble ();
@@ -155,6 +156,7 @@ private:
 
   uint32_t m_frameNo;
   uint32_t m_subframeNo;
+  Time m_subframeTime; // start time of the last subframe indicated by the PHY
   uint8_t m_raRnti;
   bool m_waitingForRaResponse;
 };
@@ -60,6 +60,19 @@ public:
    */
   virtual void SendRachPreamble (uint32_t prachId, uint32_t raRnti) = 0;
 
+  /**
+   * \brief Notify the PHY that the MAC has new work, such as a change of
+   * the RLC buffer status, so that a subframe loop suspended while the
+   * UE is idle resumes at the next subframe
+   */
+  virtual void WakeUp () = 0;
+
+  /**
+   * \brief Get the length of a subframe of the PHY
+   * \return the TTI in seconds
+   */
+  virtual double GetTti (void) = 0;
+
 };
 
 
@@ -95,6 +108,14 @@ public:
   */
   virtual void ReceiveLteControlMessage (Ptr<LteControlMessage> msg) = 0;
 
+  /**
+   * \brief Ask the MAC whether it can skip the coming subframes, i.e. it
+   * has no BSR to send, no random access in progress and no packets in
+   * its UL HARQ buffers
+   * \return true if the MAC is idle
+   */
+  virtual bool IsIdle (void) = 0;
+
 };
 
 
@@ -80,6 +80,8 @@ public:
   virtual void SendMacPdu (Ptr<Packet> p);
   virtual void SendLteControlMessage (Ptr<LteControlMessage> msg);
   virtual void SendRachPreamble (uint32_t prachId, uint32_t raRnti);
+  virtual void WakeUp ();
+  virtual double GetTti (void);
 
 private:
   LteUePhy* m_phy;
@@ -108,6 +110,18 @@ UeMemberLteUePhySapProvider::SendRachPreamble (uint32_t prachId, uint32_t raRnti
   m_phy->DoSendRachPreamble (prachId, raRnti);
 }
 
+void
+UeMemberLteUePhySapProvider::WakeUp ()
+{
+  m_phy->DoWakeUp ();
+}
+
+double
+UeMemberLteUePhySapProvider::GetTti (void)
+{
+  return m_phy->GetTti ();
+}
+
 
 ////////////////////////////////////////
 // LteUePhy methods
@@ -153,7 +167,11 @@ LteUePhy::LteUePhy (Ptr<LteSpectrumPhy> dlPhy, Ptr<LteSpectrumPhy> ulPhy)
     m_pssReceived (false),
     m_ueMeasurementsFilterPeriod (MilliSeconds (200)),
     m_ueMeasurementsFilterLast (MilliSeconds (0)),
-    m_rsrpSinrSampleCounter (0)
+    m_rsrpSinrSampleCounter (0),
+    m_idle (false),
+    m_wokenUp (false),
+    m_idleSubFrame (0),
+    m_resumeSubFrame (0)
 {
   m_amc = CreateObject <LteAmc> ();
   m_powerControl = CreateObject <LteUePowerControl> ();
@@ -178,6 +196,7 @@ void
 LteUePhy::DoDispose ()
 {
   NS_LOG_FUNCTION (this);
+  m_resumeEvent.Cancel ();
   delete m_uePhySapProvider;
   delete m_ueCphySapProvider;
   LtePhy::DoDispose ();
@@ -294,6 +313,15 @@ LteUePhy::GetTypeId (void)
                    BooleanValue (true),
                    MakeBooleanAccessor (&LteUePhy::m_enableUplinkPowerControl),
                    MakeBooleanChecker ())
+    .AddAttribute ("IdleFastForward",
+                   "If true, skip the subframes of an idle UE up to the next SRS, "
+                   "or until the MAC or the eNB has something for it. "
+                   "The frame and subframe numbers are kept. The timers of the RRC are "
+                   "not wake-up sources: they expire on time, but the subframes that "
+                   "follow are skipped unless the expiry gives the MAC something to send.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&LteUePhy::m_idleFastForward),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
@@ -412,6 +440,7 @@ LteUePhy::DoSendMacPdu (Ptr<Packet> p)
 {
   NS_LOG_FUNCTION (this);
 
+  DoWakeUp ();
   SetMacPdu (p);
 }
 
@@ -549,25 +578,25 @@ LteUePhy::GenerateCqiRsrpRsrq (const SpectrumValue& sinr)
       // measure instantaneous RSRQ now
       NS_ASSERT_MSG (m_rsInterferencePowerUpdated, " RS interference power info obsolete");
 
+      // the RSSI is the same for all the PSS
+      uint16_t rbNum = 0;
+      double rssiSum = 0.0;
+      Values::const_iterator itIntN = m_rsInterferencePower.ConstValuesBegin ();
+      Values::const_iterator itPj = m_rsReceivedPower.ConstValuesBegin ();
+      for (itPj = m_rsReceivedPower.ConstValuesBegin ();
+           itPj != m_rsReceivedPower.ConstValuesEnd ();
+           itIntN++, itPj++)
+        {
+          rbNum++;
+          // convert PSD [W/Hz] to linear power [W] for the single RE
+          double interfPlusNoisePowerTxW = ((*itIntN) * 180000.0) / 12.0;
+          double signalPowerTxW = ((*itPj) * 180000.0) / 12.0;
+          rssiSum += (2 * (interfPlusNoisePowerTxW + signalPowerTxW));
+        }
+
       std::list <PssElement>::iterator itPss = m_pssList.begin ();
       while (itPss != m_pssList.end ())
         {
-          uint16_t rbNum = 0;
-          double rssiSum = 0.0;
-
-          Values::const_iterator itIntN = m_rsInterferencePower.ConstValuesBegin ();
-          Values::const_iterator itPj = m_rsReceivedPower.ConstValuesBegin ();
-          for (itPj = m_rsReceivedPower.ConstValuesBegin ();
-               itPj != m_rsReceivedPower.ConstValuesEnd ();
-               itIntN++, itPj++)
-            {
-              rbNum++;
-              // convert PSD [W/Hz] to linear power [W] for the single RE
-              double interfPlusNoisePowerTxW = ((*itIntN) * 180000.0) / 12.0;
-              double signalPowerTxW = ((*itPj) * 180000.0) / 12.0;
-              rssiSum += (2 * (interfPlusNoisePowerTxW + signalPowerTxW));
-            }
-
           NS_ASSERT (rbNum == (*itPss).nRB);
           double rsrq_dB = 10 * log10 ((*itPss).pssPsdSum / rssiSum);
 
@@ -841,6 +870,7 @@ LteUePhy::DoSendLteControlMessage (Ptr<LteControlMessage> msg)
 {
   NS_LOG_FUNCTION (this << msg);
 
+  DoWakeUp ();
   SetControlMessages (msg);
 }
 
@@ -854,6 +884,7 @@ LteUePhy::DoSendRachPreamble (uint32_t raPreambleId, uint32_t raRnti)
   msg->SetRapId (raPreambleId);
   m_raPreambleId = raPreambleId;
   m_raRnti = raRnti;
+  DoWakeUp ();
   m_controlMessagesQueue.at (0).push_back (msg);
 }
 
@@ -1067,6 +1098,7 @@ LteUePhy::ReceivePss (uint16_t cellId, Ptr<SpectrumValue> p)
 void
 LteUePhy::QueueSubChannelsForTransmission (std::vector <int> rbMap)
 {
+  DoWakeUp ();
   m_subChannelsForTransmissionQueue.at (m_macChTtiDelay - 1) = rbMap;
 }
 
@@ -1083,6 +1115,29 @@ LteUePhy::SubframeIndication (uint32_t frameNo, uint32_t subframeNo)
   m_rsInterferencePowerUpdated = false;
   m_pssReceived = false;
 
+  if (m_idleFastForward && IsIdle ())
+    {
+      uint64_t index = (frameNo - 1) * 10ULL + subframeNo - 1;
+      uint64_t resume = GetNextMandatorySubFrame (index);
+      if (resume != index)
+        {
+          // suspend the subframe loop until the next SRS, or until woken up
+          NS_LOG_LOGIC ("UE " << m_rnti << " idle, resume at subframe " << resume);
+          m_idle = true;
+          m_idleSubFrame = index;
+          m_idleStart = Simulator::Now ();
+          m_resumeSubFrame = resume;
+          if (resume != 0)
+            {
+              Time tti = Seconds (GetTti ());
+              m_resumeEvent = Simulator::Schedule (TimeStep (tti.GetTimeStep () * (resume - index)),
+                                                   &LteUePhy::ResumeSubFrames, this, resume);
+            }
+          return;
+        }
+    }
+  m_wokenUp = false;
+
   if (m_ulConfigured)
     {
       // update uplink transmission mask according to previous UL-CQIs
@@ -1162,6 +1217,64 @@ LteUePhy::SubframeIndication (uint32_t frameNo, uint32_t subframeNo)
 }
 
 
+bool
+LteUePhy::IsIdle (void)
+{
+  if (m_wokenUp || HasQueuedTransmissions ())
+    {
+      return false;
+    }
+  for (uint32_t i = 0; i < m_subChannelsForTransmissionQueue.size (); i++)
+    {
+      if (!m_subChannelsForTransmissionQueue.at (i).empty ())
+        {
+          return false;
+        }
+    }
+  return m_uePhySapUser->IsIdle ();
+}
+
+uint64_t
+LteUePhy::GetNextMandatorySubFrame (uint64_t index) const
+{
+  if (!m_ulConfigured || !m_srsConfigured || m_srsPeriodicity == 0)
+    {
+      return 0;
+    }
+  return index + (m_srsSubframeOffset + m_srsPeriodicity - index % m_srsPeriodicity) % m_srsPeriodicity;
+}
+
+void
+LteUePhy::ResumeSubFrames (uint64_t index)
+{
+  NS_LOG_FUNCTION (this << index);
+  NS_ASSERT (m_idle);
+  m_idle = false;
+  SubframeIndication (index / 10 + 1, index % 10 + 1);
+}
+
+void
+LteUePhy::DoWakeUp ()
+{
+  m_wokenUp = true;
+  if (!m_idle)
+    {
+      return;
+    }
+  // resume at the start of the next subframe
+  int64_t tti = Seconds (GetTti ()).GetTimeStep ();
+  int64_t elapsed = (Simulator::Now () - m_idleStart).GetTimeStep ();
+  uint64_t next = m_idleSubFrame + (elapsed + tti - 1) / tti;
+  if (m_resumeSubFrame == 0 || next < m_resumeSubFrame)
+    {
+      NS_LOG_LOGIC ("UE " << m_rnti << " woken up, resume at subframe " << next);
+      m_resumeEvent.Cancel ();
+      m_resumeSubFrame = next;
+      m_resumeEvent = Simulator::Schedule (m_idleStart + TimeStep (tti * (next - m_idleSubFrame)) - Simulator::Now (),
+                                           &LteUePhy::ResumeSubFrames, this, next);
+    }
+}
+
 void
 LteUePhy::SendSrs ()
 {
@@ -1298,6 +1411,7 @@ LteUePhy::DoConfigureUplink (uint32_t ulEarfcn, uint8_t ulBandwidth)
   m_ulEarfcn = ulEarfcn;
   m_ulBandwidth = ulBandwidth;
   m_ulConfigured = true;
+  DoWakeUp ();
 }
 
 void
@@ -1337,6 +1451,8 @@ LteUePhy::DoSetSrsConfigurationIndex (uint16_t srcCi)
   // if we use a static one, we can have a 0ms guard time
   m_srsStartTime = Simulator::Now () + MilliSeconds (0);
   NS_LOG_DEBUG (this << " UE SRS P " << m_srsPeriodicity << " RNTI " << m_rnti << " offset " << m_srsSubframeOffset << " cellId " << m_cellId << " CI " << srcCi);
+  // resume to find the next SRS with the new configuration
+  DoWakeUp ();
 }
 
 void
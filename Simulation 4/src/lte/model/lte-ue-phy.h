@@ -283,6 +283,25 @@ private:
 
   void QueueSubChannelsForTransmission (std::vector <int> rbMap);
 
+  /**
+   * \brief Check whether the subframes can be skipped: the MAC is idle,
+   * nothing happened since the start of the last subframe and nothing is
+   * queued for transmission
+   * \return true if the UE is idle
+   */
+  bool IsIdle (void);
+  /**
+   * \param index the index of a subframe, counted from subframe 1 of frame 1
+   * \return the index of the first subframe from the given one that has
+   * to run even in an idle UE, to send the SRS, or 0 if there is none
+   */
+  uint64_t GetNextMandatorySubFrame (uint64_t index) const;
+  /**
+   * \brief Resume the subframe loop suspended while the UE was idle
+   * \param index the index of the subframe to start
+   */
+  void ResumeSubFrames (uint64_t index);
+
 
   /** 
    * internal method that takes care of generating CQI reports,
@@ -325,6 +344,11 @@ private:
   virtual void DoSendMacPdu (Ptr<Packet> p);
   virtual void DoSendLteControlMessage (Ptr<LteControlMessage> msg);
   virtual void DoSendRachPreamble (uint32_t prachId, uint32_t raRnti);
+  /**
+   * Note that there is something to process in the next subframe, and
+   * resume the subframe loop at the next subframe if it is suspended.
+   */
+  void DoWakeUp ();
 
   /// A list of sub channels to use in TX.
   std::vector <int> m_subChannelsForTransmission;
@@ -473,6 +497,24 @@ private:
   Ptr<SpectrumValue> m_noisePsd; ///< Noise power spectral density for
                                  ///the configured bandwidth 
 
+  /**
+   * The `IdleFastForward` attribute. If true, the subframes of an idle UE
+   * are skipped up to the next SRS, or to the next activity.
+   */
+  bool m_idleFastForward;
+  /// True while the subframe loop is suspended.
+  bool m_idle;
+  /// True if there is something to process in the next subframe.
+  bool m_wokenUp;
+  /// The index of the first subframe skipped by the suspended loop.
+  uint64_t m_idleSubFrame;
+  /// The start time of the first subframe skipped by the suspended loop.
+  Time m_idleStart;
+  /// The index of the subframe at which the suspended loop resumes.
+  uint64_t m_resumeSubFrame;
+  /// The event resuming the suspended loop.
+  EventId m_resumeEvent;
+
 }; // end of `class LteUePhy`
 
 
@@ -0,0 +1,428 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef RNTI_MAP_H
+#define RNTI_MAP_H
+
+#include <stdint.h>
+#include <cstddef>
+#include <iterator>
+#include <utility>
+#include <vector>
+#include <ns3/assert.h>
+
+namespace ns3 {
+
+/**
+ * \ingroup lte
+ *
+ * A table of per-UE state keyed by RNTI, with the interface of the
+ * std::map it replaces in the MAC schedulers.
+ *
+ * The entries are stored in a contiguous array sorted by RNTI, and an
+ * array indexed by RNTI gives the position of each entry, so that a
+ * lookup is a single indexed load and an iteration is a linear scan in
+ * the order of the std::map.
+ *
+ * An erased entry is only marked as such: it keeps its position, which
+ * is reused when the RNTI is inserted again, as happens at every expiry
+ * and refresh of the CQI of a UE.  The marked entries are dropped when
+ * they outnumber the others and a new RNTI is inserted.
+ *
+ * As with a std::map, erasing an entry does not invalidate the
+ * iterators to the others.  Unlike with a std::map, inserting an RNTI
+ * without a position may move the entries, and so invalidates the
+ * iterators and the references to the states.
+ */
+template <class T>
+class RntiMap
+{
+public:
+  /// The type of the RNTIs
+  typedef uint16_t key_type;
+  /// The type of the per-UE state
+  typedef T mapped_type;
+  /// The type of the entries
+  typedef std::pair<uint16_t, T> value_type;
+  /// The type of the sizes
+  typedef std::size_t size_type;
+
+  /**
+   * An iterator over the entries, which skips the erased ones
+   */
+  template <class M, class V>
+  class Iterator
+  {
+public:
+    typedef std::bidirectional_iterator_tag iterator_category; ///< iterator category
+    typedef typename RntiMap::value_type value_type;            ///< entry type
+    typedef std::ptrdiff_t difference_type;                     ///< distance type
+    typedef V * pointer;                                        ///< pointer to an entry
+    typedef V & reference;                                      ///< reference to an entry
+
+    Iterator ()
+      : m_map (0),
+        m_pos (0)
+    {
+    }
+    /**
+     * \param map the table
+     * \param pos the position of the entry
+     */
+    Iterator (M *map, std::size_t pos)
+      : m_map (map),
+        m_pos (pos)
+    {
+    }
+    /**
+     * Conversion of an iterator to a const iterator
+     * \param o the iterator
+     */
+    template <class M2, class V2>
+    Iterator (const Iterator<M2, V2> &o)
+      : m_map (o.m_map),
+        m_pos (o.m_pos)
+    {
+    }
+    /// \return the entry
+    V & operator* () const
+    {
+      return m_map->m_entries[m_pos];
+    }
+    /// \return the entry
+    V * operator-> () const
+    {
+      return &m_map->m_entries[m_pos];
+    }
+    /// \return the iterator to the next entry
+    Iterator & operator++ ()
+    {
+      m_pos = m_map->Next (m_pos + 1);
+      return *this;
+    }
+    /// \return the iterator before the increment
+    Iterator operator++ (int)
+    {
+      Iterator tmp = *this;
+      ++*this;
+      return tmp;
+    }
+    /// \return the iterator to the previous entry
+    Iterator & operator-- ()
+    {
+      m_pos = m_map->Previous (m_pos);
+      return *this;
+    }
+    /// \return the iterator before the decrement
+    Iterator operator-- (int)
+    {
+      Iterator tmp = *this;
+      --*this;
+      return tmp;
+    }
+    /**
+     * \param o another iterator
+     * \return whether both iterators point to the same entry
+     */
+    template <class M2, class V2>
+    bool operator== (const Iterator<M2, V2> &o) const
+    {
+      return m_pos == o.m_pos;
+    }
+    /**
+     * \param o another iterator
+     * \return whether the iterators point to different entries
+     */
+    template <class M2, class V2>
+    bool operator!= (const Iterator<M2, V2> &o) const
+    {
+      return m_pos != o.m_pos;
+    }
+
+    M *m_map;          ///< the table
+    std::size_t m_pos; ///< the position of the entry
+  };
+
+  /// An iterator over the entries
+  typedef Iterator<RntiMap, value_type> iterator;
+  /// A const iterator over the entries
+  typedef Iterator<const RntiMap, const value_type> const_iterator;
+
+  RntiMap ()
+    : m_size (0)
+  {
+  }
+
+  /// \return an iterator to the entry of the lowest RNTI
+  iterator begin ()
+  {
+    return iterator (this, Next (0));
+  }
+  /// \return an iterator past the last entry
+  iterator end ()
+  {
+    return iterator (this, m_entries.size ());
+  }
+  /// \return an iterator to the entry of the lowest RNTI
+  const_iterator begin () const
+  {
+    return const_iterator (this, Next (0));
+  }
+  /// \return an iterator past the last entry
+  const_iterator end () const
+  {
+    return const_iterator (this, m_entries.size ());
+  }
+
+  /// \return the number of entries
+  size_type size () const
+  {
+    return m_size;
+  }
+  /// \return whether the table is empty
+  bool empty () const
+  {
+    return m_size == 0;
+  }
+
+  /**
+   * \param rnti the RNTI
+   * \return an iterator to the entry of the RNTI, or end () if there is none
+   */
+  iterator find (uint16_t rnti)
+  {
+    return iterator (this, Find (rnti));
+  }
+  /**
+   * \param rnti the RNTI
+   * \return an iterator to the entry of the RNTI, or end () if there is none
+   */
+  const_iterator find (uint16_t rnti) const
+  {
+    return const_iterator (this, Find (rnti));
+  }
+  /**
+   * \param rnti the RNTI
+   * \return 1 if the RNTI has an entry, 0 otherwise
+   */
+  size_type count (uint16_t rnti) const
+  {
+    return Find (rnti) != m_entries.size () ? 1 : 0;
+  }
+
+  /**
+   * Insert an entry, unless the RNTI already has one
+   * \param entry the RNTI and the state, e.g. a std::pair of types
+   *        convertible to those of the table
+   * \return an iterator to the entry of the RNTI, and whether the entry
+   *         was inserted
+   */
+  template <class P>
+  std::pair<iterator, bool> insert (const P &entry)
+  {
+    std::size_t pos = Find (entry.first);
+    if (pos != m_entries.size ())
+      {
+        return std::make_pair (iterator (this, pos), false);
+      }
+    pos = Insert (entry.first);
+    m_entries[pos].second = entry.second;
+    return std::make_pair (iterator (this, pos), true);
+  }
+
+  /**
+   * \param rnti the RNTI
+   * \return the state of the RNTI, which is default constructed if the
+   *         RNTI has no entry
+   */
+  T & operator[] (uint16_t rnti)
+  {
+    std::size_t pos = Find (rnti);
+    if (pos == m_entries.size ())
+      {
+        pos = Insert (rnti);
+      }
+    return m_entries[pos].second;
+  }
+
+  /**
+   * \param it an iterator to an entry
+   */
+  void erase (iterator it)
+  {
+    Erase (it.m_pos);
+  }
+  /**
+   * \param rnti the RNTI
+   * \return the number of entries erased
+   */
+  size_type erase (uint16_t rnti)
+  {
+    std::size_t pos = Find (rnti);
+    if (pos == m_entries.size ())
+      {
+        return 0;
+      }
+    Erase (pos);
+    return 1;
+  }
+
+  /// Erase all the entries
+  void clear ()
+  {
+    m_entries.clear ();
+    m_live.clear ();
+    m_index.clear ();
+    m_size = 0;
+  }
+
+private:
+  /**
+   * \param rnti the RNTI
+   * \return the position of the entry of the RNTI, or the number of
+   *         positions if there is none
+   */
+  std::size_t Find (uint16_t rnti) const
+  {
+    if (rnti < m_index.size ())
+      {
+        uint32_t pos = m_index[rnti];
+        if (pos != 0 && m_live[pos - 1])
+          {
+            return pos - 1;
+          }
+      }
+    return m_entries.size ();
+  }
+
+  /**
+   * \param pos a position
+   * \return the first position of an entry from pos, or the number of
+   *         positions if there is none
+   */
+  std::size_t Next (std::size_t pos) const
+  {
+    while (pos < m_live.size () && !m_live[pos])
+      {
+        ++pos;
+      }
+    return pos;
+  }
+
+  /**
+   * \param pos a position
+   * \return the last position of an entry before pos
+   */
+  std::size_t Previous (std::size_t pos) const
+  {
+    do
+      {
+        NS_ASSERT_MSG (pos > 0, "decrement of the first entry");
+        --pos;
+      }
+    while (!m_live[pos]);
+    return pos;
+  }
+
+  /**
+   * Add an entry with a default state for an RNTI without one
+   * \param rnti the RNTI
+   * \return the position of the entry
+   */
+  std::size_t Insert (uint16_t rnti)
+  {
+    ++m_size;
+    if (rnti < m_index.size () && m_index[rnti] != 0)
+      {
+        // the position left by an erased entry
+        std::size_t pos = m_index[rnti] - 1;
+        m_live[pos] = 1;
+        return pos;
+      }
+    if (m_entries.size () - (m_size - 1) > m_size)
+      {
+        Compact ();
+      }
+    if (rnti >= m_index.size ())
+      {
+        m_index.resize (rnti + 1, 0);
+      }
+    if (m_entries.empty () || m_entries.back ().first < rnti)
+      {
+        m_entries.push_back (value_type (rnti, T ()));
+        m_live.push_back (1);
+        m_index[rnti] = m_entries.size ();
+        return m_entries.size () - 1;
+      }
+    // an RNTI lower than the last one: the entries after it are moved
+    std::size_t pos = 0;
+    while (m_entries[pos].first < rnti)
+      {
+        ++pos;
+      }
+    m_entries.insert (m_entries.begin () + pos, value_type (rnti, T ()));
+    m_live.insert (m_live.begin () + pos, 1);
+    for (std::size_t i = pos; i < m_entries.size (); ++i)
+      {
+        m_index[m_entries[i].first] = i + 1;
+      }
+    return pos;
+  }
+
+  /**
+   * \param pos the position of an entry
+   */
+  void Erase (std::size_t pos)
+  {
+    NS_ASSERT_MSG (pos < m_entries.size () && m_live[pos], "erase of a missing entry");
+    m_live[pos] = 0;
+    m_entries[pos].second = T ();
+    --m_size;
+  }
+
+  /// Drop the positions of the erased entries
+  void Compact ()
+  {
+    std::size_t n = 0;
+    for (std::size_t i = 0; i < m_entries.size (); ++i)
+      {
+        if (m_live[i])
+          {
+            if (n != i)
+              {
+                m_entries[n] = m_entries[i];
+              }
+            m_index[m_entries[n].first] = n + 1;
+            ++n;
+          }
+        else
+          {
+            m_index[m_entries[i].first] = 0;
+          }
+      }
+    m_entries.resize (n, value_type (0, T ()));
+    m_live.assign (n, 1);
+  }
+
+  std::vector<value_type> m_entries; ///< the entries, sorted by RNTI
+  std::vector<uint8_t> m_live;       ///< whether each entry is not erased
+  std::vector<uint32_t> m_index;     ///< the position plus one of the entry of each RNTI, 0 if none
+  std::size_t m_size;                ///< the number of entries not erased
+};
+
+} // namespace ns3
+
+#endif /* RNTI_MAP_H */
@@ -28,18 +28,40 @@
 #include <ns3/double.h>
 #include "ns3/uinteger.h"
 #include <fstream>
+#include <cstring>
 #include <ns3/simulator.h>
 
+#ifdef HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif /* HAVE_SYS_MMAN_H */
+
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("TraceFadingLossModel");
 
 NS_OBJECT_ENSURE_REGISTERED (TraceFadingLossModel);
+
+/// Magic number at the start of a binary fading trace
+static const char BINARY_TRACE_MAGIC[8] = { 'n', 's', '3', 'f', 'a', 'd', 'e', '1' };
+
+/// Header of a binary fading trace, followed by the samples
+struct BinaryTraceHeader
+{
+  char magic[8];       ///< BINARY_TRACE_MAGIC
+  uint32_t rbNum;      ///< number of RBs
+  uint32_t samplesNum; ///< number of samples per RB
+};
   
 
 
 TraceFadingLossModel::TraceFadingLossModel ()
-  : m_streamsAssigned (false)
+  : m_fadingTrace (0),
+    m_mappedTrace (0),
+    m_mappedTraceSize (0),
+    m_streamsAssigned (false)
 {
   NS_LOG_FUNCTION (this);
   SetNext (NULL);
@@ -48,9 +70,9 @@ TraceFadingLossModel::TraceFadingLossModel ()
 
 TraceFadingLossModel::~TraceFadingLossModel ()
 {
-  m_fadingTrace.clear ();
-  m_windowOffsetsMap.clear ();
-  m_startVariableMap.clear ();
+  UnloadTrace ();
+  m_links.clear ();
+  m_linkTable.clear ();
 }
 
 
@@ -72,7 +94,8 @@ TraceFadingLossModel::GetTypeId (void)
                   MakeTimeAccessor (&TraceFadingLossModel::SetTraceLength),
                   MakeTimeChecker ())
     .AddAttribute ("SamplesNum",
-                  "The number of samples the trace is made of (default 10000)",
+                  "The number of samples the trace is made of (default 10000). "
+                  "A binary trace overrides it with the value in its header.",
                    UintegerValue (10000),
                    MakeUintegerAccessor (&TraceFadingLossModel::m_samplesNum),
                    MakeUintegerChecker<uint32_t> ())
@@ -82,7 +105,8 @@ TraceFadingLossModel::GetTypeId (void)
                   MakeTimeAccessor (&TraceFadingLossModel::m_windowSize),
                   MakeTimeChecker ())
     .AddAttribute ("RbNum",
-                    "The number of RB the trace is made of (default 100)",
+                    "The number of RB the trace is made of (default 100). "
+                    "A binary trace overrides it with the value in its header.",
                     UintegerValue (100),
                    MakeUintegerAccessor (&TraceFadingLossModel::m_rbNum),
                    MakeUintegerChecker<uint8_t> ())
@@ -120,30 +144,203 @@ void
 TraceFadingLossModel::LoadTrace ()
 {
   NS_LOG_FUNCTION (this << "Loading Fading Trace " << m_traceFile);
-  std::ifstream ifTraceFile;
-  ifTraceFile.open (m_traceFile.c_str (), std::ifstream::in);
-  m_fadingTrace.clear ();
+  UnloadTrace ();
+  if (!MapTrace ())
+    {
+      std::ifstream ifTraceFile;
+      ifTraceFile.open (m_traceFile.c_str (), std::ifstream::in);
+      if (!ifTraceFile.good ())
+        {
+          NS_LOG_INFO (this << " File: " << m_traceFile);
+          NS_ASSERT_MSG(ifTraceFile.good (), " Fading trace file not found");
+        }
+
+    //   NS_LOG_INFO (this << " length " << m_traceLength.GetSeconds ());
+    //   NS_LOG_INFO (this << " RB " << (uint32_t)m_rbNum << " samples " << m_samplesNum);
+      m_textTrace.reserve (m_rbNum * m_samplesNum);
+      for (uint32_t i = 0; i < m_rbNum; i++)
+        {
+          for (uint32_t j = 0; j < m_samplesNum; j++)
+            {
+              double sample;
+              ifTraceFile >> sample;
+              m_textTrace.push_back (sample);
+            }
+        }
+    }
+  m_timeGranularity = m_traceLength.GetMilliSeconds () / m_samplesNum;
+  m_lastWindowUpdate = Simulator::Now ();
+}
+
+bool
+TraceFadingLossModel::MapTrace ()
+{
+  NS_LOG_FUNCTION (this);
+  BinaryTraceHeader header;
+  std::ifstream ifTraceFile (m_traceFile.c_str (), std::ifstream::in | std::ifstream::binary);
+  ifTraceFile.read (reinterpret_cast<char *> (&header), sizeof (header));
+  if (ifTraceFile.gcount () != sizeof (header)
+      || std::memcmp (header.magic, BINARY_TRACE_MAGIC, sizeof (header.magic)) != 0)
+    {
+      return false;
+    }
+
+  if (header.rbNum == 0 || header.rbNum > 255 || header.samplesNum == 0)
+    {
+      NS_FATAL_ERROR ("Invalid binary fading trace " << m_traceFile);
+    }
+  if (header.rbNum != m_rbNum || header.samplesNum != m_samplesNum)
+    {
+      NS_LOG_INFO (this << " binary trace of " << header.rbNum << " RBs and "
+                        << header.samplesNum << " samples overrides the attributes");
+    }
+  m_rbNum = header.rbNum;
+  m_samplesNum = header.samplesNum;
+  uint64_t traceSize = sizeof (header) + (uint64_t)m_rbNum * m_samplesNum * sizeof (float);
+
+#ifdef HAVE_SYS_MMAN_H
+  // map the file shared and read only, so that the page cache holds the
+  // only copy of the trace, whatever the number of processes using it
+  int fd = open (m_traceFile.c_str (), O_RDONLY);
+  struct stat st;
+  if (fd >= 0 && fstat (fd, &st) == 0 && (uint64_t)st.st_size >= traceSize)
+    {
+      void *addr = mmap (0, traceSize, PROT_READ, MAP_SHARED, fd, 0);
+      if (addr != MAP_FAILED)
+        {
+          m_mappedTrace = addr;
+          m_mappedTraceSize = traceSize;
+          m_fadingTrace = reinterpret_cast<const float *> (static_cast<const char *> (addr) + sizeof (header));
+        }
+    }
+  if (fd >= 0)
+    {
+      close (fd);
+    }
+  if (m_mappedTrace != 0)
+    {
+      return true;
+    }
+#endif /* HAVE_SYS_MMAN_H */
+
+  m_binaryTrace.resize ((uint64_t)m_rbNum * m_samplesNum);
+  ifTraceFile.read (reinterpret_cast<char *> (&m_binaryTrace[0]), m_binaryTrace.size () * sizeof (float));
+  if (ifTraceFile.fail ())
+    {
+      NS_FATAL_ERROR ("Truncated binary fading trace " << m_traceFile);
+    }
+  m_fadingTrace = &m_binaryTrace[0];
+  return true;
+}
+
+void
+TraceFadingLossModel::UnloadTrace ()
+{
+  NS_LOG_FUNCTION (this);
+#ifdef HAVE_SYS_MMAN_H
+  if (m_mappedTrace != 0)
+    {
+      munmap (m_mappedTrace, m_mappedTraceSize);
+    }
+#endif /* HAVE_SYS_MMAN_H */
+  m_mappedTrace = 0;
+  m_mappedTraceSize = 0;
+  std::vector<double> ().swap (m_textTrace);
+  std::vector<float> ().swap (m_binaryTrace);
+  m_fadingTrace = 0;
+}
+
+bool
+TraceFadingLossModel::ConvertTrace (std::string textFileName, std::string binaryFileName,
+                                    uint8_t rbNum, uint32_t samplesNum)
+{
+  NS_LOG_FUNCTION (textFileName << binaryFileName << (uint32_t) rbNum << samplesNum);
+  std::ifstream ifTraceFile (textFileName.c_str (), std::ifstream::in);
   if (!ifTraceFile.good ())
     {
-      NS_LOG_INFO (this << " File: " << m_traceFile);
-      NS_ASSERT_MSG(ifTraceFile.good (), " Fading trace file not found");
+      NS_LOG_WARN ("Fading trace file " << textFileName << " not found");
+      return false;
+    }
+  std::vector<float> samples;
+  samples.reserve ((uint64_t)rbNum * samplesNum);
+  for (uint64_t i = 0; i < (uint64_t)rbNum * samplesNum; i++)
+    {
+      double sample;
+      ifTraceFile >> sample;
+      if (ifTraceFile.fail ())
+        {
+          NS_LOG_WARN ("Fading trace file " << textFileName << " has only " << i << " samples");
+          return false;
+        }
+      samples.push_back (sample);
     }
 
-//   NS_LOG_INFO (this << " length " << m_traceLength.GetSeconds ());
-//   NS_LOG_INFO (this << " RB " << (uint32_t)m_rbNum << " samples " << m_samplesNum);
-  for (uint32_t i = 0; i < m_rbNum; i++)
+  BinaryTraceHeader header;
+  std::memcpy (header.magic, BINARY_TRACE_MAGIC, sizeof (header.magic));
+  header.rbNum = rbNum;
+  header.samplesNum = samplesNum;
+  std::ofstream ofTraceFile (binaryFileName.c_str (), std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
+  ofTraceFile.write (reinterpret_cast<const char *> (&header), sizeof (header));
+  if (!samples.empty ())
     {
-      FadingTraceSample rbTimeFadingTrace;
-      for (uint32_t j = 0; j < m_samplesNum; j++)
+      ofTraceFile.write (reinterpret_cast<const char *> (&samples[0]), samples.size () * sizeof (float));
+    }
+  ofTraceFile.close ();
+  return !ofTraceFile.fail ();
+}
+
+/**
+ * Hash of a couple of nodes
+ * \param a sender mobility
+ * \param b receiver mobility
+ * \return the hash
+ */
+static uint32_t
+LinkHash (const MobilityModel *a, const MobilityModel *b)
+{
+  uint64_t h = reinterpret_cast<uintptr_t> (a) * 0x9E3779B97F4A7C15ULL
+    ^ reinterpret_cast<uintptr_t> (b) * 0xC2B2AE3D27D4EB4FULL;
+  return (uint32_t)(h >> 32) ^ (uint32_t)h;
+}
+
+uint32_t
+TraceFadingLossModel::FindLink (Ptr<const MobilityModel> a, Ptr<const MobilityModel> b) const
+{
+  // keep the table at most half full, so that the probe sequences are short
+  if (2 * (m_links.size () + 1) > m_linkTable.size ())
+    {
+      std::vector<uint32_t> table (m_linkTable.empty () ? 64 : 2 * m_linkTable.size (), 0);
+      uint32_t mask = table.size () - 1;
+      for (uint32_t i = 0; i < m_links.size (); i++)
         {
-          double sample;
-          ifTraceFile >> sample;
-          rbTimeFadingTrace.push_back (sample);
+          uint32_t slot = LinkHash (PeekPointer (m_links[i].id.first), PeekPointer (m_links[i].id.second)) & mask;
+          while (table[slot] != 0)
+            {
+              slot = (slot + 1) & mask;
+            }
+          table[slot] = i + 1;
         }
-      m_fadingTrace.push_back (rbTimeFadingTrace);
+      m_linkTable.swap (table);
     }
-  m_timeGranularity = m_traceLength.GetMilliSeconds () / m_samplesNum;
-  m_lastWindowUpdate = Simulator::Now ();
+
+  uint32_t mask = m_linkTable.size () - 1;
+  uint32_t slot = LinkHash (PeekPointer (a), PeekPointer (b)) & mask;
+  while (m_linkTable[slot] != 0)
+    {
+      const FadingLink &link = m_links[m_linkTable[slot] - 1];
+      if (link.id.first == a && link.id.second == b)
+        {
+          return m_linkTable[slot] - 1;
+        }
+      slot = (slot + 1) & mask;
+    }
+
+  FadingLink link;
+  link.id = std::make_pair (a, b);
+  link.windowOffset = 0;
+  m_links.push_back (link);
+  m_linkTable[slot] = m_links.size ();
+  return m_links.size () - 1;
 }
 
 
@@ -155,28 +352,23 @@ TraceFadingLossModel::DoCalcRxPowerSpectralDensity (
 {
   NS_LOG_FUNCTION (this << *txPsd << a << b);
   
-  std::map <ChannelRealizationId_t, int >::iterator itOff;
-  ChannelRealizationId_t mobilityPair = std::make_pair (a,b);
-  itOff = m_windowOffsetsMap.find (mobilityPair);
-  if (itOff!=m_windowOffsetsMap.end ())
+  FadingLink &link = m_links[FindLink (a, b)];
+  if (link.startVariable != 0)
     {
       if (Simulator::Now ().GetSeconds () >= m_lastWindowUpdate.GetSeconds () + m_windowSize.GetSeconds ())
         {
           // update all the offsets
           NS_LOG_INFO ("Fading Windows Updated");
-          std::map <ChannelRealizationId_t, int >::iterator itOff2;
-          for (itOff2 = m_windowOffsetsMap.begin (); itOff2 != m_windowOffsetsMap.end (); itOff2++)
+          for (std::vector<FadingLink>::iterator it = m_links.begin (); it != m_links.end (); ++it)
             {
-              std::map <ChannelRealizationId_t, Ptr<UniformRandomVariable> >::iterator itVar;
-              itVar = m_startVariableMap.find ((*itOff2).first);
-              (*itOff2).second = (*itVar).second->GetValue ();
+              it->windowOffset = it->startVariable->GetValue ();
             }
           m_lastWindowUpdate = Simulator::Now ();
         }
     }
   else
     {
-      NS_LOG_LOGIC (this << "insert new channel realization, m_windowOffsetMap.size () = " << m_windowOffsetsMap.size ());
+      NS_LOG_LOGIC (this << "insert new channel realization, m_links.size () = " << m_links.size ());
       Ptr<UniformRandomVariable> startV = CreateObject<UniformRandomVariable> ();
       startV->SetAttribute ("Min", DoubleValue (1.0));
       startV->SetAttribute ("Max", DoubleValue ((m_traceLength.GetSeconds () - m_windowSize.GetSeconds ()) * 1000.0));
@@ -186,9 +378,8 @@ TraceFadingLossModel::DoCalcRxPowerSpectralDensity (
           startV->SetStream (m_currentStream);
           m_currentStream += 1;
         }
-      ChannelRealizationId_t mobilityPair = std::make_pair (a,b);
-      m_startVariableMap.insert (std::pair<ChannelRealizationId_t,Ptr<UniformRandomVariable> > (mobilityPair, startV));
-      m_windowOffsetsMap.insert (std::pair<ChannelRealizationId_t,int> (mobilityPair, startV->GetValue ()));
+      link.startVariable = startV;
+      link.windowOffset = startV->GetValue ();
     }
 
   
@@ -201,18 +392,19 @@ TraceFadingLossModel::DoCalcRxPowerSpectralDensity (
   //double speed = std::sqrt (std::pow (aSpeedVector.x-bSpeedVector.x,2) + std::pow (aSpeedVector.y-bSpeedVector.y,2));
 
   NS_LOG_LOGIC (this << *rxPsd);
-  NS_ASSERT (!m_fadingTrace.empty ());
+  NS_ASSERT (m_fadingTrace != 0 || !m_textTrace.empty ());
   int now_ms = static_cast<int> (Simulator::Now ().GetMilliSeconds () * m_timeGranularity);
   int lastUpdate_ms = static_cast<int> (m_lastWindowUpdate.GetMilliSeconds () * m_timeGranularity);
-  int index = ((*itOff).second + now_ms - lastUpdate_ms) % m_samplesNum;
+  int index = (link.windowOffset + now_ms - lastUpdate_ms) % m_samplesNum;
   int subChannel = 0;
   while (vit != rxPsd->ValuesEnd ())
     {
-      NS_ASSERT (subChannel < 100);
+      NS_ASSERT (subChannel < m_rbNum);
       if (*vit != 0.)
         {
-          double fading = m_fadingTrace.at (subChannel).at (index);
-          NS_LOG_INFO (this << " FADING now " << now_ms << " offset " << (*itOff).second << " id " << index << " fading " << fading);
+          uint32_t sample = subChannel * m_samplesNum + index;
+          double fading = m_fadingTrace != 0 ? m_fadingTrace[sample] : m_textTrace[sample];
+          NS_LOG_INFO (this << " FADING now " << now_ms << " offset " << link.windowOffset << " id " << index << " fading " << fading);
           double power = *vit; // in Watt/Hz
           power = 10 * std::log10 (180000 * power); // in dB
 
@@ -241,14 +433,12 @@ TraceFadingLossModel::AssignStreams (int64_t stream)
   m_streamsAssigned = true;
   m_currentStream = stream;
   m_lastStream = stream + m_streamSetSize - 1;
-  std::map <ChannelRealizationId_t, Ptr<UniformRandomVariable> >::iterator itVar;
-  itVar = m_startVariableMap.begin ();
   // the following loop is for eventually pre-existing ChannelRealization instances
   // note that more instances are expected to be created at run time
-  while (itVar!=m_startVariableMap.end ())
+  for (std::vector<FadingLink>::iterator it = m_links.begin (); it != m_links.end (); ++it)
     {
       NS_ASSERT_MSG (m_currentStream <= m_lastStream, "not enough streams, consider increasing the StreamSetSize attribute");
-      (*itVar).second->SetStream (m_currentStream);
+      it->startVariable->SetStream (m_currentStream);
       m_currentStream += 1;
     }
   return m_streamSetSize;
@@ -26,7 +26,7 @@
 
 #include <ns3/object.h>
 #include <ns3/spectrum-propagation-loss-model.h>
-#include <map>
+#include <vector>
 #include "ns3/random-variable-stream.h"
 #include <ns3/nstime.h>
 
@@ -40,6 +40,12 @@ class MobilityModel;
  * \ingroup lte
  *
  * \brief fading loss model based on precalculated fading traces
+ *
+ * The trace is either the text file produced by fading_trace_generator.m,
+ * with RbNum rows of SamplesNum values in dB, or its binary conversion
+ * by ConvertTrace (), which is memory mapped instead of parsed. All the
+ * processes of a host which load the same binary trace then share a
+ * single copy of it.
  */
 class TraceFadingLossModel : public SpectrumPropagationLossModel
 {
@@ -66,6 +72,24 @@ public:
   */
   int64_t AssignStreams (int64_t stream);
 
+  /**
+   * \brief Convert a text fading trace to the binary format
+   *
+   * The binary trace starts with a header holding the number of RBs and
+   * of samples, followed by the samples of each RB in turn, as 32 bit
+   * floats in the byte order of the host. The samples are rounded to
+   * float precision, so the fading of a binary trace may differ slightly
+   * from that of its text source.
+   *
+   * \param textFileName the text trace to read
+   * \param binaryFileName the binary trace to write
+   * \param rbNum the number of RBs of the trace
+   * \param samplesNum the number of samples per RB of the trace
+   * \return true if the trace was converted
+   */
+  static bool ConvertTrace (std::string textFileName, std::string binaryFileName,
+                            uint8_t rbNum, uint32_t samplesNum);
+
   
 private:
   /**
@@ -93,26 +117,59 @@ private:
   
   void LoadTrace ();
 
-
-   
-  mutable std::map <ChannelRealizationId_t, int > m_windowOffsetsMap;
-  
-  mutable std::map <ChannelRealizationId_t, Ptr<UniformRandomVariable> > m_startVariableMap;
-  
   /**
-   * Vector with fading samples in time domain (for a fixed RB)
+   * \brief Map the trace file, if it is a binary trace
+   * \return true if the trace file is a binary trace
    */
-  typedef std::vector<double> FadingTraceSample;
+  bool MapTrace ();
+
+  /// Unmap the binary trace, or release the text trace
+  void UnloadTrace ();
+
   /**
-   * Vector collecting the time fading traces in the frequency domain (per RB)
+   * \brief Find the channel realization of a couple of nodes
+   *
+   * The realizations are looked up in an open addressing hash table,
+   * and a new one is created for an unknown couple.
+   *
+   * \param a sender mobility
+   * \param b receiver mobility
+   * \return the index of the realization in m_links
    */
-  typedef std::vector<FadingTraceSample> FadingTrace;
+  uint32_t FindLink (Ptr<const MobilityModel> a, Ptr<const MobilityModel> b) const;
 
+  /// A fading channel realization
+  struct FadingLink
+  {
+    ChannelRealizationId_t id;              ///< the couple of nodes
+    int windowOffset;                       ///< start of the current window in the trace
+    Ptr<UniformRandomVariable> startVariable; ///< draws the start of the windows
+  };
 
+  /// The channel realizations, in order of creation
+  mutable std::vector<FadingLink> m_links;
+
+  /// Hash table of indexes in m_links plus one, zero for the free slots
+  mutable std::vector<uint32_t> m_linkTable;
   
   std::string m_traceFile;
   
-  FadingTrace m_fadingTrace;
+  /**
+   * Samples of a binary trace, those of each RB in turn: the sample j of
+   * RB i is m_fadingTrace[i * m_samplesNum + j]. They point into
+   * m_binaryTrace or into the mapped binary trace; null for a text trace.
+   */
+  const float *m_fadingTrace;
+
+  /**
+   * Samples of a text trace, in the same order. They are kept as read,
+   * in double precision, so that a text trace gives the same fading as
+   * before binary traces were supported.
+   */
+  std::vector<double> m_textTrace;
+  std::vector<float> m_binaryTrace; ///< binary trace read without mmap
+  void *m_mappedTrace;            ///< mapped binary trace file, if any
+  uint64_t m_mappedTraceSize;     ///< size of the mapped binary trace file
 
   
   Time m_traceLength;
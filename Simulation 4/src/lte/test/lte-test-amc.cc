@@ -0,0 +1,249 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <sstream>
+#include <vector>
+#include "ns3/test.h"
+#include "ns3/math.h"
+#include "ns3/double.h"
+#include "ns3/enum.h"
+#include "ns3/spectrum-value.h"
+#include "ns3/lte-amc.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Check that the CQIs computed by LteAmc from the SINR thresholds
+ * are the ones given by the spectral efficiency formula, over a sweep of
+ * SINRs which includes the SINRs closest to the thresholds.
+ */
+class LteAmcCqiTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor
+   * \param ber the BER of the AMC
+   */
+  LteAmcCqiTestCase (double ber);
+
+private:
+  /**
+   * Builds the test name string based on provided parameter values
+   * \param ber the BER of the AMC
+   * \returns the name string
+   */
+  static std::string BuildNameString (double ber);
+
+  virtual void DoRun (void);
+
+  /**
+   * The CQI of a SINR according to the PiroEW2010 formula
+   * \param amc the AMC
+   * \param sinr the SINR in linear units
+   * \return the CQI
+   */
+  int ReferenceCqi (Ptr<LteAmc> amc, double sinr);
+
+  double m_ber; ///< the BER of the AMC
+};
+
+LteAmcCqiTestCase::LteAmcCqiTestCase (double ber)
+  : TestCase (BuildNameString (ber)),
+    m_ber (ber)
+{
+}
+
+std::string
+LteAmcCqiTestCase::BuildNameString (double ber)
+{
+  std::ostringstream oss;
+  oss << "CQI of the SINR thresholds, BER = " << ber;
+  return oss.str ();
+}
+
+int
+LteAmcCqiTestCase::ReferenceCqi (Ptr<LteAmc> amc, double sinr)
+{
+  if (sinr == 0.0)
+    {
+      return -1;
+    }
+  double s = log2 (1 + (sinr / ((-std::log (5.0 * m_ber)) / 1.5)));
+  int cqi = 0;
+  while ((cqi < 15) && (amc->GetSpectralEfficiencyFromCqi (cqi + 1) < s))
+    {
+      ++cqi;
+    }
+  return cqi;
+}
+
+void
+LteAmcCqiTestCase::DoRun (void)
+{
+  Ptr<LteAmc> amc = CreateObject<LteAmc> ();
+  amc->SetAttribute ("AmcModel", EnumValue (LteAmc::PiroEW2010));
+  amc->SetAttribute ("Ber", DoubleValue (m_ber));
+
+  std::vector<double> sinr;
+  sinr.push_back (0.0);
+  for (double sinrDb = -30.0; sinrDb <= 50.0; sinrDb += 0.001)
+    {
+      sinr.push_back (std::pow (10.0, sinrDb / 10));
+    }
+  double gap = (-std::log (5.0 * m_ber)) / 1.5;
+  for (int cqi = 1; cqi <= 15; cqi++)
+    {
+      double threshold = (std::pow (2.0, amc->GetSpectralEfficiencyFromCqi (cqi)) - 1) * gap;
+      for (int i = -100; i <= 100; i++)
+        {
+          sinr.push_back (threshold * (1 + i * 1e-16));
+          sinr.push_back (threshold * (1 + i * 1e-11));
+        }
+    }
+
+  std::vector<int> cqi (sinr.size ());
+  NS_TEST_ASSERT_MSG_EQ (amc->CreateCqiFeedbacks (&sinr[0], sinr.size (), &cqi[0]), true,
+                         "PiroEW2010 evaluates the RBs one by one");
+  for (uint32_t i = 0; i < sinr.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (cqi[i], ReferenceCqi (amc, sinr[i]), "Wrong CQI for SINR " << sinr[i]);
+    }
+
+  // the thresholds follow the changes of the BER
+  amc->SetAttribute ("Ber", DoubleValue (m_ber / 10));
+  double old = m_ber;
+  m_ber = m_ber / 10;
+  NS_TEST_ASSERT_MSG_EQ (amc->CreateCqiFeedbacks (&sinr[0], sinr.size (), &cqi[0]), true,
+                         "PiroEW2010 evaluates the RBs one by one");
+  for (uint32_t i = 0; i < sinr.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (cqi[i], ReferenceCqi (amc, sinr[i]), "Wrong CQI for SINR " << sinr[i]);
+    }
+  m_ber = old;
+
+  // the SpectrumValue version gives the same CQIs
+  Bands bands;
+  for (uint32_t i = 0; i < 100; i++)
+    {
+      BandInfo bi;
+      bi.fl = 2.1e9 + i * 180e3;
+      bi.fc = bi.fl + 90e3;
+      bi.fh = bi.fl + 180e3;
+      bands.push_back (bi);
+    }
+  SpectrumValue sinrValue (Create<SpectrumModel> (bands));
+  for (uint32_t i = 0; i < 100; i++)
+    {
+      sinrValue[i] = sinr[i * 700];
+    }
+  std::vector<int> feedbacks = amc->CreateCqiFeedbacks (sinrValue);
+  NS_TEST_ASSERT_MSG_EQ (feedbacks.size (), 100, "Wrong number of CQIs");
+  for (uint32_t i = 0; i < 100; i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (feedbacks[i], cqi[i * 700], "Wrong CQI for RB " << i);
+    }
+}
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Check the MCS and the spectral efficiency which LteAmc gives for
+ * each CQI, and the CQI it gives for each spectral efficiency.
+ */
+class LteAmcTablesTestCase : public TestCase
+{
+public:
+  LteAmcTablesTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+LteAmcTablesTestCase::LteAmcTablesTestCase ()
+  : TestCase ("MCS and spectral efficiency of the CQIs")
+{
+}
+
+void
+LteAmcTablesTestCase::DoRun (void)
+{
+  Ptr<LteAmc> amc = CreateObject<LteAmc> ();
+
+  static const double spectralEfficiency[16] = {
+    0.0, 0.15, 0.23, 0.38, 0.6, 0.88, 1.18, 1.48, 1.91, 2.41, 2.73, 3.32, 3.9, 4.52, 5.12, 5.55
+  };
+  // spectral efficiency of the MCSs, see 3GPP R1-081483
+  static const double mcsSpectralEfficiency[29] = {
+    0.15, 0.19, 0.23, 0.31, 0.38, 0.49, 0.6, 0.74, 0.88, 1.03, 1.18,
+    1.33, 1.48, 1.7, 1.91, 2.16, 2.41, 2.57,
+    2.73, 3.03, 3.32, 3.61, 3.9, 4.21, 4.52, 4.82, 5.12, 5.33, 5.55
+  };
+  for (int cqi = 0; cqi < 16; cqi++)
+    {
+      // highest MCS of spectral efficiency not above the one of the CQI
+      int mcs = 0;
+      while ((mcs < 28) && (mcsSpectralEfficiency[mcs + 1] <= spectralEfficiency[cqi]))
+        {
+          ++mcs;
+        }
+      NS_TEST_ASSERT_MSG_EQ (amc->GetMcsFromCqi (cqi), mcs, "Wrong MCS for CQI " << cqi);
+      NS_TEST_ASSERT_MSG_EQ (amc->GetSpectralEfficiencyFromCqi (cqi), spectralEfficiency[cqi],
+                             "Wrong spectral efficiency for CQI " << cqi);
+    }
+
+  // the CQI below the first one of spectral efficiency not below s
+  for (double s = 0.0; s < 7.0; s += 0.005)
+    {
+      int cqi = 0;
+      while ((cqi < 15) && (spectralEfficiency[cqi + 1] < s))
+        {
+          ++cqi;
+        }
+      NS_TEST_ASSERT_MSG_EQ (amc->GetCqiFromSpectralEfficiency (s), cqi, "Wrong CQI for " << s);
+    }
+  for (int cqi = 1; cqi < 16; cqi++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (amc->GetCqiFromSpectralEfficiency (spectralEfficiency[cqi]), cqi - 1,
+                             "Wrong CQI for the spectral efficiency of CQI " << cqi);
+    }
+}
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief LteAmc TestSuite
+ */
+class LteAmcTestSuite : public TestSuite
+{
+public:
+  LteAmcTestSuite ();
+};
+
+LteAmcTestSuite::LteAmcTestSuite ()
+  : TestSuite ("lte-amc", UNIT)
+{
+  AddTestCase (new LteAmcTablesTestCase, TestCase::QUICK);
+  AddTestCase (new LteAmcCqiTestCase (0.00005), TestCase::QUICK);
+  AddTestCase (new LteAmcCqiTestCase (0.001), TestCase::QUICK);
+  AddTestCase (new LteAmcCqiTestCase (0.1), TestCase::QUICK);
+}
+
+static LteAmcTestSuite g_lteAmcTestSuite; ///< the test suite
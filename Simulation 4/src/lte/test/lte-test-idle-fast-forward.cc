@@ -0,0 +1,293 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <map>
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+#include "ns3/test.h"
+#include "ns3/config.h"
+#include "ns3/callback.h"
+#include "ns3/lte-helper.h"
+#include "ns3/point-to-point-epc-helper.h"
+#include "ns3/packet-sink-helper.h"
+#include "ns3/packet-sink.h"
+#include "ns3/udp-echo-helper.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/ipv4-static-routing-helper.h"
+#include "ns3/ipv4-static-routing.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/lte-enb-phy.h"
+#include "ns3/lte-ue-phy.h"
+#include "ns3/lte-enb-net-device.h"
+#include "ns3/lte-ue-net-device.h"
+#include "ns3/lte-ue-rrc.h"
+#include "ns3/boolean.h"
+#include "ns3/uinteger.h"
+#include "ns3/double.h"
+#include "ns3/string.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LteIdleFastForwardTest");
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Check that the IdleFastForward mode of the eNB and UE PHYs
+ * delivers the same traffic and the same SRS reports as the subframe by
+ * subframe loop, with far fewer subframes processed.
+ */
+class LteIdleFastForwardTestCase : public TestCase
+{
+public:
+  LteIdleFastForwardTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /// What a run of the scenario observed
+  struct Result
+  {
+    uint32_t rsrpSinrReports;               ///< number of UE RSRP/SINR reports, one per DL control reception
+    std::map<uint16_t, uint32_t> srsReports; ///< number of SRS reports per RNTI
+    std::map<uint16_t, double> srsSinr;     ///< sum of the SRS SINRs reported per RNTI
+    std::vector<uint16_t> rnti;             ///< RNTI of each UE
+    std::vector<uint32_t> dlRxBytes;        ///< bytes received by each UE
+    std::vector<uint32_t> ulRxBytes;        ///< bytes received from each UE
+  };
+
+  /**
+   * Run the scenario
+   * \param fastForward the value of the IdleFastForward attributes
+   * \param result the result of the run
+   */
+  void RunScenario (bool fastForward, Result &result);
+
+  /**
+   * UE RSRP/SINR trace sink
+   * \param result the result of the run
+   * \param cellId the cell ID
+   * \param rnti the RNTI
+   * \param rsrp the RSRP
+   * \param sinr the SINR
+   */
+  static void RsrpSinr (Result *result, uint16_t cellId, uint16_t rnti, double rsrp, double sinr);
+
+  /**
+   * eNB SRS SINR trace sink
+   * \param result the result of the run
+   * \param cellId the cell ID
+   * \param rnti the RNTI
+   * \param sinr the SRS SINR
+   */
+  static void UeSinr (Result *result, uint16_t cellId, uint16_t rnti, double sinr);
+
+  uint32_t m_numPkts; ///< number of packets sent in each direction by each UE
+};
+
+LteIdleFastForwardTestCase::LteIdleFastForwardTestCase ()
+  : TestCase ("Check the traffic and SRS reports of an idle fast forwarded cell"),
+    m_numPkts (10)
+{
+}
+
+void
+LteIdleFastForwardTestCase::RsrpSinr (Result *result, uint16_t cellId, uint16_t rnti, double rsrp, double sinr)
+{
+  result->rsrpSinrReports++;
+}
+
+void
+LteIdleFastForwardTestCase::UeSinr (Result *result, uint16_t cellId, uint16_t rnti, double sinr)
+{
+  result->srsReports[rnti]++;
+  result->srsSinr[rnti] += sinr;
+}
+
+void
+LteIdleFastForwardTestCase::RunScenario (bool fastForward, Result &result)
+{
+  Config::Reset ();
+  Config::SetDefault ("ns3::LteSpectrumPhy::CtrlErrorModelEnabled", BooleanValue (false));
+  Config::SetDefault ("ns3::LteSpectrumPhy::DataErrorModelEnabled", BooleanValue (false));
+  Config::SetDefault ("ns3::LteHelper::UseIdealRrc", BooleanValue (true));
+  Config::SetDefault ("ns3::LteEnbPhy::IdleFastForward", BooleanValue (fastForward));
+  Config::SetDefault ("ns3::LteUePhy::IdleFastForward", BooleanValue (fastForward));
+  Ptr<LteHelper> lteHelper = CreateObject<LteHelper> ();
+  Ptr<PointToPointEpcHelper> epcHelper = CreateObject<PointToPointEpcHelper> ();
+  lteHelper->SetEpcHelper (epcHelper);
+  lteHelper->SetSchedulerType ("ns3::PfFfMacScheduler");
+  lteHelper->SetAttribute ("PathlossModel", StringValue ("ns3::FriisPropagationLossModel"));
+
+  Ptr<Node> pgw = epcHelper->GetPgwNode ();
+  NodeContainer remoteHostContainer;
+  remoteHostContainer.Create (1);
+  Ptr<Node> remoteHost = remoteHostContainer.Get (0);
+  InternetStackHelper internet;
+  internet.Install (remoteHostContainer);
+  PointToPointHelper p2ph;
+  p2ph.SetDeviceAttribute ("DataRate", DataRateValue (DataRate ("100Gb/s")));
+  p2ph.SetChannelAttribute ("Delay", TimeValue (Seconds (0.010)));
+  NetDeviceContainer internetDevices = p2ph.Install (pgw, remoteHost);
+  Ipv4AddressHelper ipv4h;
+  ipv4h.SetBase ("1.0.0.0", "255.0.0.0");
+  Ipv4InterfaceContainer internetIpIfaces = ipv4h.Assign (internetDevices);
+  Ipv4Address remoteHostAddr = internetIpIfaces.GetAddress (1);
+  Ipv4StaticRoutingHelper ipv4RoutingHelper;
+  Ptr<Ipv4StaticRouting> remoteHostStaticRouting = ipv4RoutingHelper.GetStaticRouting (remoteHost->GetObject<Ipv4> ());
+  remoteHostStaticRouting->AddNetworkRouteTo (Ipv4Address ("7.0.0.0"), Ipv4Mask ("255.0.0.0"), 1);
+
+  // one eNB, and two UEs at different distances so that their SRS SINRs differ
+  NodeContainer enbs;
+  enbs.Create (1);
+  NodeContainer ues;
+  ues.Create (2);
+  Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
+  positionAlloc->Add (Vector (0.0, 0.0, 0.0));
+  positionAlloc->Add (Vector (100.0, 0.0, 0.0));
+  positionAlloc->Add (Vector (0.0, 400.0, 0.0));
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.SetPositionAllocator (positionAlloc);
+  mobility.Install (enbs);
+  mobility.Install (ues);
+  NetDeviceContainer enbLteDevs = lteHelper->InstallEnbDevice (enbs);
+  NetDeviceContainer ueLteDevs = lteHelper->InstallUeDevice (ues);
+  internet.Install (ues);
+  Ipv4InterfaceContainer ueIpIfaces = epcHelper->AssignUeIpv4Address (ueLteDevs);
+
+  Ptr<LteEnbPhy> enbPhy = enbLteDevs.Get (0)->GetObject<LteEnbNetDevice> ()->GetPhy ();
+  enbPhy->TraceConnectWithoutContext ("ReportUeSinr", MakeBoundCallback (&LteIdleFastForwardTestCase::UeSinr, &result));
+
+  // sparse traffic in both directions, with idle periods longer than a
+  // frame between the packets
+  std::vector<Ptr<PacketSink> > dlSinks;
+  std::vector<Ptr<PacketSink> > ulSinks;
+  for (uint32_t u = 0; u < ues.GetN (); ++u)
+    {
+      Ptr<Node> ue = ues.Get (u);
+      Ptr<Ipv4StaticRouting> ueStaticRouting = ipv4RoutingHelper.GetStaticRouting (ue->GetObject<Ipv4> ());
+      ueStaticRouting->SetDefaultRoute (epcHelper->GetUeDefaultGatewayAddress (), 1);
+      lteHelper->Attach (ueLteDevs.Get (u), enbLteDevs.Get (0));
+
+      Ptr<LteUePhy> uePhy = ueLteDevs.Get (u)->GetObject<LteUeNetDevice> ()->GetPhy ();
+      uePhy->TraceConnectWithoutContext ("ReportCurrentCellRsrpSinr",
+                                         MakeBoundCallback (&LteIdleFastForwardTestCase::RsrpSinr, &result));
+
+      uint16_t dlPort = 2000 + u;
+      PacketSinkHelper dlSinkHelper ("ns3::UdpSocketFactory", InetSocketAddress (Ipv4Address::GetAny (), dlPort));
+      ApplicationContainer apps = dlSinkHelper.Install (ue);
+      apps.Start (Seconds (0.1));
+      dlSinks.push_back (apps.Get (0)->GetObject<PacketSink> ());
+      UdpEchoClientHelper dlClient (ueIpIfaces.GetAddress (u), dlPort);
+      dlClient.SetAttribute ("MaxPackets", UintegerValue (m_numPkts));
+      dlClient.SetAttribute ("Interval", TimeValue (MilliSeconds (97)));
+      dlClient.SetAttribute ("PacketSize", UintegerValue (200 + u));
+      apps = dlClient.Install (remoteHost);
+      apps.Start (Seconds (0.3 + 0.011 * u));
+
+      uint16_t ulPort = 3000 + u;
+      PacketSinkHelper ulSinkHelper ("ns3::UdpSocketFactory", InetSocketAddress (Ipv4Address::GetAny (), ulPort));
+      apps = ulSinkHelper.Install (remoteHost);
+      apps.Start (Seconds (0.1));
+      ulSinks.push_back (apps.Get (0)->GetObject<PacketSink> ());
+      UdpEchoClientHelper ulClient (remoteHostAddr, ulPort);
+      ulClient.SetAttribute ("MaxPackets", UintegerValue (m_numPkts));
+      ulClient.SetAttribute ("Interval", TimeValue (MilliSeconds (113)));
+      ulClient.SetAttribute ("PacketSize", UintegerValue (300 + u));
+      apps = ulClient.Install (ue);
+      apps.Start (Seconds (0.35 + 0.017 * u));
+    }
+
+  Simulator::Stop (Seconds (2.0));
+  Simulator::Run ();
+
+  for (uint32_t u = 0; u < ues.GetN (); ++u)
+    {
+      result.rnti.push_back (ueLteDevs.Get (u)->GetObject<LteUeNetDevice> ()->GetRrc ()->GetRnti ());
+      result.dlRxBytes.push_back (dlSinks.at (u)->GetTotalRx ());
+      result.ulRxBytes.push_back (ulSinks.at (u)->GetTotalRx ());
+    }
+  Simulator::Destroy ();
+}
+
+void
+LteIdleFastForwardTestCase::DoRun (void)
+{
+  Result reference;
+  reference.rsrpSinrReports = 0;
+  RunScenario (false, reference);
+  Result fastForward;
+  fastForward.rsrpSinrReports = 0;
+  RunScenario (true, fastForward);
+
+  for (uint32_t u = 0; u < reference.dlRxBytes.size (); ++u)
+    {
+      NS_TEST_ASSERT_MSG_EQ (reference.dlRxBytes.at (u), m_numPkts * (200 + u), "wrong DL bytes of UE " << u << " without fast forward");
+      NS_TEST_ASSERT_MSG_EQ (reference.ulRxBytes.at (u), m_numPkts * (300 + u), "wrong UL bytes of UE " << u << " without fast forward");
+      NS_TEST_ASSERT_MSG_EQ (fastForward.dlRxBytes.at (u), m_numPkts * (200 + u), "wrong DL bytes of UE " << u << " with fast forward");
+      NS_TEST_ASSERT_MSG_EQ (fastForward.ulRxBytes.at (u), m_numPkts * (300 + u), "wrong UL bytes of UE " << u << " with fast forward");
+    }
+
+  //
+  // The SRS keep being sent and received while the cell is idle: they
+  // must be reported for the RNTI of the same UE, with about the same
+  // SINR, which they would not be if the subframe numbering drifted.  The
+  // UEs may get other RNTIs, and the closed loop power control makes the
+  // SINRs differ a little.
+  //
+  NS_TEST_ASSERT_MSG_EQ (fastForward.srsReports.size (), reference.srsReports.size (), "SRS reported for other RNTIs");
+  for (uint32_t u = 0; u < reference.rnti.size (); ++u)
+    {
+      uint16_t refRnti = reference.rnti.at (u);
+      uint16_t ffRnti = fastForward.rnti.at (u);
+      NS_TEST_ASSERT_MSG_GT (reference.srsReports[refRnti], 0, "no SRS reported for UE " << u << " without fast forward");
+      NS_TEST_ASSERT_MSG_GT (fastForward.srsReports[ffRnti], 0, "no SRS reported for UE " << u << " with fast forward");
+      double refMean = reference.srsSinr[refRnti] / reference.srsReports[refRnti];
+      double ffMean = fastForward.srsSinr[ffRnti] / fastForward.srsReports[ffRnti];
+      NS_TEST_EXPECT_MSG_EQ_TOL (ffMean, refMean, refMean * 0.01, "wrong SRS SINR of UE " << u);
+    }
+
+  // the DL control is only received in the subframes which are run
+  NS_LOG_INFO ("RSRP/SINR reports: " << reference.rsrpSinrReports << " without fast forward, "
+               << fastForward.rsrpSinrReports << " with fast forward");
+  NS_TEST_EXPECT_MSG_LT (fastForward.rsrpSinrReports, reference.rsrpSinrReports / 2,
+                         "too many subframes run with fast forward");
+}
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Idle fast forward TestSuite
+ */
+class LteIdleFastForwardTestSuite : public TestSuite
+{
+public:
+  LteIdleFastForwardTestSuite ();
+};
+
+LteIdleFastForwardTestSuite::LteIdleFastForwardTestSuite ()
+  : TestSuite ("lte-idle-fast-forward", SYSTEM)
+{
+  AddTestCase (new LteIdleFastForwardTestCase, TestCase::QUICK);
+}
+
+static LteIdleFastForwardTestSuite lteIdleFastForwardTestSuite; //!< Static variable for test initialization
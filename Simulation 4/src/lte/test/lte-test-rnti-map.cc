@@ -0,0 +1,151 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <map>
+#include <vector>
+#include "ns3/test.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/rnti-map.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Check that a RntiMap holds the entries of a std::map in the
+ * same order, through random insertions, lookups and erasures, the
+ * latter done the way the schedulers expire their CQI timers.
+ */
+class LteRntiMapTestCase : public TestCase
+{
+public:
+  LteRntiMapTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Check the entries of the table against the reference
+   * \param map the table
+   * \param ref the reference
+   */
+  void Check (const RntiMap<std::vector<double> > &map,
+              const std::map<uint16_t, std::vector<double> > &ref);
+};
+
+LteRntiMapTestCase::LteRntiMapTestCase ()
+  : TestCase ("Check a RntiMap against a std::map")
+{
+}
+
+void
+LteRntiMapTestCase::Check (const RntiMap<std::vector<double> > &map,
+                           const std::map<uint16_t, std::vector<double> > &ref)
+{
+  NS_TEST_ASSERT_MSG_EQ (map.size (), ref.size (), "Wrong number of entries");
+  NS_TEST_ASSERT_MSG_EQ (map.empty (), ref.empty (), "Wrong emptiness");
+  RntiMap<std::vector<double> >::const_iterator it = map.begin ();
+  for (std::map<uint16_t, std::vector<double> >::const_iterator itRef = ref.begin ();
+       itRef != ref.end (); ++itRef, ++it)
+    {
+      NS_TEST_ASSERT_MSG_EQ ((it != map.end ()), true, "Missing entries");
+      NS_TEST_ASSERT_MSG_EQ (it->first, itRef->first, "Wrong RNTI or order");
+      NS_TEST_ASSERT_MSG_EQ ((it->second == itRef->second), true, "Wrong state of RNTI " << itRef->first);
+      NS_TEST_ASSERT_MSG_EQ ((map.find (itRef->first) == it), true, "Lookup of RNTI " << itRef->first << " failed");
+    }
+  NS_TEST_ASSERT_MSG_EQ ((it == map.end ()), true, "Extra entries");
+}
+
+void
+LteRntiMapTestCase::DoRun (void)
+{
+  RngSeedManager::SetSeed (3);
+  RngSeedManager::SetRun (1);
+  Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable> ();
+
+  RntiMap<std::vector<double> > map;
+  std::map<uint16_t, std::vector<double> > ref;
+
+  for (uint32_t round = 0; round < 200; ++round)
+    {
+      // mostly increasing RNTIs, as allocated by the RRC, some lower ones
+      uint16_t high = 1 + round * 2;
+      for (uint32_t i = 0; i < 10; ++i)
+        {
+          uint16_t rnti = rng->GetInteger (1, high);
+          std::vector<double> state (1 + rnti % 5, rnti * 0.5);
+          bool inserted = map.insert (std::pair<uint16_t, std::vector<double> > (rnti, state)).second;
+          bool refInserted = ref.insert (std::pair<uint16_t, std::vector<double> > (rnti, state)).second;
+          NS_TEST_ASSERT_MSG_EQ (inserted, refInserted, "Wrong insertion of RNTI " << rnti);
+        }
+      uint16_t rnti = rng->GetInteger (1, high);
+      map[rnti].push_back (round);
+      ref[rnti].push_back (round);
+      Check (map, ref);
+
+      // expire some entries while iterating
+      RntiMap<std::vector<double> >::iterator it = map.begin ();
+      while (it != map.end ())
+        {
+          if (rng->GetValue () < 0.3)
+            {
+              ref.erase (it->first);
+              RntiMap<std::vector<double> >::iterator temp = it;
+              it++;
+              map.erase (temp);
+            }
+          else
+            {
+              (*it).second.push_back (-1);
+              ref[it->first].push_back (-1);
+              it++;
+            }
+        }
+      rnti = rng->GetInteger (1, high);
+      NS_TEST_ASSERT_MSG_EQ (map.erase (rnti), ref.erase (rnti), "Wrong erasure of RNTI " << rnti);
+      NS_TEST_ASSERT_MSG_EQ (map.count (rnti), 0, "Erased RNTI " << rnti << " still found");
+      Check (map, ref);
+    }
+
+  map.clear ();
+  ref.clear ();
+  Check (map, ref);
+  map[7].push_back (1);
+  ref[7].push_back (1);
+  Check (map, ref);
+}
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief RntiMap TestSuite
+ */
+class LteRntiMapTestSuite : public TestSuite
+{
+public:
+  LteRntiMapTestSuite ();
+};
+
+LteRntiMapTestSuite::LteRntiMapTestSuite ()
+  : TestSuite ("lte-rnti-map", UNIT)
+{
+  AddTestCase (new LteRntiMapTestCase, TestCase::QUICK);
+}
+
+static LteRntiMapTestSuite g_lteRntiMapTestSuite; ///< the test suite
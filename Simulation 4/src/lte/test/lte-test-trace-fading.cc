@@ -0,0 +1,198 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cmath>
+#include <fstream>
+#include <vector>
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/nstime.h"
+#include "ns3/spectrum-value.h"
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/trace-fading-loss-model.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Check that a fading trace converted to the binary format gives
+ * the same fading as the text trace, and that the samples are read at
+ * the right RB and time.
+ *
+ * The sample j of RB i of the trace is 0.25 j - 5 i dB, so that the
+ * fading tells which sample was used.
+ */
+class LteTraceFadingTestCase : public TestCase
+{
+public:
+  LteTraceFadingTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /// Compare the fading of the text and binary traces on all the links
+  void Check (void);
+
+  Ptr<TraceFadingLossModel> m_textModel;   ///< model of the text trace
+  Ptr<TraceFadingLossModel> m_binaryModel; ///< model of the binary trace
+  std::vector<Ptr<MobilityModel> > m_mobility; ///< the nodes
+  Ptr<SpectrumValue> m_txPsd;              ///< transmitted PSD
+  std::vector<int> m_lastIndex;            ///< sample of RB 0 last used on each link
+};
+
+/// Number of RBs of the test trace
+static const uint32_t TRACE_RB_NUM = 4;
+/// Number of samples per RB of the test trace
+static const uint32_t TRACE_SAMPLES_NUM = 100;
+/// Window of the fading model, in ms
+static const int64_t WINDOW_MS = 20;
+
+LteTraceFadingTestCase::LteTraceFadingTestCase ()
+  : TestCase ("Check a binary fading trace against the text trace")
+{
+}
+
+void
+LteTraceFadingTestCase::Check (void)
+{
+  uint32_t links = 0;
+  for (uint32_t i = 0; i < m_mobility.size (); i++)
+    {
+      for (uint32_t j = 0; j < m_mobility.size (); j++)
+        {
+          if (i == j)
+            {
+              continue;
+            }
+          Ptr<SpectrumValue> rxText = m_textModel->CalcRxPowerSpectralDensity (m_txPsd, m_mobility[i], m_mobility[j]);
+          Ptr<SpectrumValue> rxBinary = m_binaryModel->CalcRxPowerSpectralDensity (m_txPsd, m_mobility[i], m_mobility[j]);
+
+          double fading0 = 10 * std::log10 ((*rxText)[0] / (*m_txPsd)[0]);
+          int index = static_cast<int> (std::floor (fading0 / 0.25 + 0.5));
+          NS_TEST_ASSERT_MSG_EQ_TOL (fading0, index * 0.25, 1e-6, "Fading of RB 0 is not a sample of the trace");
+          NS_TEST_ASSERT_MSG_EQ ((index >= 0 && index < (int) TRACE_SAMPLES_NUM), true, "Sample " << index << " out of the trace");
+          for (uint32_t rb = 0; rb < TRACE_RB_NUM; rb++)
+            {
+              NS_TEST_ASSERT_MSG_EQ ((*rxText)[rb], (*rxBinary)[rb], "Different fading on RB " << rb << " of link " << i << "-" << j);
+              double fading = 10 * std::log10 ((*rxText)[rb] / (*m_txPsd)[rb]);
+              NS_TEST_ASSERT_MSG_EQ_TOL (fading, index * 0.25 - 5.0 * rb, 1e-6, "Wrong sample on RB " << rb);
+            }
+
+          // within a window, the trace is read one sample per ms
+          int64_t now = Simulator::Now ().GetMilliSeconds ();
+          if (now % WINDOW_MS != 0)
+            {
+              NS_TEST_ASSERT_MSG_EQ (index, m_lastIndex[links] + 1, "Samples not consecutive on link " << i << "-" << j);
+            }
+          m_lastIndex[links] = index;
+          links++;
+        }
+    }
+}
+
+void
+LteTraceFadingTestCase::DoRun (void)
+{
+  std::string textFile = CreateTempDirFilename ("fading-trace.fad");
+  std::string binaryFile = CreateTempDirFilename ("fading-trace.fadb");
+  std::ofstream trace (textFile.c_str ());
+  for (uint32_t i = 0; i < TRACE_RB_NUM; i++)
+    {
+      for (uint32_t j = 0; j < TRACE_SAMPLES_NUM; j++)
+        {
+          trace << (0.25 * j - 5.0 * i) << " ";
+        }
+      trace << std::endl;
+    }
+  trace.close ();
+
+  NS_TEST_ASSERT_MSG_EQ (TraceFadingLossModel::ConvertTrace (textFile, binaryFile, TRACE_RB_NUM + 1, TRACE_SAMPLES_NUM),
+                         false, "Conversion of a short trace should fail");
+  NS_TEST_ASSERT_MSG_EQ (TraceFadingLossModel::ConvertTrace (textFile, binaryFile, TRACE_RB_NUM, TRACE_SAMPLES_NUM),
+                         true, "Conversion failed");
+
+  m_textModel = CreateObject<TraceFadingLossModel> ();
+  m_textModel->SetAttribute ("TraceFilename", StringValue (textFile));
+  m_textModel->SetAttribute ("RbNum", UintegerValue (TRACE_RB_NUM));
+  m_textModel->SetAttribute ("SamplesNum", UintegerValue (TRACE_SAMPLES_NUM));
+  // the binary trace tells its own size
+  m_binaryModel = CreateObject<TraceFadingLossModel> ();
+  m_binaryModel->SetAttribute ("TraceFilename", StringValue (binaryFile));
+  Ptr<TraceFadingLossModel> models[2] = { m_textModel, m_binaryModel };
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      models[i]->SetAttribute ("TraceLength", TimeValue (MilliSeconds (TRACE_SAMPLES_NUM)));
+      models[i]->SetAttribute ("WindowSize", TimeValue (MilliSeconds (WINDOW_MS)));
+      models[i]->Initialize ();
+      models[i]->AssignStreams (1);
+    }
+
+  Bands bands;
+  for (uint32_t rb = 0; rb < TRACE_RB_NUM; rb++)
+    {
+      BandInfo bi;
+      bi.fl = 2.1e9 + rb * 180e3;
+      bi.fc = bi.fl + 90e3;
+      bi.fh = bi.fl + 180e3;
+      bands.push_back (bi);
+    }
+  m_txPsd = Create<SpectrumValue> (Create<SpectrumModel> (bands));
+  for (uint32_t rb = 0; rb < TRACE_RB_NUM; rb++)
+    {
+      (*m_txPsd)[rb] = 1e-15 * (rb + 1);
+    }
+
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      m_mobility.push_back (CreateObject<ConstantPositionMobilityModel> ());
+    }
+  m_lastIndex.resize (m_mobility.size () * (m_mobility.size () - 1));
+
+  for (int64_t t = 0; t < 3 * WINDOW_MS; t++)
+    {
+      Simulator::Schedule (MilliSeconds (t), &LteTraceFadingTestCase::Check, this);
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  m_textModel = 0;
+  m_binaryModel = 0;
+  m_mobility.clear ();
+}
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief TraceFadingLossModel TestSuite
+ */
+class LteTraceFadingTestSuite : public TestSuite
+{
+public:
+  LteTraceFadingTestSuite ();
+};
+
+LteTraceFadingTestSuite::LteTraceFadingTestSuite ()
+  : TestSuite ("lte-trace-fading", UNIT)
+{
+  AddTestCase (new LteTraceFadingTestCase, TestCase::QUICK);
+}
+
+static LteTraceFadingTestSuite g_lteTraceFadingTestSuite; ///< the test suite
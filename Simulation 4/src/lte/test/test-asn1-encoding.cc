@@ -42,7 +42,7 @@ public:
   {
     uint32_t psize = pkt->GetSize ();
     uint8_t buffer[psize];
-    char sbuffer[psize * 3];
+    char sbuffer[psize * 3 + 1];
     pkt->CopyData (buffer, psize);
     for (uint32_t i = 0; i < psize; i++)
       {
@@ -95,6 +95,12 @@ public:
   virtual void DoRun (void) = 0;
   LteRrcSap::RadioResourceConfigDedicated CreateRadioResourceConfigDedicated ();
   void AssertEqualRadioResourceConfigDedicated (LteRrcSap::RadioResourceConfigDedicated rrcd1, LteRrcSap::RadioResourceConfigDedicated rrcd2);
+  /**
+   * Check the contents of the packet against a reference encoding
+   * \param expected the octets of the reference encoding, in the format
+   *        of TestUtils::sprintPacketContentsHex
+   */
+  void AssertSerializedContents (std::string expected);
 
 protected:
   Ptr<Packet> packet;
@@ -158,6 +164,12 @@ RrcHeaderTestCase::CreateRadioResourceConfigDedicated ()
   return rrd;
 }
 
+void
+RrcHeaderTestCase::AssertSerializedContents (std::string expected)
+{
+  NS_TEST_ASSERT_MSG_EQ (TestUtils::sprintPacketContentsHex (packet), expected, "Different serialized contents!");
+}
+
 void
 RrcHeaderTestCase::AssertEqualRadioResourceConfigDedicated (LteRrcSap::RadioResourceConfigDedicated rrcd1, LteRrcSap::RadioResourceConfigDedicated rrcd2)
 {
@@ -286,9 +298,13 @@ RrcConnectionRequestTestCase::DoRun (void)
   // Log serialized packet contents
   TestUtils::LogPacketContents (packet);
 
+  // Check the serialized contents against the reference encoding
+  AssertSerializedContents ("48 3f ec af ec a6 ");
+
   // Remove header
   RrcConnectionRequestHeader destination;
   packet->RemoveHeader (destination);
+  NS_TEST_ASSERT_MSG_EQ (packet->GetSize (), 0, "Header not entirely deserialized!");
 
   // Log destination info
   TestUtils::LogPacketInfo<RrcConnectionRequestHeader> (destination,"DESTINATION");
@@ -334,9 +350,13 @@ RrcConnectionSetupTestCase::DoRun (void)
   // Log serialized packet contents
   TestUtils::LogPacketContents (packet);
 
+  // Check the serialized contents against the reference encoding
+  AssertSerializedContents ("7f 81 c8 ce 14 e0 b8 80 80 4d 98 46 10 84 28 1a 60 00 30 04 00 ");
+
   // remove header
   RrcConnectionSetupHeader destination;
   packet->RemoveHeader (destination);
+  NS_TEST_ASSERT_MSG_EQ (packet->GetSize (), 0, "Header not entirely deserialized!");
 
   // Log destination info
   TestUtils::LogPacketInfo<RrcConnectionSetupHeader> (destination,"DESTINATION");
@@ -382,9 +402,13 @@ RrcConnectionSetupCompleteTestCase::DoRun (void)
   // Log serialized packet contents
   TestUtils::LogPacketContents (packet);
 
+  // Check the serialized contents against the reference encoding
+  AssertSerializedContents ("26 40 ");
+
   // Remove header
   RrcConnectionSetupCompleteHeader destination;
   packet->RemoveHeader (destination);
+  NS_TEST_ASSERT_MSG_EQ (packet->GetSize (), 0, "Header not entirely deserialized!");
 
   // Log destination info
   TestUtils::LogPacketInfo<RrcConnectionSetupCompleteHeader> (destination,"DESTINATION");
@@ -429,9 +453,13 @@ RrcConnectionReconfigurationCompleteTestCase::DoRun (void)
   // Log serialized packet contents
   TestUtils::LogPacketContents (packet);
 
+  // Check the serialized contents against the reference encoding
+  AssertSerializedContents ("15 ");
+
   // remove header
   RrcConnectionReconfigurationCompleteHeader destination;
   packet->RemoveHeader (destination);
+  NS_TEST_ASSERT_MSG_EQ (packet->GetSize (), 0, "Header not entirely deserialized!");
 
   // Log destination info
   TestUtils::LogPacketInfo<RrcConnectionReconfigurationCompleteHeader> (destination,"DESTINATION");
@@ -586,9 +614,13 @@ RrcConnectionReconfigurationTestCase::DoRun (void)
   // Log serialized packet contents
   TestUtils::LogPacketContents (packet);
 
+  // Check the serialized contents against the reference encoding
+  AssertSerializedContents ("24 1a 3f e8 6c c0 08 3e 00 2a 79 82 40 82 60 ee 80 00 8d 01 4f a0 99 e0 a8 10 f9 25 32 04 71 09 8a 41 9d 68 87 8a b9 c2 98 4d 02 40 00 c0 01 66 40 00 2d 00 00 00 80 00 00 00 02 02 27 23 38 53 82 e2 02 01 36 61 18 42 10 a0 69 80 00 c0 10 ");
+
   // remove header
   RrcConnectionReconfigurationHeader destination;
   packet->RemoveHeader (destination);
+  NS_TEST_ASSERT_MSG_EQ (packet->GetSize (), 0, "Header not entirely deserialized!");
 
   // Log destination info
   TestUtils::LogPacketInfo<RrcConnectionReconfigurationHeader> (destination,"DESTINATION");
@@ -699,9 +731,13 @@ HandoverPreparationInfoTestCase::DoRun (void)
   // Log serialized packet contents
   TestUtils::LogPacketContents (packet);
 
+  // Check the serialized contents against the reference encoding
+  AssertSerializedContents ("08 00 00 39 19 c2 9c 17 10 10 09 b3 08 c2 10 85 03 4c 00 06 00 80 00 05 b0 02 a0 88 44 8c 00 00 00 00 00 a4 00 00 02 14 00 00 00 00 00 01 00 00 00 1e 00 00 00 00 00 00 7e 0d 00 08 00 00 60 01 57 80 00 03 ");
+
   // remove header
   HandoverPreparationInfoHeader destination;
   packet->RemoveHeader (destination);
+  NS_TEST_ASSERT_MSG_EQ (packet->GetSize (), 0, "Header not entirely deserialized!");
 
   // Log destination info
   TestUtils::LogPacketInfo<HandoverPreparationInfoHeader> (destination,"DESTINATION");
@@ -755,9 +791,13 @@ RrcConnectionReestablishmentRequestTestCase::DoRun (void)
   // Log serialized packet contents
   TestUtils::LogPacketContents (packet);
 
+  // Check the serialized contents against the reference encoding
+  AssertSerializedContents ("00 01 81 50 00 04 ");
+
   // remove header
   RrcConnectionReestablishmentRequestHeader destination;
   packet->RemoveHeader (destination);
+  NS_TEST_ASSERT_MSG_EQ (packet->GetSize (), 0, "Header not entirely deserialized!");
 
   // Log destination info
   TestUtils::LogPacketInfo<RrcConnectionReestablishmentRequestHeader> (destination,"DESTINATION");
@@ -804,9 +844,13 @@ RrcConnectionReestablishmentTestCase::DoRun (void)
   // Log serialized packet contents
   TestUtils::LogPacketContents (packet);
 
+  // Check the serialized contents against the reference encoding
+  AssertSerializedContents ("10 1c 8c e1 4e 0b 88 08 04 d9 84 61 08 42 81 a6 00 03 00 40 ");
+
   // remove header
   RrcConnectionReestablishmentHeader destination;
   packet->RemoveHeader (destination);
+  NS_TEST_ASSERT_MSG_EQ (packet->GetSize (), 0, "Header not entirely deserialized!");
 
   // Log destination info
   TestUtils::LogPacketInfo<RrcConnectionReestablishmentHeader> (destination,"DESTINATION");
@@ -851,9 +895,13 @@ RrcConnectionReestablishmentCompleteTestCase::DoRun (void)
   // Log serialized packet contents
   TestUtils::LogPacketContents (packet);
 
+  // Check the serialized contents against the reference encoding
+  AssertSerializedContents ("1e 00 ");
+
   // remove header
   RrcConnectionReestablishmentCompleteHeader destination;
   packet->RemoveHeader (destination);
+  NS_TEST_ASSERT_MSG_EQ (packet->GetSize (), 0, "Header not entirely deserialized!");
 
   // Log destination info
   TestUtils::LogPacketInfo<RrcConnectionReestablishmentCompleteHeader> (destination,"DESTINATION");
@@ -897,9 +945,13 @@ RrcConnectionRejectTestCase::DoRun (void)
   // Log serialized packet contents
   TestUtils::LogPacketContents (packet);
 
+  // Check the serialized contents against the reference encoding
+  AssertSerializedContents ("40 20 ");
+
   // remove header
   RrcConnectionRejectHeader destination;
   packet->RemoveHeader (destination);
+  NS_TEST_ASSERT_MSG_EQ (packet->GetSize (), 0, "Header not entirely deserialized!");
 
   // Log destination info
   TestUtils::LogPacketInfo<RrcConnectionRejectHeader> (destination,"DESTINATION");
@@ -959,9 +1011,13 @@ MeasurementReportTestCase::DoRun (void)
   // Log serialized packet contents
   TestUtils::LogPacketContents (packet);
 
+  // Check the serialized contents against the reference encoding
+  AssertSerializedContents ("08 12 12 54 10 48 07 00 00 00 30 00 2b 42 b0 ");
+
   // remove header
   MeasurementReportHeader destination;
   packet->RemoveHeader (destination);
+  NS_TEST_ASSERT_MSG_EQ (packet->GetSize (), 0, "Header not entirely deserialized!");
 
   // Log destination info
   TestUtils::LogPacketInfo<MeasurementReportHeader> (destination,"DESTINATION");
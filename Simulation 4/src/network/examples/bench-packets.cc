@@ -0,0 +1,202 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Packet throughput with the packet metadata on, off, or compiled out.
+//
+// Run it as is for "off", with --metadata=1 for "on", and from a
+// build configured with --disable-packet-metadata for "compiled out":
+//
+//   ./waf --run "bench-packets --n=1000000"
+//   ./waf --run "bench-packets --n=1000000 --metadata=1"
+
+#include "ns3/core-module.h"
+#include "ns3/packet.h"
+#include "ns3/header.h"
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+
+using namespace ns3;
+
+/* A header of N bytes, like the IP and transport headers of a stack.
+ */
+template <int N>
+class BenchHeader : public Header
+{
+public:
+  static TypeId GetTypeId (void);
+  virtual TypeId GetInstanceTypeId (void) const;
+  virtual void Print (std::ostream &os) const;
+  virtual uint32_t GetSerializedSize (void) const;
+  virtual void Serialize (Buffer::Iterator start) const;
+  virtual uint32_t Deserialize (Buffer::Iterator start);
+};
+
+static std::string
+BenchHeaderName (int n)
+{
+  std::ostringstream oss;
+  oss << "ns3::BenchHeader<" << n << ">";
+  return oss.str ();
+}
+
+template <int N>
+TypeId
+BenchHeader<N>::GetTypeId (void)
+{
+  static TypeId tid = TypeId (BenchHeaderName (N).c_str ())
+    .SetParent<Header> ()
+    .AddConstructor<BenchHeader<N> > ()
+  ;
+  return tid;
+}
+template <int N>
+TypeId
+BenchHeader<N>::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+template <int N>
+void
+BenchHeader<N>::Print (std::ostream &os) const
+{
+  os << "N=" << N;
+}
+template <int N>
+uint32_t
+BenchHeader<N>::GetSerializedSize (void) const
+{
+  return N;
+}
+template <int N>
+void
+BenchHeader<N>::Serialize (Buffer::Iterator start) const
+{
+  start.WriteU8 (N, N);
+}
+template <int N>
+uint32_t
+BenchHeader<N>::Deserialize (Buffer::Iterator start)
+{
+  for (int i = 0; i < N; i++)
+    {
+      start.ReadU8 ();
+    }
+  return N;
+}
+
+static void
+Report (std::string name, uint32_t n, SystemWallClockMs &clock)
+{
+  int64_t ms = clock.End ();
+  std::cout << std::left << std::setw (16) << name
+            << std::right << std::setw (10) << ms << " ms  "
+            << std::setw (10) << (ms * 1e6 / n) << " ns/packet" << std::endl;
+}
+
+static void
+BenchCreate (uint32_t n)
+{
+  SystemWallClockMs clock;
+  clock.Start ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      Ptr<Packet> p = Create<Packet> (1000);
+    }
+  Report ("create", n, clock);
+}
+
+static void
+BenchHeaders (uint32_t n)
+{
+  BenchHeader<20> ip;
+  BenchHeader<8> udp;
+  SystemWallClockMs clock;
+  clock.Start ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      Ptr<Packet> p = Create<Packet> (1000);
+      p->AddHeader (udp);
+      p->AddHeader (ip);
+      p->RemoveHeader (ip);
+      p->RemoveHeader (udp);
+    }
+  Report ("add/remove hdr", n, clock);
+}
+
+static void
+BenchFragment (uint32_t n)
+{
+  BenchHeader<20> ip;
+  Ptr<Packet> p = Create<Packet> (1400);
+  p->AddHeader (ip);
+  SystemWallClockMs clock;
+  clock.Start ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      Ptr<Packet> first = p->CreateFragment (0, 700);
+      Ptr<Packet> second = p->CreateFragment (700, p->GetSize () - 700);
+      first->AddAtEnd (second);
+    }
+  Report ("fragment", n, clock);
+}
+
+static void
+BenchCopy (uint32_t n)
+{
+  BenchHeader<20> ip;
+  BenchHeader<8> udp;
+  Ptr<Packet> p = Create<Packet> (1000);
+  p->AddHeader (udp);
+  p->AddHeader (ip);
+  SystemWallClockMs clock;
+  clock.Start ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      Ptr<Packet> copy = p->Copy ();
+      copy->RemoveHeader (ip);
+    }
+  Report ("copy", n, clock);
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 100000;
+  bool metadata = false;
+
+  CommandLine cmd;
+  cmd.AddValue ("n", "number of packets of each benchmark", n);
+  cmd.AddValue ("metadata", "enable the packet metadata", metadata);
+  cmd.Parse (argc, argv);
+
+#ifdef NS3_PACKET_METADATA_DISABLE
+  std::cout << "packet metadata: compiled out" << std::endl;
+#else
+  if (metadata)
+    {
+      Packet::EnablePrinting ();
+    }
+  std::cout << "packet metadata: " << (metadata ? "on" : "off") << std::endl;
+#endif
+
+  BenchCreate (n);
+  BenchHeaders (n);
+  BenchFragment (n);
+  BenchCopy (n);
+
+  return 0;
+}
@@ -0,0 +1,130 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Enqueue and dequeue throughput of a DropTailQueue, the default queue
+// of the point-to-point and CSMA devices.
+//
+//   ./waf --run "bench-queue --n=10000000"
+//   ./waf --run "bench-queue --n=10000000 --trace=1"
+//
+// "steady" keeps a single packet in the queue, "burst" fills the queue
+// up to --burst packets then drains it, and "overflow" enqueues into a
+// full queue, where every packet is dropped.
+
+#include "ns3/core-module.h"
+#include "ns3/packet.h"
+#include "ns3/drop-tail-queue.h"
+#include <iostream>
+#include <iomanip>
+#include <string>
+
+using namespace ns3;
+
+static uint64_t g_traced = 0;
+
+static void
+Sink (Ptr<const Packet> p)
+{
+  g_traced++;
+}
+
+static void
+Report (std::string name, uint32_t n, SystemWallClockMs &clock)
+{
+  int64_t ms = clock.End ();
+  std::cout << std::left << std::setw (16) << name
+            << std::right << std::setw (10) << ms << " ms  "
+            << std::setw (10) << (ms * 1e6 / n) << " ns/packet" << std::endl;
+}
+
+static void
+BenchSteady (Ptr<Queue> queue, Ptr<Packet> p, uint32_t n)
+{
+  SystemWallClockMs clock;
+  clock.Start ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      queue->Enqueue (Create<QueueItem> (p));
+      queue->Dequeue ();
+    }
+  Report ("steady", n, clock);
+}
+
+static void
+BenchBurst (Ptr<Queue> queue, Ptr<Packet> p, uint32_t n, uint32_t burst)
+{
+  SystemWallClockMs clock;
+  clock.Start ();
+  for (uint32_t i = 0; i < n; i += burst)
+    {
+      for (uint32_t j = 0; j < burst; j++)
+        {
+          queue->Enqueue (Create<QueueItem> (p));
+        }
+      for (uint32_t j = 0; j < burst; j++)
+        {
+          queue->Dequeue ();
+        }
+    }
+  Report ("burst", n, clock);
+}
+
+static void
+BenchOverflow (Ptr<Queue> queue, Ptr<Packet> p, uint32_t n, uint32_t burst)
+{
+  for (uint32_t j = 0; j < burst; j++)
+    {
+      queue->Enqueue (Create<QueueItem> (p));
+    }
+  SystemWallClockMs clock;
+  clock.Start ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      queue->Enqueue (Create<QueueItem> (p));
+    }
+  Report ("overflow", n, clock);
+  queue->DequeueAll ();
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 1000000;
+  uint32_t burst = 1000;
+  bool trace = false;
+
+  CommandLine cmd;
+  cmd.AddValue ("n", "number of packets of each benchmark", n);
+  cmd.AddValue ("burst", "size of the queue, and of the bursts", burst);
+  cmd.AddValue ("trace", "connect the Enqueue, Dequeue and Drop trace sources", trace);
+  cmd.Parse (argc, argv);
+
+  Ptr<Queue> queue = CreateObject<DropTailQueue> ();
+  queue->SetAttribute ("MaxPackets", UintegerValue (burst));
+  if (trace)
+    {
+      queue->TraceConnectWithoutContext ("Enqueue", MakeCallback (&Sink));
+      queue->TraceConnectWithoutContext ("Dequeue", MakeCallback (&Sink));
+      queue->TraceConnectWithoutContext ("Drop", MakeCallback (&Sink));
+    }
+  std::cout << "traces: " << (trace ? "connected" : "not connected") << std::endl;
+
+  Ptr<Packet> p = Create<Packet> (1000);
+  BenchSteady (queue, p, n);
+  BenchBurst (queue, p, n, burst);
+  BenchOverflow (queue, p, n, burst);
+
+  return 0;
+}
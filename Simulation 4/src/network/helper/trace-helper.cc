@@ -28,6 +28,8 @@
 #include "ns3/names.h"
 #include "ns3/net-device.h"
 #include "ns3/pcap-file-wrapper.h"
+#include "ns3/global-value.h"
+#include "ns3/enum.h"
 
 #include "trace-helper.h"
 
@@ -177,6 +179,13 @@ PcapHelper::SinkWithHeader (Ptr<PcapFileWrapper> file, const Header &header, Ptr
   file->Write (Simulator::Now (), header, p);
 }
 
+static GlobalValue g_asciiTraceFormat = GlobalValue ("AsciiTraceFormat",
+                                                     "The format of the ascii trace files: the text of "
+                                                     "the events, or binary records to decode later.",
+                                                     EnumValue (AsciiTraceHelper::FORMAT_TEXT),
+                                                     MakeEnumChecker (AsciiTraceHelper::FORMAT_TEXT, "Text",
+                                                                      AsciiTraceHelper::FORMAT_BINARY, "Binary"));
+
 AsciiTraceHelper::AsciiTraceHelper ()
 {
   NS_LOG_FUNCTION_NOARGS ();
@@ -192,6 +201,13 @@ AsciiTraceHelper::CreateFileStream (std::string filename, std::ios::openmode fil
 {
   NS_LOG_FUNCTION (filename << filemode);
 
+  EnumValue format;
+  g_asciiTraceFormat.GetValue (format);
+  if (format.Get () == FORMAT_BINARY && filemode == std::ios::out)
+    {
+      return CreateBinaryFileStream (filename);
+    }
+
   Ptr<OutputStreamWrapper> StreamWrapper = Create<OutputStreamWrapper> (filename, filemode);
 
   //
@@ -208,6 +224,17 @@ AsciiTraceHelper::CreateFileStream (std::string filename, std::ios::openmode fil
   return StreamWrapper;
 }
 
+Ptr<OutputStreamWrapper>
+AsciiTraceHelper::CreateBinaryFileStream (std::string filename)
+{
+  NS_LOG_FUNCTION (filename);
+
+  Ptr<BinaryTraceWriter> trace = Create<BinaryTraceWriter> (filename);
+  NS_ABORT_MSG_IF (trace->Fail (), "AsciiTraceHelper::CreateBinaryFileStream():  " <<
+                   "Unable to Open " << filename);
+  return Create<OutputStreamWrapper> (trace);
+}
+
 std::string
 AsciiTraceHelper::GetFilenameFromDevice (std::string prefix, Ptr<NetDevice> device, bool useObjectNames)
 {
@@ -310,6 +337,12 @@ void
 AsciiTraceHelper::DefaultEnqueueSinkWithoutContext (Ptr<OutputStreamWrapper> stream, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  Ptr<BinaryTraceWriter> binary = stream->GetBinaryTrace ();
+  if (binary != 0)
+    {
+      binary->Record ('+', p);
+      return;
+    }
   *stream->GetStream () << "+ " << Simulator::Now ().GetSeconds () << " " << *p << std::endl;
 }
 
@@ -317,6 +350,12 @@ void
 AsciiTraceHelper::DefaultEnqueueSinkWithContext (Ptr<OutputStreamWrapper> stream, std::string context, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  Ptr<BinaryTraceWriter> binary = stream->GetBinaryTrace ();
+  if (binary != 0)
+    {
+      binary->Record ('+', context, p);
+      return;
+    }
   *stream->GetStream () << "+ " << Simulator::Now ().GetSeconds () << " " << context << " " << *p << std::endl;
 }
 
@@ -336,6 +375,12 @@ void
 AsciiTraceHelper::DefaultDropSinkWithoutContext (Ptr<OutputStreamWrapper> stream, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  Ptr<BinaryTraceWriter> binary = stream->GetBinaryTrace ();
+  if (binary != 0)
+    {
+      binary->Record ('d', p);
+      return;
+    }
   *stream->GetStream () << "d " << Simulator::Now ().GetSeconds () << " " << *p << std::endl;
 }
 
@@ -343,6 +388,12 @@ void
 AsciiTraceHelper::DefaultDropSinkWithContext (Ptr<OutputStreamWrapper> stream, std::string context, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  Ptr<BinaryTraceWriter> binary = stream->GetBinaryTrace ();
+  if (binary != 0)
+    {
+      binary->Record ('d', context, p);
+      return;
+    }
   *stream->GetStream () << "d " << Simulator::Now ().GetSeconds () << " " << context << " " << *p << std::endl;
 }
 
@@ -363,6 +414,12 @@ void
 AsciiTraceHelper::DefaultDequeueSinkWithoutContext (Ptr<OutputStreamWrapper> stream, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  Ptr<BinaryTraceWriter> binary = stream->GetBinaryTrace ();
+  if (binary != 0)
+    {
+      binary->Record ('-', p);
+      return;
+    }
   *stream->GetStream () << "- " << Simulator::Now ().GetSeconds () << " " << *p << std::endl;
 }
 
@@ -370,6 +427,12 @@ void
 AsciiTraceHelper::DefaultDequeueSinkWithContext (Ptr<OutputStreamWrapper> stream, std::string context, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  Ptr<BinaryTraceWriter> binary = stream->GetBinaryTrace ();
+  if (binary != 0)
+    {
+      binary->Record ('-', context, p);
+      return;
+    }
   *stream->GetStream () << "- " << Simulator::Now ().GetSeconds () << " " << context << " " << *p << std::endl;
 }
 
@@ -387,6 +450,12 @@ void
 AsciiTraceHelper::DefaultReceiveSinkWithoutContext (Ptr<OutputStreamWrapper> stream, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  Ptr<BinaryTraceWriter> binary = stream->GetBinaryTrace ();
+  if (binary != 0)
+    {
+      binary->Record ('r', p);
+      return;
+    }
   *stream->GetStream () << "r " << Simulator::Now ().GetSeconds () << " " << *p << std::endl;
 }
 
@@ -394,6 +463,12 @@ void
 AsciiTraceHelper::DefaultReceiveSinkWithContext (Ptr<OutputStreamWrapper> stream, std::string context, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  Ptr<BinaryTraceWriter> binary = stream->GetBinaryTrace ();
+  if (binary != 0)
+    {
+      binary->Record ('r', context, p);
+      return;
+    }
   *stream->GetStream () << "r " << Simulator::Now ().GetSeconds () << " " << context << " " << *p << std::endl;
 }
 
@@ -155,6 +155,15 @@ PcapHelper::HookDefaultSink (Ptr<T> object, std::string tracename, Ptr<PcapFileW
 class AsciiTraceHelper
 {
 public:
+  /**
+   * @brief Format of the files made by CreateFileStream.
+   */
+  enum Format
+  {
+    FORMAT_TEXT,  /**< Text file */
+    FORMAT_BINARY /**< Binary trace file */
+  };
+
   /**
    * @brief Create an ascii trace helper.
    */
@@ -209,6 +218,10 @@ public:
    * that can solve the problem so we use one of those to carry the stream
    * around and deal with the lifetime issues.
    * 
+   * The file is a binary trace file, as made by CreateBinaryFileStream,
+   * when the global value AsciiTraceFormat is "Binary" and the file is
+   * opened with the default mode.
+   *
    * @param filename file name
    * @param filemode file mode
    * @returns a smart pointer to the output stream
@@ -216,6 +229,19 @@ public:
   Ptr<OutputStreamWrapper> CreateFileStream (std::string filename, 
                                              std::ios::openmode filemode = std::ios::out);
 
+  /**
+   * @brief Create and initialize a binary trace file.
+   *
+   * The default trace sinks record their events in the file as fixed-size
+   * binary records instead of printing the packets, which is much faster
+   * and much smaller.  BinaryTraceReader::Decode turns the file back into
+   * the text the sinks would have written to a text file.
+   *
+   * @param filename file name
+   * @returns a smart pointer to the output stream
+   */
+  Ptr<OutputStreamWrapper> CreateBinaryFileStream (std::string filename);
+
   /**
    * @brief Hook a trace source to the default enqueue operation trace sink that
    * does not accept nor log a trace context.
@@ -20,6 +20,12 @@
 #include "buffer.h"
 #include "ns3/assert.h"
 #include "ns3/log.h"
+#include "ns3/abort.h"
+#include "ns3/core-config.h"
+
+#if defined (BUFFER_FREE_LIST) && defined (HAVE_PTHREAD_H)
+#include <pthread.h>
+#endif
 
 #define LOG_INTERNAL_STATE(y)                                                                    \
   NS_LOG_LOGIC (y << "start="<<m_start<<", end="<<m_end<<", zero start="<<m_zeroAreaStart<<              \
@@ -51,47 +57,152 @@ NS_LOG_COMPONENT_DEFINE ("Buffer");
 
 
 uint32_t Buffer::g_recommendedStart = 0;
+struct Buffer::MaterializationStats Buffer::g_materializationStats;
 #ifdef BUFFER_FREE_LIST
-/* The following macros are pretty evil but they are needed to allow us to
- * keep track of 3 possible states for the g_freeList variable:
- *  - uninitialized means that no one has created a buffer yet
- *    so no one has created the associated free list (it is created
- *    on-demand when the first buffer is created)
- *  - initialized means that the free list exists and is valid
- *  - destroyed means that the static destructors of this compilation unit
- *    have run so, the free list has been cleared from its content
- * The key is that in destroyed state, we are careful not re-create it
- * which is a typical weakness of lazy evaluation schemes which use 
- * '0' as a special value to indicate both un-initialized and destroyed.
- * Note that it is important to use '0' as the marker for un-initialized state
- * because the variable holding this state information is initialized to zero
- * which the compiler assigns to zero-memory which is initialized to _zero_
- * before the constructors run so this ensures perfect handling of crazy 
- * constructor orderings.
+namespace {
+
+/// Capacity of the smallest size class
+const uint32_t POOL_MIN_SIZE = 64;
+/// Number of size classes: 64 bytes up to 64 KiB
+const uint32_t POOL_SIZE_CLASSES = 11;
+
+/**
+ * \param sizeClass the size class index
+ * \returns the capacity of the blocks of this size class
+ */
+inline uint32_t
+PoolClassSize (uint32_t sizeClass)
+{
+  return POOL_MIN_SIZE << sizeClass;
+}
+
+/**
+ * \param size a requested capacity
+ * \returns the smallest size class which can hold size bytes, or
+ *          POOL_SIZE_CLASSES if size is larger than all of them
+ */
+inline uint32_t
+PoolSizeClass (uint32_t size)
+{
+  uint32_t sizeClass = 0;
+  while (sizeClass < POOL_SIZE_CLASSES && PoolClassSize (sizeClass) < size)
+    {
+      sizeClass++;
+    }
+  return sizeClass;
+}
+
+/**
+ * Each free list keeps at most 1 MiB of blocks, and never more than
+ * 1024 or less than 16 of them.
+ *
+ * \param sizeClass the size class index
+ * \returns the maximum number of blocks kept for this size class
+ */
+inline uint32_t
+PoolClassLimit (uint32_t sizeClass)
+{
+  uint32_t limit = (1 << 20) / PoolClassSize (sizeClass);
+  return std::min<uint32_t> (1024, std::max<uint32_t> (16, limit));
+}
+
+/**
+ * Set once the static destructors of this compilation unit have run:
+ * from then on, blocks are allocated and released directly, which
+ * avoids re-creating a pool nobody would ever release.
  */
-#define MAGIC_DESTROYED (~(long) 0)
-#define IS_UNINITIALIZED(x) (x == (Buffer::FreeList*)0)
-#define IS_DESTROYED(x) (x == (Buffer::FreeList*)MAGIC_DESTROYED)
-#define IS_INITIALIZED(x) (!IS_UNINITIALIZED (x) && !IS_DESTROYED (x))
-#define DESTROYED ((Buffer::FreeList*)MAGIC_DESTROYED)
-#define UNINITIALIZED ((Buffer::FreeList*)0)
-uint32_t Buffer::g_maxSize = 0;
-Buffer::FreeList *Buffer::g_freeList = 0;
+bool g_poolsDestroyed = false;
+
+#ifdef HAVE_PTHREAD_H
+pthread_key_t g_poolKey;                        //!< key of the per-thread pools
+pthread_once_t g_poolKeyOnce = PTHREAD_ONCE_INIT; //!< guard of g_poolKey creation
+#else
+void *g_pool = 0;                               //!< the single pool
+#endif
+
+} // anonymous namespace
+
+/// Size-class free lists and counters of one thread
+struct Buffer::Pool
+{
+  /// Free blocks, indexed by size class
+  std::vector<struct Buffer::Data *> freeList[POOL_SIZE_CLASSES];
+  struct Buffer::PoolStats stats; //!< counters of this pool
+};
+
 struct Buffer::LocalStaticDestructor Buffer::g_localStaticDestructor;
 
 Buffer::LocalStaticDestructor::~LocalStaticDestructor(void)
 {
   NS_LOG_FUNCTION (this);
-  if (IS_INITIALIZED (g_freeList))
+  /* The thread-specific destructor does not run for the main thread:
+   * release its pool here. */
+#ifdef HAVE_PTHREAD_H
+  void *pool = GetPool ();
+  if (pool != 0)
     {
-      for (Buffer::FreeList::iterator i = g_freeList->begin ();
-           i != g_freeList->end (); i++)
+      pthread_setspecific (g_poolKey, 0);
+    }
+#else
+  void *pool = g_pool;
+  g_pool = 0;
+#endif
+  g_poolsDestroyed = true;
+  Buffer::DestroyPool (pool);
+}
+
+void
+Buffer::CreatePoolKey (void)
+{
+#ifdef HAVE_PTHREAD_H
+  int rc = pthread_key_create (&g_poolKey, &Buffer::DestroyPool);
+  NS_ABORT_MSG_IF (rc != 0, "Buffer::CreatePoolKey(): pthread_key_create failed: " << rc);
+#endif
+}
+
+void
+Buffer::DestroyPool (void *p)
+{
+  struct Pool *pool = static_cast<struct Pool *> (p);
+  if (pool == 0)
+    {
+      return;
+    }
+  for (uint32_t i = 0; i < POOL_SIZE_CLASSES; i++)
+    {
+      for (std::vector<struct Buffer::Data *>::iterator j = pool->freeList[i].begin ();
+           j != pool->freeList[i].end (); j++)
         {
-          Buffer::Deallocate (*i);
+          Buffer::Deallocate (*j);
         }
-      delete g_freeList;
-      g_freeList = DESTROYED;
     }
+  delete pool;
+}
+
+struct Buffer::Pool *
+Buffer::GetPool (void)
+{
+  if (g_poolsDestroyed)
+    {
+      return 0;
+    }
+#ifdef HAVE_PTHREAD_H
+  pthread_once (&g_poolKeyOnce, &Buffer::CreatePoolKey);
+  struct Pool *pool = static_cast<struct Pool *> (pthread_getspecific (g_poolKey));
+  if (pool == 0)
+    {
+      pool = new Pool ();
+      pthread_setspecific (g_poolKey, pool);
+    }
+#else
+  struct Pool *pool = static_cast<struct Pool *> (g_pool);
+  if (pool == 0)
+    {
+      pool = new Pool ();
+      g_pool = pool;
+    }
+#endif
+  return pool;
 }
 
 void
@@ -99,19 +210,25 @@ Buffer::Recycle (struct Buffer::Data *data)
 {
   NS_LOG_FUNCTION (data);
   NS_ASSERT (data->m_count == 0);
-  NS_ASSERT (!IS_UNINITIALIZED (g_freeList));
-  g_maxSize = std::max (g_maxSize, data->m_size);
-  /* feed into free list */
-  if (data->m_size < g_maxSize ||
-      IS_DESTROYED (g_freeList) ||
-      g_freeList->size () > 1000)
+  struct Pool *pool = GetPool ();
+  if (pool == 0)
+    {
+      Buffer::Deallocate (data);
+      return;
+    }
+  /* A block may have been handed out by the pool of another thread. */
+  pool->stats.bytesInUse -= std::min<uint64_t> (pool->stats.bytesInUse, data->m_size);
+  uint32_t sizeClass = PoolSizeClass (data->m_size);
+  if (sizeClass == POOL_SIZE_CLASSES ||
+      PoolClassSize (sizeClass) != data->m_size ||
+      pool->freeList[sizeClass].size () >= PoolClassLimit (sizeClass))
     {
       Buffer::Deallocate (data);
     }
   else
     {
-      NS_ASSERT (IS_INITIALIZED (g_freeList));
-      g_freeList->push_back (data);
+      pool->freeList[sizeClass].push_back (data);
+      pool->stats.bytesPooled += data->m_size;
     }
 }
 
@@ -119,29 +236,64 @@ Buffer::Data *
 Buffer::Create (uint32_t dataSize)
 {
   NS_LOG_FUNCTION (dataSize);
-  /* try to find a buffer correctly sized. */
-  if (IS_UNINITIALIZED (g_freeList))
+  struct Pool *pool = GetPool ();
+  if (pool == 0)
     {
-      g_freeList = new Buffer::FreeList ();
+      return Buffer::Allocate (dataSize);
     }
-  else if (IS_INITIALIZED (g_freeList))
+  struct Buffer::Data *data;
+  uint32_t sizeClass = PoolSizeClass (dataSize);
+  if (sizeClass == POOL_SIZE_CLASSES)
     {
-      while (!g_freeList->empty ()) 
-        {
-          struct Buffer::Data *data = g_freeList->back ();
-          g_freeList->pop_back ();
-          if (data->m_size >= dataSize) 
-            {
-              data->m_count = 1;
-              return data;
-            }
-          Buffer::Deallocate (data);
-        }
+      pool->stats.oversized++;
+      data = Buffer::Allocate (dataSize);
+    }
+  else if (!pool->freeList[sizeClass].empty ())
+    {
+      pool->stats.hits++;
+      data = pool->freeList[sizeClass].back ();
+      pool->freeList[sizeClass].pop_back ();
+      pool->stats.bytesPooled -= data->m_size;
+      data->m_count = 1;
+    }
+  else
+    {
+      pool->stats.misses++;
+      data = Buffer::Allocate (PoolClassSize (sizeClass));
     }
-  struct Buffer::Data *data = Buffer::Allocate (dataSize);
   NS_ASSERT (data->m_count == 1);
+  pool->stats.bytesInUse += data->m_size;
+  pool->stats.peakBytesInUse = std::max (pool->stats.peakBytesInUse,
+                                         pool->stats.bytesInUse);
   return data;
 }
+
+struct Buffer::PoolStats
+Buffer::GetPoolStats (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  struct Pool *pool = GetPool ();
+  if (pool == 0)
+    {
+      return PoolStats ();
+    }
+  return pool->stats;
+}
+
+void
+Buffer::ResetPoolStats (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  struct Pool *pool = GetPool ();
+  if (pool == 0)
+    {
+      return;
+    }
+  pool->stats.hits = 0;
+  pool->stats.misses = 0;
+  pool->stats.oversized = 0;
+  pool->stats.peakBytesInUse = pool->stats.bytesInUse;
+}
 #else /* BUFFER_FREE_LIST */
 void
 Buffer::Recycle (struct Buffer::Data *data)
@@ -157,6 +309,19 @@ Buffer::Create (uint32_t size)
   NS_LOG_FUNCTION (size);
   return Allocate (size);
 }
+
+struct Buffer::PoolStats
+Buffer::GetPoolStats (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  return PoolStats ();
+}
+
+void
+Buffer::ResetPoolStats (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+}
 #endif /* BUFFER_FREE_LIST */
 
 struct Buffer::Data *
@@ -244,7 +409,7 @@ void
 Buffer::Initialize (uint32_t zeroSize)
 {
   NS_LOG_FUNCTION (this << zeroSize);
-  m_data = Buffer::Create (0);
+  m_data = Buffer::Create (g_recommendedStart);
   m_start = std::min (m_data->m_size, g_recommendedStart);
   m_maxZeroAreaStart = m_start;
   m_zeroAreaStart = m_start;
@@ -426,6 +591,39 @@ Buffer::AddAtEnd (const Buffer &o)
       return;
     }
 
+  uint32_t zeroSize = m_zeroAreaEnd - m_zeroAreaStart;
+  uint32_t otherZeroSize = o.m_zeroAreaEnd - o.m_zeroAreaStart;
+  if (m_data != o.m_data)
+    {
+      /**
+       * Keep the larger of the two zero areas virtual, and write the
+       * bytes of the other buffer, its zero area included, next to it.
+       * The writes go through the iterators, which never materialize
+       * the zero area of the buffer they write into.
+       */
+      if (zeroSize >= otherZeroSize)
+        {
+          uint32_t size = o.GetSize ();
+          AddAtEnd (size);
+          Buffer::Iterator dst = End ();
+          dst.Prev (size);
+          dst.Write (o.Begin (), o.End ());
+          CountConcatMaterialization (otherZeroSize);
+        }
+      else
+        {
+          Buffer dst = o;
+          dst.AddAtStart (GetSize ());
+          dst.Begin ().Write (Begin (), End ());
+          CountConcatMaterialization (zeroSize);
+          *this = dst;
+        }
+      NS_ASSERT (CheckInternalState ());
+      return;
+    }
+
+  // Both buffers share their data: copy them apart first.
+  CountConcatMaterialization (zeroSize + otherZeroSize);
   Buffer dst = CreateFullCopy ();
   Buffer src = o.CreateFullCopy ();
 
@@ -690,11 +888,42 @@ Buffer::Deserialize (const uint8_t *buffer, uint32_t size)
 }
 
 
+void
+Buffer::CountConcatMaterialization (uint32_t bytes)
+{
+  if (bytes > 0)
+    {
+      NS_LOG_LOGIC ("concatenation materialized " << bytes << " zero bytes");
+      g_materializationStats.concatCount++;
+      g_materializationStats.concatBytes += bytes;
+    }
+}
+
+struct Buffer::MaterializationStats
+Buffer::GetMaterializationStats (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  return g_materializationStats;
+}
+
+void
+Buffer::ResetMaterializationStats (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  g_materializationStats = MaterializationStats ();
+}
+
 void
 Buffer::TransformIntoRealBuffer (void) const
 {
   NS_LOG_FUNCTION (this);
   NS_ASSERT (CheckInternalState ());
+  if (m_zeroAreaEnd != m_zeroAreaStart)
+    {
+      NS_LOG_LOGIC ("PeekData materialized " << m_zeroAreaEnd - m_zeroAreaStart << " zero bytes");
+      g_materializationStats.peekDataCount++;
+      g_materializationStats.peekDataBytes += m_zeroAreaEnd - m_zeroAreaStart;
+    }
   Buffer tmp = CreateFullCopy ();
   *const_cast<Buffer *> (this) = tmp;
   NS_ASSERT (CheckInternalState ());
@@ -843,25 +1072,36 @@ Buffer::Iterator::Write (Iterator start, Iterator end)
   uint32_t size = end.m_current - start.m_current;
   NS_ASSERT_MSG (CheckNoZero (m_current, m_current + size),
                  GetWriteErrorMessage ());
+  // The written range is entirely before or after our own zero area.
+  uint8_t *to;
+  if (m_current <= m_zeroStart)
+    {
+      to = &m_data[m_current];
+    }
+  else
+    {
+      to = &m_data[m_current - (m_zeroEnd - m_zeroStart)];
+    }
   if (start.m_current <= start.m_zeroStart)
     {
       uint32_t toCopy = std::min (size, start.m_zeroStart - start.m_current);
-      memcpy (&m_data[m_current], &start.m_data[start.m_current], toCopy);
+      memcpy (to, &start.m_data[start.m_current], toCopy);
       start.m_current += toCopy;
       m_current += toCopy;
+      to += toCopy;
       size -= toCopy;
     }
   if (start.m_current <= start.m_zeroEnd)
     {
       uint32_t toCopy = std::min (size, start.m_zeroEnd - start.m_current);
-      memset (&m_data[m_current], 0, toCopy);
+      memset (to, 0, toCopy);
       start.m_current += toCopy;
       m_current += toCopy;
+      to += toCopy;
       size -= toCopy;
     }
   uint32_t toCopy = std::min (size, start.m_dataEnd - start.m_current);
   uint8_t *from = &start.m_data[start.m_current - (start.m_zeroEnd-start.m_zeroStart)];
-  uint8_t *to = &m_data[m_current];
   memcpy (to, from, toCopy);
   m_current += toCopy;
 }
@@ -521,6 +521,10 @@ private:
    * Add bytes at the end of the Buffer.
    * Any call to this method invalidates any Iterator
    * pointing to this Buffer.
+   *
+   * A Buffer holds a single zero area, so when both buffers have
+   * one only the larger stays virtual; the bytes of the smaller are
+   * allocated and counted in the MaterializationStats.
    */
   void AddAtEnd (const Buffer &o);
   /**
@@ -636,6 +640,57 @@ private:
    */
   Buffer (uint32_t dataSize, bool initialize);
   ~Buffer ();
+
+  /**
+   * \brief Counters of virtual zero area bytes which were turned
+   * into real, allocated bytes, by the operation which forced it.
+   *
+   * Payload created by Packet (uint32_t size) is held as a zero area
+   * and never allocated unless one of these operations happens.
+   */
+  struct MaterializationStats
+  {
+    uint64_t peekDataCount; //!< number of PeekData calls which materialized
+    uint64_t peekDataBytes; //!< zero area bytes materialized by PeekData
+    uint64_t concatCount;   //!< number of AddAtEnd (Buffer) calls which materialized
+    uint64_t concatBytes;   //!< zero area bytes materialized by AddAtEnd (Buffer)
+  };
+  /**
+   * \returns the counters since the start of the run, or the last
+   *          call to ResetMaterializationStats.
+   */
+  static struct MaterializationStats GetMaterializationStats (void);
+  /**
+   * \brief Reset the materialization counters to zero.
+   */
+  static void ResetMaterializationStats (void);
+
+  /**
+   * \brief Counters of the Buffer::Data size-class pools.
+   *
+   * Data blocks are recycled through per-thread free lists, one per
+   * power-of-two size class. The counters describe the pool of the
+   * calling thread only.
+   */
+  struct PoolStats
+  {
+    uint64_t hits;           //!< allocations served from a free list
+    uint64_t misses;         //!< allocations of a size class with an empty free list
+    uint64_t oversized;      //!< allocations larger than the biggest size class
+    uint64_t bytesInUse;     //!< capacity of the blocks currently handed out
+    uint64_t peakBytesInUse; //!< highest value reached by bytesInUse
+    uint64_t bytesPooled;    //!< capacity of the blocks kept in the free lists
+  };
+  /**
+   * \returns the pool counters of the calling thread. All the counters
+   *          are zero if the free lists are compiled out.
+   */
+  static struct PoolStats GetPoolStats (void);
+  /**
+   * \brief Reset the hit, miss and oversized counters of the calling
+   * thread to zero, and its peak to the bytes currently in use.
+   */
+  static void ResetPoolStats (void);
 private:
   /**
    * This data structure is variable-sized through its last member whose size
@@ -691,6 +746,11 @@ private:
    * \brief Transform a "Virtual byte buffer" into a "Real byte buffer"
    */
   void TransformIntoRealBuffer (void) const;
+  /**
+   * \brief Account for zero area bytes materialized by AddAtEnd (Buffer)
+   * \param bytes the number of bytes materialized
+   */
+  static void CountConcatMaterialization (uint32_t bytes);
   /**
    * \brief Checks the internal buffer structures consistency
    *
@@ -763,6 +823,8 @@ private:
    */
   static uint32_t g_recommendedStart;
 
+  static struct MaterializationStats g_materializationStats; //!< zero area materialization counters
+
   /**
    * offset to the start of the virtual zero area from the start
    * of m_data->m_data
@@ -785,15 +847,27 @@ private:
   uint32_t m_end;
 
 #ifdef BUFFER_FREE_LIST
-  /// Container for buffer data
-  typedef std::vector<struct Buffer::Data*> FreeList;
+  /// Per-thread set of size-class free lists, defined in buffer.cc
+  struct Pool;
+  /**
+   * \returns the pool of the calling thread, or zero once the static
+   *          destructors of this compilation unit have run.
+   */
+  static struct Pool *GetPool (void);
+  /**
+   * \brief Create the thread-specific key holding the per-thread pools.
+   */
+  static void CreatePoolKey (void);
+  /**
+   * \brief Release a pool and all the blocks it holds.
+   * \param pool the pool to release
+   */
+  static void DestroyPool (void *pool);
   /// Local static destructor structure
   struct LocalStaticDestructor 
   {
     ~LocalStaticDestructor ();
   };
-  static uint32_t g_maxSize; //!< Max observed data size
-  static FreeList *g_freeList; //!< Buffer data container
   static struct LocalStaticDestructor g_localStaticDestructor; //!< Local static destructor
 #endif
 };
@@ -281,6 +281,11 @@ ByteTagList::AddAtEnd (int32_t appendOffset)
     {
       return;
     }
+  if (m_data->count == 1)
+    {
+      TrimInPlace (0, std::min (appendOffset, OFFSET_MAX));
+      return;
+    }
   ByteTagList list;
   ByteTagList::Iterator i = BeginAll ();
   while (i.HasNext ())
@@ -313,6 +318,11 @@ ByteTagList::AddAtStart (int32_t prependOffset)
     {
       return;
     }
+  if (m_data->count == 1)
+    {
+      TrimInPlace (std::max (prependOffset, 0), OFFSET_MAX);
+      return;
+    }
   m_minStart = INT32_MAX;
   ByteTagList list;
   ByteTagList::Iterator i = BeginAll ();
@@ -338,6 +348,45 @@ ByteTagList::AddAtStart (int32_t prependOffset)
   *this = list;
 }
 
+void
+ByteTagList::TrimInPlace (int32_t offsetStart, int32_t offsetEnd)
+{
+  NS_LOG_FUNCTION (this << offsetStart << offsetEnd);
+  NS_ASSERT (m_data != 0 && m_data->count == 1);
+  int32_t minStart = INT32_MAX;
+  int32_t maxEnd = INT32_MIN;
+  uint8_t *end = &m_data->data[m_used];
+  uint8_t *write = m_data->data;
+  for (uint8_t *read = m_data->data; read < end; )
+    {
+      TagBuffer buf = TagBuffer (read, end);
+      buf.ReadU32 ();
+      uint32_t itemSize = 4 + 4 + 4 + 4 + buf.ReadU32 ();
+      int32_t start = buf.ReadU32 () + m_adjustment;
+      int32_t stop = buf.ReadU32 () + m_adjustment;
+      if (start < offsetEnd && stop > offsetStart)
+        {
+          start = std::max (start, offsetStart);
+          stop = std::min (stop, offsetEnd);
+          if (write != read)
+            {
+              std::memmove (write, read, itemSize);
+            }
+          TagBuffer offsets = TagBuffer (write + 4 + 4, write + 4 + 4 + 4 + 4);
+          offsets.WriteU32 (start - m_adjustment);
+          offsets.WriteU32 (stop - m_adjustment);
+          minStart = std::min (minStart, start - m_adjustment);
+          maxEnd = std::max (maxEnd, stop - m_adjustment);
+          write += itemSize;
+        }
+      read += itemSize;
+    }
+  m_used = write - m_data->data;
+  m_data->dirty = m_used;
+  m_minStart = minStart;
+  m_maxEnd = maxEnd;
+}
+
 #ifdef USE_FREE_LIST
 
 struct ByteTagListData *
@@ -358,7 +407,8 @@ ByteTagList::Allocate (uint32_t size)
       uint8_t *buffer = (uint8_t *)data;
       delete [] buffer;
     }
-  uint8_t *buffer = new uint8_t [std::max (size, g_maxSize) + sizeof (struct ByteTagListData) - 4];
+  size = std::max (size, g_maxSize);
+  uint8_t *buffer = new uint8_t [size + sizeof (struct ByteTagListData) - 4];
   struct ByteTagListData *data = (struct ByteTagListData *)buffer;
   data->count = 1;
   data->size = size;
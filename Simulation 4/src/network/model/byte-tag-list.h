@@ -232,6 +232,16 @@ private:
    * \returns an iterator
    */
   ByteTagList::Iterator BeginAll (void) const;
+  /**
+   * \brief Drop the tags outside of [offsetStart, offsetEnd) and clamp
+   * the others to it, without copying the list.
+   *
+   * Only valid when this list is the only user of its data.
+   *
+   * \param offsetStart minimum offset value
+   * \param offsetEnd maximum offset value
+   */
+  void TrimInPlace (int32_t offsetStart, int32_t offsetEnd);
 
   /**
    * \brief Allocate the memory for the ByteTagListData
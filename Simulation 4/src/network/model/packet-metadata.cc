@@ -52,6 +52,10 @@ void
 PacketMetadata::Enable (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
+#ifdef NS3_PACKET_METADATA_DISABLE
+  NS_LOG_WARN ("Packet metadata is compiled out (NS3_PACKET_METADATA_DISABLE): "
+               "packets print without their headers and trailers.");
+#else
   NS_ASSERT_MSG (!m_metadataSkipped,
                  "Error: attempting to enable the packet metadata "
                  "subsystem too late in the simulation, which is not allowed.\n"
@@ -60,6 +64,7 @@ PacketMetadata::Enable (void)
                  "to call ns3::PacketMetadata::Enable () near the beginning of"
                  " the program, before any packets are sent.");
   m_enable = true;
+#endif
 }
 
 void 
@@ -640,6 +645,7 @@ PacketMetadata::Deallocate (struct PacketMetadata::Data *data)
   delete [] buf;
 }
 
+#ifndef NS3_PACKET_METADATA_DISABLE
 
 PacketMetadata 
 PacketMetadata::CreateFragment (uint32_t start, uint32_t end) const
@@ -1043,6 +1049,9 @@ PacketMetadata::GetUid (void) const
   NS_LOG_FUNCTION (this);
   return m_packetUid;
 }
+
+#endif /* NS3_PACKET_METADATA_DISABLE */
+
 PacketMetadata::ItemIterator 
 PacketMetadata::BeginItem (Buffer buffer) const
 {
@@ -74,6 +74,12 @@ class Trailer;
  * integers, and some others as variable-size 32-bit integers.
  * The variable-size 32 bit integers are stored using the uleb128
  * encoding.
+ *
+ * Defining NS3_PACKET_METADATA_DISABLE (waf configure option
+ * --disable-packet-metadata) compiles this bookkeeping out: the
+ * methods called by Packet become empty inline functions, no metadata
+ * storage is ever allocated, Enable and EnableChecking have no effect
+ * and packets print without their header and trailer details.
  */
 class PacketMetadata 
 {
@@ -686,6 +692,78 @@ public:
 
 namespace ns3 {
 
+#ifdef NS3_PACKET_METADATA_DISABLE
+
+PacketMetadata::PacketMetadata (uint64_t uid, uint32_t size)
+  : m_data (0),
+    m_head (0xffff),
+    m_tail (0xffff),
+    m_used (0),
+    m_packetUid (uid)
+{
+}
+PacketMetadata::PacketMetadata (PacketMetadata const &o)
+  : m_data (0),
+    m_head (0xffff),
+    m_tail (0xffff),
+    m_used (0),
+    m_packetUid (o.m_packetUid)
+{
+}
+PacketMetadata &
+PacketMetadata::operator = (PacketMetadata const& o)
+{
+  m_packetUid = o.m_packetUid;
+  return *this;
+}
+PacketMetadata::~PacketMetadata ()
+{
+}
+inline PacketMetadata
+PacketMetadata::CreateFragment (uint32_t start, uint32_t end) const
+{
+  return *this;
+}
+inline void
+PacketMetadata::AddHeader (Header const &header, uint32_t size)
+{
+}
+inline void
+PacketMetadata::RemoveHeader (Header const &header, uint32_t size)
+{
+}
+inline void
+PacketMetadata::AddTrailer (Trailer const &trailer, uint32_t size)
+{
+}
+inline void
+PacketMetadata::RemoveTrailer (Trailer const &trailer, uint32_t size)
+{
+}
+inline void
+PacketMetadata::AddAtEnd (PacketMetadata const&o)
+{
+}
+inline void
+PacketMetadata::AddPaddingAtEnd (uint32_t end)
+{
+}
+inline void
+PacketMetadata::RemoveAtStart (uint32_t start)
+{
+}
+inline void
+PacketMetadata::RemoveAtEnd (uint32_t end)
+{
+}
+inline uint64_t
+PacketMetadata::GetUid (void) const
+{
+  return m_packetUid;
+}
+
+#else /* NS3_PACKET_METADATA_DISABLE */
+
 PacketMetadata::PacketMetadata (uint64_t uid, uint32_t size)
   : m_data (PacketMetadata::Create (10)),
     m_head (0xffff),
@@ -742,6 +820,8 @@ PacketMetadata::~PacketMetadata ()
     }
 }
 
+#endif /* NS3_PACKET_METADATA_DISABLE */
+
 } // namespace ns3
 
 
@@ -20,7 +20,7 @@
 
 /**
 \file   packet-tag-list.cc
-\brief  Implements a linked list of Packet tags, including copy-on-write semantics.
+\brief  Implements a contiguous list of Packet tags, including copy-on-write semantics.
 */
 
 #include "packet-tag-list.h"
@@ -28,261 +28,206 @@
 #include "tag.h"
 #include "ns3/fatal-error.h"
 #include "ns3/log.h"
+#include <vector>
 #include <cstring>
 
+#define FREE_LIST_SIZE 1000
+
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("PacketTagList");
 
-bool
-PacketTagList::COWTraverse (Tag & tag, PacketTagList::COWWriter Writer)
+/**
+ * \ingroup packet
+ *
+ * \brief Container class for recycled PacketTagList::TagBlock
+ * of the initial capacity.
+ *
+ * Internal use only.
+ */
+static class PacketTagBlockFreeList : public std::vector<struct PacketTagList::TagBlock *>
 {
-  TypeId tid = tag.GetInstanceTypeId ();
-  NS_LOG_FUNCTION (this << tid);
-  NS_LOG_INFO     ("looking for " << tid);
+public:
+  ~PacketTagBlockFreeList ();
+  static bool destroyed; //!< true once the free list has been destroyed
+} g_freeList; //!< Container for struct PacketTagList::TagBlock
+
+bool PacketTagBlockFreeList::destroyed = false;
 
-  // trivial case when list is empty
-  if (m_next == 0)
+PacketTagBlockFreeList::~PacketTagBlockFreeList ()
+{
+  NS_LOG_FUNCTION (this);
+  for (PacketTagBlockFreeList::iterator i = begin ();
+       i != end (); i++)
     {
-      return false;
+      uint8_t *buffer = (uint8_t *)(*i);
+      delete [] buffer;
     }
+  destroyed = true;
+}
 
-  bool found = false;
-
-  struct TagData ** prevNext = &m_next; // previous node's next pointer
-  struct TagData  * cur      =  m_next; // cursor to current node
-  struct TagData  * it = 0;             // utility
-
-  // Search from the head of the list until we find tid or a merge
-  while (cur != 0)
+struct PacketTagList::TagBlock *
+PacketTagList::Allocate (uint32_t capacity)
+{
+  NS_LOG_FUNCTION (capacity);
+  struct TagBlock *block;
+  if (capacity == INITIAL_CAPACITY && !g_freeList.empty ())
     {
-      if (cur->count > 1)
-        {
-          // found merge
-          NS_LOG_INFO ("found initial merge before tid");
-          break;
-        }
-      else if (cur->tid == tid)
-        {
-          NS_LOG_INFO ("found tid before initial merge, calling writer");
-          found = (this->*Writer)(tag, true, cur, prevNext);
-          break;
-        }
-      else
-        {
-          // no merge or tid found yet, move on
-          prevNext = &cur->next;
-          cur      =  cur->next;
-        }
-    }  // while !found && !cow
-
-  // did we find it or run out of tags?
-  if (cur == 0 || found)
+      block = g_freeList.back ();
+      g_freeList.pop_back ();
+    }
+  else
     {
-      NS_LOG_INFO ("returning after header with found: " << found);
-      return found;
+      NS_ASSERT (capacity >= 1);
+      uint8_t *buffer = new uint8_t [sizeof (struct TagBlock)
+                                     + (capacity - 1) * sizeof (struct TagData)];
+      block = (struct TagBlock *)buffer;
+      block->capacity = capacity;
     }
+  block->count = 1;
+  block->dirty = 0;
+  return block;
+}
 
-  // From here on out, we have to copy the list
-  // until we find tid, then link past it
-
-  // Before we do all that work, let's make sure tid really exists
-  for (it = cur; it != 0; it = it->next)
+void
+PacketTagList::Deallocate (struct TagBlock *block)
+{
+  NS_LOG_FUNCTION (block);
+  NS_ASSERT (block->count == 0);
+  if (block->capacity == INITIAL_CAPACITY &&
+      !PacketTagBlockFreeList::destroyed &&
+      g_freeList.size () < FREE_LIST_SIZE)
     {
-      if (it->tid == tid)
-        {
-          break;
-        }
+      g_freeList.push_back (block);
     }
-  if (it == 0)
+  else
     {
-      // got to end of list without finding tid
-      NS_LOG_INFO ("tid not found after first merge");
-      return found;
+      uint8_t *buffer = (uint8_t *)block;
+      delete [] buffer;
     }
+}
 
-  // At this point cur is a merge, but untested for tid
-  NS_ASSERT (cur != 0);
-  NS_ASSERT (cur->count > 1);
-
-  /*
-     Walk the remainder of the list, copying, until we find tid
-     As we put a copy of the cur node onto our list,
-     we move the merge point down the list.
-
-     Starting position                  End position
-       T1 is a merge                     T1.count decremented
-                                         T2 is a merge
-                                         T1' is a copy of T1
-
-          other                             other
-               \                                 \
-      Prev  ->  T1  ->  T2  -> ...                T1  ->  T2  -> ...
-           /   /                                         /|
-      pNext cur                         Prev  ->  T1' --/ |
-                                                     /    |
-                                                pNext   cur
-
-     When we reach tid, we link past it, decrement count, and we're done.
-  */
-
-  // Should normally check for null cur pointer,
-  // but since we know tid exists, we'll skip this test
-  while ( /* cur && */ cur->tid != tid)
+uint32_t
+PacketTagList::Find (TypeId tid) const
+{
+  for (uint32_t i = 0; i < m_size; i++)
     {
-      NS_ASSERT (cur != 0);
-      NS_ASSERT (cur->count > 1);
-      cur->count--;                       // unmerge cur
-      struct TagData * copy = new struct TagData ();
-      copy->tid = cur->tid;
-      copy->count = 1;
-      memcpy (copy->data, cur->data, TagData::MAX_SIZE);
-      copy->next = cur->next;             // merge into tail
-      copy->next->count++;                // mark new merge
-      *prevNext = copy;                   // point prior list at copy
-      prevNext = &copy->next;             // advance
-      cur      =  copy->next;
+      if (m_data->tags[i].tid == tid)
+        {
+          return i;
+        }
     }
-  // Sanity check:
-  NS_ASSERT (cur != 0);                 // cur should be non-zero
-  NS_ASSERT (cur->tid == tid);          // cur->tid should be tid
-  NS_ASSERT (cur->count > 1);           // cur should be a merge
-
-  // link around tid, removing it from our list
-  found = (this->*Writer)(tag, false, cur, prevNext);
-  return found;
-
+  return m_size;
 }
 
-bool
-PacketTagList::Remove (Tag & tag)
+void
+PacketTagList::Unshare (uint32_t capacity)
 {
-  return COWTraverse (tag, &PacketTagList::RemoveWriter);
+  NS_LOG_FUNCTION (this << capacity);
+  NS_ASSERT (m_data != 0);
+  if (m_data->count == 1 && m_data->capacity >= capacity)
+    {
+      m_data->dirty = m_size;
+      return;
+    }
+  struct TagBlock *copy = Allocate (std::max<uint32_t> (capacity, INITIAL_CAPACITY));
+  for (uint32_t i = 0; i < m_size; i++)
+    {
+      copy->tags[i] = m_data->tags[i];
+    }
+  copy->dirty = m_size;
+  m_data->count--;
+  if (m_data->count == 0)
+    {
+      Deallocate (m_data);
+    }
+  m_data = copy;
 }
 
-// COWWriter implementing Remove
 bool
-PacketTagList::RemoveWriter (Tag & tag, bool preMerge,
-                             struct PacketTagList::TagData  * cur,
-                             struct PacketTagList::TagData ** prevNext)
+PacketTagList::Remove (Tag & tag)
 {
-  NS_LOG_FUNCTION_NOARGS ();
-
-  // found tid
-  bool found = true;
-  tag.Deserialize (TagBuffer (cur->data,
-                              cur->data + TagData::MAX_SIZE));
-  *prevNext = cur->next;            // link around cur
-
-  if (preMerge)
+  TypeId tid = tag.GetInstanceTypeId ();
+  NS_LOG_FUNCTION (this << tid);
+  uint32_t i = Find (tid);
+  if (i == m_size)
     {
-      // found tid before first merge, so delete cur
-      delete cur;
+      return false;
     }
-  else
+  Unshare (m_data->capacity);
+  tag.Deserialize (TagBuffer (m_data->tags[i].data,
+                              m_data->tags[i].data + TagData::MAX_SIZE));
+  for (; i + 1 < m_size; i++)
     {
-      // cur is always a merge at this point
-      // unmerge cur, since we linked around it already
-      cur->count--;
-      if (cur->next != 0)
-        {
-          // there's a next, so make it a merge
-          cur->next->count++;
-        }
+      m_data->tags[i] = m_data->tags[i + 1];
     }
-  return found;
+  m_size--;
+  m_data->dirty = m_size;
+  return true;
 }
 
 bool
 PacketTagList::Replace (Tag & tag)
 {
-  bool found = COWTraverse (tag, &PacketTagList::ReplaceWriter);
-  if (!found)
+  TypeId tid = tag.GetInstanceTypeId ();
+  NS_LOG_FUNCTION (this << tid);
+  uint32_t i = Find (tid);
+  if (i == m_size)
     {
       Add (tag);
+      return false;
     }
-  return found;
+  Unshare (m_data->capacity);
+  NS_ASSERT (tag.GetSerializedSize () <= TagData::MAX_SIZE);
+  tag.Serialize (TagBuffer (m_data->tags[i].data,
+                            m_data->tags[i].data + tag.GetSerializedSize ()));
+  return true;
 }
 
-// COWWriter implementing Replace
-bool
-PacketTagList::ReplaceWriter (Tag & tag, bool preMerge,
-                              struct PacketTagList::TagData  * cur,
-                              struct PacketTagList::TagData ** prevNext)
+void 
+PacketTagList::Add (const Tag &tag) const
 {
-  NS_LOG_FUNCTION_NOARGS ();
-
-  // found tid
-  bool found = true;
-  if (preMerge)
+  TypeId tid = tag.GetInstanceTypeId ();
+  NS_LOG_FUNCTION (this << tid);
+  // ensure this id was not yet added
+  NS_ASSERT_MSG (m_data == 0 || Find (tid) == m_size, "Error: cannot add the same kind of tag twice.");
+  PacketTagList *self = const_cast<PacketTagList *> (this);
+  if (m_data == 0)
     {
-      // found tid before first merge, so just rewrite
-      tag.Serialize (TagBuffer (cur->data,
-                                cur->data + tag.GetSerializedSize ()));
+      self->m_data = Allocate (INITIAL_CAPACITY);
     }
-  else
+  else if (m_size == m_data->capacity)
     {
-      // cur is always a merge at this point
-      // need to copy, replace, and link past cur
-      cur->count--;                     // unmerge cur
-      struct TagData * copy = new struct TagData ();
-      copy->tid = tag.GetInstanceTypeId ();
-      copy->count = 1;
-      tag.Serialize (TagBuffer (copy->data,
-                                copy->data + tag.GetSerializedSize ()));
-      copy->next = cur->next;           // merge into tail
-      if (copy->next != 0)
-        {
-          copy->next->count++;          // mark new merge
-        }
-      *prevNext = copy;                 // point prior list at copy
+      self->Unshare (2 * m_data->capacity);
     }
-  return found;
-}
-
-void 
-PacketTagList::Add (const Tag &tag) const
-{
-  NS_LOG_FUNCTION (this << tag.GetInstanceTypeId ());
-  // ensure this id was not yet added
-  for (struct TagData *cur = m_next; cur != 0; cur = cur->next) 
+  else if (m_data->count != 1 && m_data->dirty != m_size)
     {
-      NS_ASSERT_MSG (cur->tid != tag.GetInstanceTypeId (), "Error: cannot add the same kind of tag twice.");
+      // another list has written past our last tag
+      self->Unshare (m_data->capacity);
     }
-  struct TagData * head = new struct TagData ();
-  head->count = 1;
-  head->next = 0;
-  head->tid = tag.GetInstanceTypeId ();
-  head->next = m_next;
+  struct TagData *cur = &m_data->tags[m_size];
+  cur->tid = tid;
   NS_ASSERT (tag.GetSerializedSize () <= TagData::MAX_SIZE);
-  tag.Serialize (TagBuffer (head->data, head->data + tag.GetSerializedSize ()));
-
-  const_cast<PacketTagList *> (this)->m_next = head;
+  tag.Serialize (TagBuffer (cur->data, cur->data + tag.GetSerializedSize ()));
+  self->m_size++;
+  m_data->dirty = m_size;
 }
 
 bool
 PacketTagList::Peek (Tag &tag) const
 {
-  NS_LOG_FUNCTION (this << tag.GetInstanceTypeId ());
   TypeId tid = tag.GetInstanceTypeId ();
-  for (struct TagData *cur = m_next; cur != 0; cur = cur->next) 
+  NS_LOG_FUNCTION (this << tid);
+  uint32_t i = Find (tid);
+  if (i == m_size)
     {
-      if (cur->tid == tid) 
-        {
-          /* found tag */
-          tag.Deserialize (TagBuffer (cur->data, cur->data + TagData::MAX_SIZE));
-          return true;
-        }
+      /* no tag found */
+      return false;
     }
-  /* no tag found */
-  return false;
-}
-
-const struct PacketTagList::TagData *
-PacketTagList::Head (void) const
-{
-  return m_next;
+  /* found tag */
+  tag.Deserialize (TagBuffer (m_data->tags[i].data,
+                              m_data->tags[i].data + TagData::MAX_SIZE));
+  return true;
 }
 
 } /* namespace ns3 */
-
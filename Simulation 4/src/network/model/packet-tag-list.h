@@ -22,7 +22,7 @@
 
 /**
 \file   packet-tag-list.h
-\brief  Defines a linked list of Packet tags, including copy-on-write semantics.
+\brief  Defines a contiguous list of Packet tags, including copy-on-write semantics.
 */
 
 #include <stdint.h>
@@ -43,94 +43,43 @@ class Tag;
  *
  * \internal
  *
- * The implementation of this class is a bit tricky.  Refer to this
- * diagram in the discussion that follows.
+ *   - Tags are stored in serialized form in a single contiguous
+ *     TagBlock, oldest first. A packet carries only a handful of
+ *     tags, so a linear scan of the block finds a tag by TypeId in
+ *     a few cache lines, with no pointer chasing.
  *
- * \dot
- *    digraph {
- *        rankdir = "LR";
- *        clusterrank = local;
- *        node [ shape = record, fontname="FreeSans", fontsize="10" ];
- *        oth  [ label="<l> Other branch | <n> next | <c> ..." ];
- *        PTL1 [ label="<l> PacketTagList A | <n> m_next" , shape=Mrecord];
- *        PTL2 [ label="<l> PacketTagList B | <n> m_next" , shape=Mrecord];
- *        oth:n  -> T7:l ;
- *        PTL2:n -> T6:l ;
- *        PTL1:n -> T5:l ;
- *        T1   [ label="<l> T1  | <n> next | <c> count = 1" ];
- *        T2   [ label="<l> T2  | <n> next | <c> count = 1" ];
- *        T3   [ label="<l> T3  | <n> next | <c> count = 2" ];
- *        T4   [ label="<l> T4  | <n> next | <c> count = 1" ];
- *        T5   [ label="<l> T5  | <n> next | <c> count = 2" ];
- *        T6   [ label="<l> T6  | <n> next | <c> count = 1" ];
- *        T7   [ label="<l> T7  | <n> next | <c> count = 1" ];
- *        NULL [ label="0", shape = ellipse ];
- *        subgraph cluster_list {
- *          penwidth = 0;
- *          T6:n -> T5:l ;
- *          T5:n -> T4:l ;
- *          T4:n -> T3:l ;
- *          T7:n -> T3:l ;
- *          T3:n -> T2:l ;
- *          T2:n -> T1:l ;
- *          T1:n -> NULL ;
- *        };
- *      };
- * \enddot
- *
- *   - Tags are stored in serialized form in a tree of TagData
- *     structures. (<tt>T1-T7</tt> in the diagram)
- *
- *   - Each TagData points (\c next pointers in the diagram)
- *     toward the root of the tree, which is a null pointer.
- *
- *   - \c count is the number of incoming pointers to this
- *     TagData.  Branch points, where branches merge or join, have
- *     <tt>count \> 1</tt> (\c T3, \c T5); successive links along
- *     a branch have <tt>count = 1</tt> (\c T1, \c T2, \c T4, \c T6, \c T7).
- *
- *   - Each PacketTagList points to a specific TagData,
- *     which is the most recent Tag added to the packet. (<tt>T5-T7</tt>)
- *
- *   - Conceptually, therefore, each Packet has a PacketTagList which
- *     points to a singly-linked list of TagData.
+ *   - The TagBlock is shared by all the copies of a PacketTagList.
+ *     \c count is the number of lists sharing it, and \c dirty is
+ *     the number of tags written into it by any of them. Each list
+ *     records in #m_size how many of these tags belong to it.
  *
  * \par <b> Copy-on-write </b> is implemented as follows:
  *
- *   - #Add prepends the new tag to the list (growing that branch of the tree,
- *     as \c T6). This is a constant time operation, and does not affect
- *     any other #PacketTagList's, hence this is a \c const function.
- *
  *   - Copy constructor (PacketTagList(const PacketTagList & o))
  *     and assignment (#operator=(const PacketTagList & o))
- *     simply join the tree at the same place as the original
- *     PacketTagList \c o, incrementing the \c count.
- *     For assignment, the old branch is deleted, up to
- *     the first branch point, which has its \c count decremented.
- *     (PacketTagList \c B started as a copy of PacketTagList \c A,
- *     before \c T6 was added to \c B).
+ *     share the block of \c o and increment its \c count: copying
+ *     a packet never allocates.
+ *
+ *   - #Add appends the new tag in place if this list owns the block,
+ *     or if no other list has written past its own last tag
+ *     (<tt>dirty == m_size</tt>). Otherwise, or if the block is full,
+ *     the tags are copied into a new block first. This does not affect
+ *     any other PacketTagList, hence this is a \c const function.
  *
- *   - #Remove and #Replace are a little tricky, depending on where the
- *     target tag is found relative to the first branch point:
- *     - \e Target before <em> the first branch point: </em> \n
- *       The target is just dealt with in place (linked around and deleted,
- *       in the case of #Remove; rewritten in the case of #Replace).
- *     - \e Target at or after <em> the first branch point: </em> \n
- *       The portion of the list between the first branch and the target is
- *       shared. This portion is copied before the #Remove or #Replace is
- *       performed.
+ *   - #Remove and #Replace work in place if this list owns the block,
+ *     and on a private copy of the block otherwise.
  *
  * \par <b> Memory Management: </b>
  * \n
- * Packet tags must serialize to a finite maximum size, see TagData
- *
- * This documentation entitles the original author to a free beer.
+ * Blocks of the initial capacity are recycled through a free list, so
+ * that steady-state tagging does not allocate. Packet tags must
+ * serialize to a finite maximum size, see TagData.
  */
 class PacketTagList 
 {
 public:
   /**
-   * Tree node for sharing serialized tags.
+   * Serialized tag stored in a TagBlock.
    *
    * See PacketTagList for a discussion of the data structure.
    *
@@ -146,15 +95,9 @@ public:
      * in this constant.
      *
      * \internal
-     * Ideally, TagData would be 32 bytes in size, so they require
-     * no padding on 64-bit architectures.  (The architecture
-     * affects the size because of the \c #next pointer.)
-     * This would leave 18 bytes for \c #data.  However,
-     * ns3:Ipv6PacketInfoTag needs 19 bytes!  The current
-     * implementation allows 20 bytes, which gives TagData
-     * a size of 30 bytes on 32-byte machines (which gets
-     * padded with 2 bytes), and 34 bytes on 64-bit machines, which
-     * gets padded to 40 bytes.
+     * ns3:Ipv6PacketInfoTag needs 19 bytes. With 21 bytes of
+     * \c #data and the 2-byte \c #tid, a TagData takes 24 bytes
+     * without padding on any architecture.
      */
     enum TagData_e
     {
@@ -162,11 +105,29 @@ public:
   };
 
     uint8_t data[MAX_SIZE];   /**< Serialization buffer */
-    struct TagData * next;   /**< Pointer to next in list */
     TypeId tid;               /**< Type of the tag serialized into #data */
-    uint32_t count;           /**< Number of incoming links */
   };  /* struct TagData */
 
+  /**
+   * Contiguous storage shared by copies of a PacketTagList.
+   *
+   * This data structure is variable-sized through its last member
+   * whose size is determined at allocation time and stored in the
+   * #capacity field.
+   */
+  struct TagBlock
+  {
+    uint32_t count;           /**< Number of lists sharing this block */
+    uint32_t dirty;           /**< Number of tags written into #tags */
+    uint32_t capacity;        /**< Number of tags #tags can hold */
+    struct TagData tags[1];   /**< Tags, oldest first */
+  };  /* struct TagBlock */
+
+  /**
+   * \brief Number of tags a new block can hold.
+   */
+  static const uint32_t INITIAL_CAPACITY = 6;
+
   /**
    * Create a new PacketTagList.
    */
@@ -176,8 +137,8 @@ public:
    *
    * \param [in] o The PacketTagList to copy.
    *
-   * This makes a light-weight copy by #RemoveAll, then
-   * pointing to the same \ref TagData as \pname{o}.
+   * This makes a light-weight copy by sharing the \ref TagBlock
+   * of \pname{o}.
    */
   inline PacketTagList (PacketTagList const &o);
   /**
@@ -187,18 +148,18 @@ public:
    * \returns the copied object
    *
    * This makes a light-weight copy by #RemoveAll, then
-   * pointing to the same \ref TagData as \pname{o}.
+   * sharing the \ref TagBlock of \pname{o}.
    */
   inline PacketTagList &operator = (PacketTagList const &o);
   /**
    * Destructor
    *
-   * #RemoveAll's the tags up to the first merge.
+   * Releases the \ref TagBlock if this was its last user.
    */
   inline ~PacketTagList ();
 
   /**
-   * Add a tag to the head of this branch.
+   * Add a tag to the end of this list.
    *
    * \param [in] tag The tag to add
    */
@@ -230,67 +191,49 @@ public:
    */
   bool Peek (Tag &tag) const;
   /**
-   * Remove all tags from this list (up to the first merge).
+   * Remove all tags from this list.
    */
   inline void RemoveAll (void);
   /**
-   * \returns pointer to head of tag list
+   * \returns pointer to the oldest tag of the list, or 0 if it is empty
    */
-  const struct PacketTagList::TagData *Head (void) const;
+  inline const struct PacketTagList::TagData *Begin (void) const;
+  /**
+   * \returns pointer past the most recent tag of the list
+   */
+  inline const struct PacketTagList::TagData *End (void) const;
 
 private:
   /**
-   * Typedef of method function pointer for copy-on-write operations
+   * Find a tag of this list by type.
    *
-   * \param [in] tag The tag type to operate on.
-   * \param [in] preMerge True if \pname{tag} was found before the first merge,
-   *             false otherwise.
-   * \param [in] cur Pointer to the tag.
-   * \param [in] prevNext Pointer to the struct TagData.next pointer
-   *          pointing to \pname{cur}.
-   * \returns True if operation successful, false otherwise
+   * \param [in] tid The tag type to look for.
+   * \returns the index of the tag in the block, or #m_size if not found.
    */
-  typedef bool (PacketTagList::*COWWriter)
-    (Tag       & tag, bool         preMerge,
-    struct TagData * cur, struct TagData ** prevNext);
+  uint32_t Find (TypeId tid) const;
   /**
-   * Traverse the list implementing copy-on-write, using \pname{Writer}.
+   * Make sure this list is the only user of its block, copying
+   * the tags into a new block if needed.
    *
-   * \param [in] tag The tag type to operate on.
-   * \param [in] Writer The copy-on-write function to use.
-   * \returns True if \pname{tag} found, false otherwise.
+   * \param [in] capacity The minimum capacity of the block.
    */
-  bool COWTraverse   (Tag & tag, PacketTagList::COWWriter Writer);
+  void Unshare (uint32_t capacity);
   /**
-   * Copy-on-write implementing Remove.
+   * Allocate a block, from the free list if possible.
    *
-   * \param [in] tag The target tag type to remove.
-   * \param [in] preMerge True if \pname{tag} was found before the first merge,
-   *             false otherwise.
-   * \param [in] cur Pointer to the tag.
-   * \param [in] prevNext Pointer to the struct TagData.next pointer
-   *          pointing to \pname{cur}.
-   * \returns True, since tag will definitely be removed.
+   * \param [in] capacity The number of tags the block must hold.
+   * \returns the block, with a \c count of one and no tag.
    */
-  bool RemoveWriter  (Tag       & tag, bool         preMerge,
-                      struct TagData * cur, struct TagData ** prevNext);
+  static struct TagBlock *Allocate (uint32_t capacity);
   /**
-   * Copy-on-write implementing Replace
+   * Release a block whose \c count dropped to zero.
    *
-   * \param [in] tag The target tag type to replace
-   * \param [in] preMerge True if \pname{tag} was found before the first merge,
-   *          false otherwise.
-   * \param [in] cur Pointer to the tag
-   * \param [in] prevNext Pointer to the struct TagData.next pointer
-   *          pointing to \pname{cur}.
-   * \returns True, since tag value will definitely be replaced.
+   * \param [in] block The block to release.
    */
-  bool ReplaceWriter (Tag & tag, bool preMerge, struct TagData * cur, struct TagData ** prevNext);
+  static void Deallocate (struct TagBlock *block);
 
-  /**
-   * Pointer to first \ref TagData on the list
-   */
-  struct TagData *m_next;
+  struct TagBlock *m_data;    /**< Shared tag storage */
+  uint32_t m_size;            /**< Number of tags of #m_data in this list */
 };
 
 } // namespace ns3
@@ -302,16 +245,18 @@ private:
 namespace ns3 {
 
 PacketTagList::PacketTagList ()
-  : m_next ()
+  : m_data (0),
+    m_size (0)
 {
 }
 
 PacketTagList::PacketTagList (PacketTagList const &o)
-  : m_next (o.m_next)
+  : m_data (o.m_data),
+    m_size (o.m_size)
 {
-  if (m_next != 0)
+  if (m_data != 0)
     {
-      m_next->count++;
+      m_data->count++;
     }
 }
 
@@ -319,16 +264,17 @@ PacketTagList &
 PacketTagList::operator = (PacketTagList const &o)
 {
   // self assignment
-  if (m_next == o.m_next) 
+  if (this == &o)
     {
       return *this;
     }
-  RemoveAll ();
-  m_next = o.m_next;
-  if (m_next != 0) 
+  if (o.m_data != 0)
     {
-      m_next->count++;
+      o.m_data->count++;
     }
+  RemoveAll ();
+  m_data = o.m_data;
+  m_size = o.m_size;
   return *this;
 }
 
@@ -340,25 +286,28 @@ PacketTagList::~PacketTagList ()
 void
 PacketTagList::RemoveAll (void)
 {
-  struct TagData *prev = 0;
-  for (struct TagData *cur = m_next; cur != 0; cur = cur->next)
+  if (m_data != 0)
     {
-      cur->count--;
-      if (cur->count > 0) 
-        {
-          break;
-        }
-      if (prev != 0) 
+      m_data->count--;
+      if (m_data->count == 0)
         {
-	  delete prev;
+          Deallocate (m_data);
         }
-      prev = cur;
+      m_data = 0;
     }
-  if (prev != 0) 
-    {
-      delete prev;
-    }
-  m_next = 0;
+  m_size = 0;
+}
+
+const struct PacketTagList::TagData *
+PacketTagList::Begin (void) const
+{
+  return m_data != 0 ? m_data->tags : 0;
+}
+
+const struct PacketTagList::TagData *
+PacketTagList::End (void) const
+{
+  return m_data != 0 ? m_data->tags + m_size : 0;
 }
 
 } // namespace ns3
@@ -169,9 +169,12 @@ private:
   friend class Packet;
   /**
    * Constructor
-   * \param head head of the items
+   * \param begin the oldest of the items
+   * \param end past the most recent of the items
    */
-  PacketTagIterator (const struct PacketTagList::TagData *head);
+  PacketTagIterator (const struct PacketTagList::TagData *begin,
+                     const struct PacketTagList::TagData *end);
+  const struct PacketTagList::TagData *m_begin;    //!< the oldest tag in the packet
   const struct PacketTagList::TagData *m_current;  //!< actual position over the set of tags in a packet
 };
 
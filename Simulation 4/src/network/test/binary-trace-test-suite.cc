@@ -0,0 +1,333 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#include "ns3/log.h"
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/packet.h"
+#include "ns3/packet-metadata.h"
+#include "ns3/ethernet-header.h"
+#include "ns3/ethernet-trailer.h"
+#include "ns3/llc-snap-header.h"
+#include "ns3/trace-helper.h"
+#include "ns3/binary-trace-file.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("BinaryTraceTestSuite");
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Check that a decoded binary trace reads like the ascii trace
+ * of the same events.
+ */
+class BinaryTraceDecodeTestCase : public TestCase
+{
+public:
+  BinaryTraceDecodeTestCase ();
+
+private:
+  virtual void DoSetup (void);
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+
+  /**
+   * Send the events of a packet through a queue and a device to the
+   * default ascii trace sinks.
+   * \param stream the stream of the sinks
+   * \param p the packet
+   */
+  void Trace (Ptr<OutputStreamWrapper> stream, Ptr<Packet> p);
+
+  std::string m_testFilename; //!< the binary trace file
+};
+
+BinaryTraceDecodeTestCase::BinaryTraceDecodeTestCase ()
+  : TestCase ("Check that BinaryTraceReader::Decode gives the text of the AsciiTraceHelper sinks")
+{
+}
+
+void
+BinaryTraceDecodeTestCase::DoSetup (void)
+{
+  std::stringstream filename;
+  uint32_t n = rand ();
+  filename << n;
+  m_testFilename = CreateTempDirFilename (filename.str () + ".tr");
+}
+
+void
+BinaryTraceDecodeTestCase::DoTeardown (void)
+{
+  if (remove (m_testFilename.c_str ()))
+    {
+      NS_LOG_ERROR ("Failed to delete file " << m_testFilename);
+    }
+}
+
+void
+BinaryTraceDecodeTestCase::Trace (Ptr<OutputStreamWrapper> stream, Ptr<Packet> p)
+{
+  std::string context = "/NodeList/0/DeviceList/1/$ns3::CsmaNetDevice/TxQueue/Enqueue";
+
+  // unchanged between the enqueue and the dequeue
+  AsciiTraceHelper::DefaultEnqueueSinkWithContext (stream, context, p);
+  AsciiTraceHelper::DefaultDequeueSinkWithContext (stream, context, p);
+
+  // changed and traced again with the same uid
+  Ptr<Packet> copy = p->Copy ();
+  EthernetTrailer trailer;
+  copy->AddTrailer (trailer);
+  AsciiTraceHelper::DefaultReceiveSinkWithoutContext (stream, copy);
+  AsciiTraceHelper::DefaultDropSinkWithContext (stream, "/NodeList/1/DeviceList/0/MacRx", copy);
+
+  *stream->GetStream () << "# " << Simulator::Now ().GetSeconds () << " free-form text" << std::endl;
+}
+
+void
+BinaryTraceDecodeTestCase::DoRun (void)
+{
+  PacketMetadata::Enable ();
+
+  std::ostringstream text;
+  Ptr<OutputStreamWrapper> textStream = Create<OutputStreamWrapper> (&text);
+  AsciiTraceHelper ascii;
+  Ptr<OutputStreamWrapper> binaryStream = ascii.CreateBinaryFileStream (m_testFilename);
+  NS_TEST_ASSERT_MSG_NE (binaryStream->GetBinaryTrace (), 0, "CreateBinaryFileStream makes a text stream");
+  NS_TEST_ASSERT_MSG_EQ (textStream->GetBinaryTrace (), 0, "A plain stream has a binary trace");
+
+  for (uint32_t i = 0; i < 100; ++i)
+    {
+      Ptr<Packet> p = Create<Packet> (100 + i);
+      LlcSnapHeader llc;
+      llc.SetType (0x0800);
+      p->AddHeader (llc);
+      EthernetHeader ethernet;
+      ethernet.SetLengthType (p->GetSize ());
+      p->AddHeader (ethernet);
+      Time t = MicroSeconds (1234567 * i + 1);
+      Simulator::Schedule (t, &BinaryTraceDecodeTestCase::Trace, this, textStream, p);
+      Simulator::Schedule (t, &BinaryTraceDecodeTestCase::Trace, this, binaryStream, p);
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  // close the binary file
+  binaryStream = 0;
+
+  std::ostringstream decoded;
+  bool ok = BinaryTraceReader::Decode (m_testFilename, decoded);
+  NS_TEST_ASSERT_MSG_EQ (ok, true, "Decode (" << m_testFilename << ") returns error");
+  NS_TEST_ASSERT_MSG_EQ (decoded.str (), text.str (), "Decoded binary trace differs from the ascii trace");
+
+  //
+  // Only the first trace of an unchanged packet stores it, so the file
+  // must be a lot smaller than with every packet stored.
+  //
+  std::ifstream file (m_testFilename.c_str (), std::ios::in | std::ios::binary | std::ios::ate);
+  std::streamoff size = file.tellg ();
+  NS_TEST_ASSERT_MSG_LT (size, static_cast<std::streamoff> (text.str ().size ()), "Binary trace is larger than the text");
+
+  //
+  // A truncated file decodes up to the truncation and reports it.
+  //
+  std::vector<char> data (size);
+  file.seekg (0, std::ios::beg);
+  file.read (&data[0], size);
+  file.close ();
+  std::ofstream truncated (m_testFilename.c_str (), std::ios::out | std::ios::binary | std::ios::trunc);
+  truncated.write (&data[0], size - 3);
+  truncated.close ();
+  std::ostringstream partial;
+  ok = BinaryTraceReader::Decode (m_testFilename, partial);
+  NS_TEST_ASSERT_MSG_EQ (ok, false, "Decode of a truncated file does not return error");
+  NS_TEST_ASSERT_MSG_EQ (text.str ().compare (0, partial.str ().size (), partial.str ()), 0,
+                         "Decoded truncated file is not a prefix of the ascii trace");
+  NS_TEST_ASSERT_MSG_GT (partial.str ().size (), 0, "Nothing decoded from the truncated file");
+
+  // not a binary trace file
+  std::ofstream other (m_testFilename.c_str (), std::ios::out | std::ios::trunc);
+  other << text.str ();
+  other.close ();
+  ok = BinaryTraceReader::Decode (m_testFilename, partial);
+  NS_TEST_ASSERT_MSG_EQ (ok, false, "Decode of a text file does not return error");
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Check that the events whose character is also used by the
+ * other records of the file, like the 't' of the Tx sinks, are decoded
+ * as events, with their packet stored inline or referred to.
+ */
+class BinaryTraceEventTypeTestCase : public TestCase
+{
+public:
+  BinaryTraceEventTypeTestCase ();
+
+private:
+  virtual void DoSetup (void);
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+
+  /**
+   * Trace an event as the Tx sinks of the helpers do.
+   * \param stream the stream of the sink
+   * \param event the event character
+   * \param context the context, or empty for an event without one
+   * \param p the packet
+   */
+  static void Sink (Ptr<OutputStreamWrapper> stream, char event, std::string context, Ptr<const Packet> p);
+  /**
+   * Trace the events of a packet.
+   * \param stream the stream of the sinks
+   * \param p the packet
+   */
+  void Trace (Ptr<OutputStreamWrapper> stream, Ptr<Packet> p);
+
+  std::string m_testFilename; //!< the binary trace file
+};
+
+BinaryTraceEventTypeTestCase::BinaryTraceEventTypeTestCase ()
+  : TestCase ("Check that BinaryTraceReader::Decode keeps the 't' and 's' events")
+{
+}
+
+void
+BinaryTraceEventTypeTestCase::DoSetup (void)
+{
+  std::stringstream filename;
+  uint32_t n = rand ();
+  filename << n;
+  m_testFilename = CreateTempDirFilename (filename.str () + ".tr");
+}
+
+void
+BinaryTraceEventTypeTestCase::DoTeardown (void)
+{
+  if (remove (m_testFilename.c_str ()))
+    {
+      NS_LOG_ERROR ("Failed to delete file " << m_testFilename);
+    }
+}
+
+void
+BinaryTraceEventTypeTestCase::Sink (Ptr<OutputStreamWrapper> stream, char event, std::string context, Ptr<const Packet> p)
+{
+  Ptr<BinaryTraceWriter> binary = stream->GetBinaryTrace ();
+  if (binary != 0)
+    {
+      if (context.empty ())
+        {
+          binary->Record (event, p);
+        }
+      else
+        {
+          binary->Record (event, context, p);
+        }
+      return;
+    }
+  *stream->GetStream () << event << " " << Simulator::Now ().GetSeconds () << " ";
+  if (!context.empty ())
+    {
+      *stream->GetStream () << context << " ";
+    }
+  *stream->GetStream () << *p << std::endl;
+}
+
+void
+BinaryTraceEventTypeTestCase::Trace (Ptr<OutputStreamWrapper> stream, Ptr<Packet> p)
+{
+  std::string context = "/NodeList/0/DeviceList/0/Phy/State/Tx";
+
+  // the first event stores the packet, the others refer to it
+  Sink (stream, 't', context, p);
+  Sink (stream, 't', "", p);
+  Sink (stream, 's', context, p);
+  Sink (stream, 't', context, p);
+  AsciiTraceHelper::DefaultReceiveSinkWithContext (stream, context, p);
+
+  // stored again once changed
+  Ptr<Packet> copy = p->Copy ();
+  EthernetTrailer trailer;
+  copy->AddTrailer (trailer);
+  Sink (stream, 't', "", copy);
+  Sink (stream, 's', "", copy);
+
+  *stream->GetStream () << "t " << Simulator::Now ().GetSeconds () << " free-form text" << std::endl;
+}
+
+void
+BinaryTraceEventTypeTestCase::DoRun (void)
+{
+  PacketMetadata::Enable ();
+
+  std::ostringstream text;
+  Ptr<OutputStreamWrapper> textStream = Create<OutputStreamWrapper> (&text);
+  AsciiTraceHelper ascii;
+  Ptr<OutputStreamWrapper> binaryStream = ascii.CreateBinaryFileStream (m_testFilename);
+
+  for (uint32_t i = 0; i < 20; ++i)
+    {
+      Ptr<Packet> p = Create<Packet> (50 + i);
+      EthernetHeader ethernet;
+      ethernet.SetLengthType (p->GetSize ());
+      p->AddHeader (ethernet);
+      Time t = MicroSeconds (54321 * i + 7);
+      Simulator::Schedule (t, &BinaryTraceEventTypeTestCase::Trace, this, textStream, p);
+      Simulator::Schedule (t, &BinaryTraceEventTypeTestCase::Trace, this, binaryStream, p);
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  // close the binary file
+  binaryStream = 0;
+
+  std::ostringstream decoded;
+  bool ok = BinaryTraceReader::Decode (m_testFilename, decoded);
+  NS_TEST_ASSERT_MSG_EQ (ok, true, "Decode (" << m_testFilename << ") returns error");
+  NS_TEST_ASSERT_MSG_EQ (decoded.str (), text.str (), "Decoded binary trace differs from the ascii trace");
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Binary trace file TestSuite
+ */
+class BinaryTraceTestSuite : public TestSuite
+{
+public:
+  BinaryTraceTestSuite ();
+};
+
+BinaryTraceTestSuite::BinaryTraceTestSuite ()
+  : TestSuite ("binary-trace", UNIT)
+{
+  AddTestCase (new BinaryTraceDecodeTestCase, TestCase::QUICK);
+  AddTestCase (new BinaryTraceEventTypeTestCase, TestCase::QUICK);
+}
+
+static BinaryTraceTestSuite binaryTraceTestSuite; //!< Static variable for test initialization
@@ -22,6 +22,12 @@
 #include "ns3/random-variable-stream.h"
 #include "ns3/double.h"
 #include "ns3/test.h"
+#include "ns3/core-config.h"
+#include <vector>
+#ifdef HAVE_PTHREAD_H
+#include "ns3/system-thread.h"
+#include "ns3/callback.h"
+#endif
 
 using namespace ns3;
 
@@ -361,6 +367,190 @@ BufferTest::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ (val1, val2, "Bad ReadNtohU16()");
 }
 //-----------------------------------------------------------------------------
+class BufferZeroAreaTest : public TestCase {
+public:
+  virtual void DoRun (void);
+  BufferZeroAreaTest ();
+private:
+  Buffer MakeBuffer (uint32_t zeroSize, uint8_t header, uint8_t trailer);
+  void CheckBuffer (const Buffer &b, const std::vector<uint8_t> &expected);
+};
+
+BufferZeroAreaTest::BufferZeroAreaTest ()
+  : TestCase ("Buffer zero area concatenation")
+{
+}
+
+// A zero area between a 2 byte header and a 1 byte trailer
+Buffer
+BufferZeroAreaTest::MakeBuffer (uint32_t zeroSize, uint8_t header, uint8_t trailer)
+{
+  Buffer b (zeroSize);
+  b.AddAtStart (2);
+  b.Begin ().WriteU16 (header | (header << 8));
+  b.AddAtEnd (1);
+  Buffer::Iterator i = b.End ();
+  i.Prev ();
+  i.WriteU8 (trailer);
+  return b;
+}
+
+void
+BufferZeroAreaTest::CheckBuffer (const Buffer &b, const std::vector<uint8_t> &expected)
+{
+  NS_TEST_ASSERT_MSG_EQ (b.GetSize (), expected.size (), "Bad size");
+  std::vector<uint8_t> got (b.GetSize ());
+  b.CopyData (&got[0], got.size ());
+  for (uint32_t j = 0; j < got.size (); j++)
+    {
+      NS_TEST_ASSERT_MSG_EQ ((uint16_t)got[j], (uint16_t)expected[j], "Bad byte " << j);
+    }
+}
+
+void
+BufferZeroAreaTest::DoRun (void)
+{
+  Buffer::ResetMaterializationStats ();
+
+  // The larger zero area stays virtual, the smaller one is written out
+  Buffer a = MakeBuffer (1000, 0xaa, 0xa1);
+  Buffer b = MakeBuffer (100, 0xbb, 0xb1);
+  a.AddAtEnd (b);
+  std::vector<uint8_t> expected (2, 0xaa);
+  expected.resize (1002, 0);
+  expected.push_back (0xa1);
+  expected.resize (1005, 0xbb);
+  expected.resize (1105, 0);
+  expected.push_back (0xb1);
+  CheckBuffer (a, expected);
+  Buffer::MaterializationStats stats = Buffer::GetMaterializationStats ();
+  NS_TEST_ASSERT_MSG_EQ (stats.concatCount, 1, "Bad concatenation count");
+  NS_TEST_ASSERT_MSG_EQ (stats.concatBytes, 100, "Smaller zero area not the one materialized");
+  NS_TEST_ASSERT_MSG_LT (a.GetSerializedSize (), 1000, "Larger zero area materialized");
+
+  // Likewise when the larger zero area is in the appended buffer
+  Buffer c = MakeBuffer (10, 0xcc, 0xc1);
+  c.AddAtEnd (a);
+  std::vector<uint8_t> expectedC (2, 0xcc);
+  expectedC.resize (12, 0);
+  expectedC.push_back (0xc1);
+  expectedC.insert (expectedC.end (), expected.begin (), expected.end ());
+  CheckBuffer (c, expectedC);
+  stats = Buffer::GetMaterializationStats ();
+  NS_TEST_ASSERT_MSG_EQ (stats.concatCount, 2, "Bad concatenation count");
+  NS_TEST_ASSERT_MSG_EQ (stats.concatBytes, 110, "Smaller zero area not the one materialized");
+  NS_TEST_ASSERT_MSG_LT (c.GetSerializedSize (), 1000, "Larger zero area materialized");
+  // a is unchanged by being appended
+  CheckBuffer (a, expected);
+
+  // Appending real bytes materializes nothing
+  Buffer d = MakeBuffer (0, 0xdd, 0xd1);
+  c.AddAtEnd (d);
+  expectedC.push_back (0xdd);
+  expectedC.push_back (0xdd);
+  expectedC.push_back (0xd1);
+  CheckBuffer (c, expectedC);
+  NS_TEST_ASSERT_MSG_EQ (Buffer::GetMaterializationStats ().concatCount, 2, "Bad concatenation count");
+
+  // Appending a buffer to a copy of itself still works
+  Buffer e = MakeBuffer (20, 0xee, 0xe1);
+  Buffer f = e;
+  e.AddAtEnd (f);
+  std::vector<uint8_t> expectedE (2, 0xee);
+  expectedE.resize (22, 0);
+  expectedE.push_back (0xe1);
+  std::vector<uint8_t> once = expectedE;
+  expectedE.insert (expectedE.end (), once.begin (), once.end ());
+  CheckBuffer (e, expectedE);
+
+  stats = Buffer::GetMaterializationStats ();
+  uint64_t peeks = stats.peekDataCount;
+  a.PeekData ();
+  stats = Buffer::GetMaterializationStats ();
+  NS_TEST_ASSERT_MSG_EQ (stats.peekDataCount, peeks + 1, "PeekData not counted");
+  NS_TEST_ASSERT_MSG_EQ (stats.peekDataBytes, 1000, "PeekData bytes not counted");
+
+  Buffer::ResetMaterializationStats ();
+  NS_TEST_ASSERT_MSG_EQ (Buffer::GetMaterializationStats ().concatBytes, 0, "Stats not reset");
+}
+//-----------------------------------------------------------------------------
+class BufferPoolTest : public TestCase {
+public:
+  virtual void DoRun (void);
+  BufferPoolTest ();
+private:
+  void MakeBuffers (void);
+  Buffer::PoolStats m_threadStats;
+};
+
+BufferPoolTest::BufferPoolTest ()
+  : TestCase ("Buffer size-class pools")
+{
+}
+
+void
+BufferPoolTest::MakeBuffers (void)
+{
+  std::vector<Buffer> buffers;
+  for (uint32_t i = 0; i < 16; i++)
+    {
+      Buffer b;
+      b.AddAtEnd (100 + i * 200);
+      b.AddAtStart (40);
+      buffers.push_back (b);
+    }
+  m_threadStats = Buffer::GetPoolStats ();
+}
+
+void
+BufferPoolTest::DoRun (void)
+{
+#ifdef BUFFER_FREE_LIST
+  Buffer::ResetPoolStats ();
+  Buffer::PoolStats before = Buffer::GetPoolStats ();
+  NS_TEST_ASSERT_MSG_EQ (before.hits + before.misses + before.oversized, 0, "Stats not reset");
+
+  // A jumbo buffer is allocated and released outside the size classes
+  {
+    Buffer jumbo;
+    jumbo.AddAtEnd (200000);
+  }
+  Buffer::PoolStats stats = Buffer::GetPoolStats ();
+  NS_TEST_ASSERT_MSG_EQ (stats.oversized, 1, "Jumbo buffer not counted");
+  NS_TEST_ASSERT_MSG_LT (stats.bytesPooled, before.bytesPooled + 200000, "Jumbo buffer kept in a pool");
+  NS_TEST_ASSERT_MSG_GT_OR_EQ (stats.peakBytesInUse, 200000, "Jumbo buffer not in the peak");
+
+  // Small buffers are still served from their own size class afterwards
+  MakeBuffers ();
+  stats = Buffer::GetPoolStats ();
+  NS_TEST_ASSERT_MSG_EQ (stats.bytesInUse, before.bytesInUse, "Blocks not returned");
+  MakeBuffers ();
+  Buffer::PoolStats again = Buffer::GetPoolStats ();
+  NS_TEST_ASSERT_MSG_EQ (again.misses, stats.misses, "Recycled blocks not reused");
+  NS_TEST_ASSERT_MSG_GT (again.hits, stats.hits, "No pool hit");
+  NS_TEST_ASSERT_MSG_EQ (again.oversized, 1, "Small buffers counted as oversized");
+  NS_TEST_ASSERT_MSG_EQ (again.bytesInUse, before.bytesInUse, "Blocks not returned");
+
+#ifdef HAVE_PTHREAD_H
+  // Another thread uses its own pool and counters
+  Ptr<SystemThread> thread = Create<SystemThread> (MakeCallback (&BufferPoolTest::MakeBuffers, this));
+  thread->Start ();
+  thread->Join ();
+  NS_TEST_ASSERT_MSG_GT (m_threadStats.misses, 0, "Thread allocations not counted");
+  NS_TEST_ASSERT_MSG_LT (m_threadStats.hits + m_threadStats.misses, again.hits + again.misses,
+                         "Thread pool shared with the main thread");
+  Buffer::PoolStats after = Buffer::GetPoolStats ();
+  NS_TEST_ASSERT_MSG_EQ (after.hits, again.hits, "Thread counted in the main thread pool");
+  NS_TEST_ASSERT_MSG_EQ (after.misses, again.misses, "Thread counted in the main thread pool");
+#endif
+
+  Buffer::ResetPoolStats ();
+  stats = Buffer::GetPoolStats ();
+  NS_TEST_ASSERT_MSG_EQ (stats.hits, 0, "Stats not reset");
+  NS_TEST_ASSERT_MSG_EQ (stats.peakBytesInUse, stats.bytesInUse, "Peak not reset");
+#endif /* BUFFER_FREE_LIST */
+}
+//-----------------------------------------------------------------------------
 class BufferTestSuite : public TestSuite
 {
 public:
@@ -371,6 +561,8 @@ BufferTestSuite::BufferTestSuite ()
   : TestSuite ("buffer", UNIT)
 {
   AddTestCase (new BufferTest, TestCase::QUICK);
+  AddTestCase (new BufferZeroAreaTest, TestCase::QUICK);
+  AddTestCase (new BufferPoolTest, TestCase::QUICK);
 }
 
 static BufferTestSuite g_bufferTestSuite;
@@ -19,6 +19,8 @@
 #include "ns3/test.h"
 #include "ns3/drop-tail-queue.h"
 #include "ns3/uinteger.h"
+#include "ns3/enum.h"
+#include <vector>
 
 using namespace ns3;
 
@@ -77,6 +79,78 @@ DropTailQueueTestCase::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ ((item == 0), true, "There are really no packets in there");
 }
 
+class DropTailQueueRingTestCase : public TestCase
+{
+public:
+  DropTailQueueRingTestCase ();
+  virtual void DoRun (void);
+  /**
+   * Run the packets through the queue
+   * \param queue the queue
+   * \param packets the packets
+   */
+  void Check (Ptr<DropTailQueue> queue, const std::vector<Ptr<Packet> > &packets);
+};
+
+DropTailQueueRingTestCase::DropTailQueueRingTestCase ()
+  : TestCase ("Check the order of the items when the ring buffer wraps around and grows")
+{
+}
+void
+DropTailQueueRingTestCase::DoRun (void)
+{
+  std::vector<Ptr<Packet> > packets;
+  for (uint32_t i = 0; i < 200; i++)
+    {
+      packets.push_back (Create<Packet> (i));
+    }
+
+  // in packet mode the ring has room for MaxPackets items from the
+  // start and wraps around, in byte mode it also grows
+  for (uint32_t mode = 0; mode < 2; mode++)
+    {
+      Ptr<DropTailQueue> queue = CreateObject<DropTailQueue> ();
+      if (mode == 0)
+        {
+          queue->SetAttribute ("MaxPackets", UintegerValue (100));
+        }
+      else
+        {
+          queue->SetAttribute ("Mode", EnumValue (Queue::QUEUE_MODE_BYTES));
+          queue->SetAttribute ("MaxBytes", UintegerValue (1000000));
+        }
+      Check (queue, packets);
+    }
+}
+void
+DropTailQueueRingTestCase::Check (Ptr<DropTailQueue> queue, const std::vector<Ptr<Packet> > &packets)
+{
+  // enqueue three items for every two dequeued
+  uint32_t in = 0;
+  uint32_t out = 0;
+  while (in < packets.size ())
+    {
+      for (uint32_t j = 0; j < 3 && in < packets.size (); j++)
+        {
+          NS_TEST_EXPECT_MSG_EQ (queue->Enqueue (Create<QueueItem> (packets[in++])), true, "Enqueue failed");
+        }
+      for (uint32_t j = 0; j < 2; j++)
+        {
+          NS_TEST_EXPECT_MSG_EQ (queue->Peek ()->GetPacket (), packets[out], "Peek returns the wrong item");
+          Ptr<QueueItem> item = queue->Dequeue ();
+          NS_TEST_EXPECT_MSG_EQ (item->GetPacket (), packets[out], "Dequeue returns the wrong item");
+          out++;
+        }
+      NS_TEST_EXPECT_MSG_EQ (queue->GetNPackets (), in - out, "Wrong number of packets");
+    }
+
+  // the items still in the queue are released when it is disposed
+  NS_TEST_EXPECT_MSG_EQ (packets.back ()->GetReferenceCount (), 2, "The queued item does not hold the packet");
+  queue->Dispose ();
+  NS_TEST_EXPECT_MSG_EQ (packets.back ()->GetReferenceCount (), 1, "The queued item was not released");
+  NS_TEST_EXPECT_MSG_EQ (packets.front ()->GetReferenceCount (), 1, "The dequeued item was not released");
+}
+
 static class DropTailQueueTestSuite : public TestSuite
 {
 public:
@@ -84,5 +158,6 @@ public:
     : TestSuite ("drop-tail-queue", UNIT)
   {
     AddTestCase (new DropTailQueueTestCase (), TestCase::QUICK);
+    AddTestCase (new DropTailQueueRingTestCase (), TestCase::QUICK);
   }
 } g_dropTailQueueTestSuite;
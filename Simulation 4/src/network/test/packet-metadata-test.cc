@@ -835,4 +835,6 @@ PacketMetadataTestSuite::PacketMetadataTestSuite ()
   AddTestCase (new PacketMetadataTest, TestCase::QUICK);
 }
 
+#ifndef NS3_PACKET_METADATA_DISABLE
 PacketMetadataTestSuite g_packetMetadataTest;
+#endif
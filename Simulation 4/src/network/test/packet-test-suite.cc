@@ -806,6 +806,29 @@ PacketTagListTest::DoRun (void)
     ReplaceCheck (7);
   }
   
+  { // Sharing
+    std::cout << GetName () << "check copies share storage" << std::endl;
+    PacketTagList ptl = ref;
+    NS_TEST_EXPECT_MSG_EQ (ptl.Begin (), ref.Begin (), "copy did not share the tags");
+    PacketTagList removed = ptl;
+    ATestTag<8> t8 (1);
+    removed.Remove (t7);
+    NS_TEST_EXPECT_MSG_NE (removed.Begin (), ref.Begin (), "remove wrote into shared tags");
+    CheckRefList (ptl, "shared copy after remove", 0);
+    PacketTagList a;
+    a.Add (t1);
+    PacketTagList b = a;
+    b.Add (t2);             // appends in place
+    NS_TEST_EXPECT_MSG_EQ (b.Begin (), a.Begin (), "append did not share the tags");
+    a.Add (t8);             // b wrote past a's last tag: copy
+    NS_TEST_EXPECT_MSG_NE (b.Begin (), a.Begin (), "append overwrote a shared tag");
+    CheckRef (a, t1, "diverged copy", false);
+    CheckRef (a, t2, "diverged copy", true);
+    CheckRef (a, t8, "diverged copy", false);
+    CheckRef (b, t2, "diverged original", false);
+    CheckRef (b, t8, "diverged original", true);
+  }
+
   { // Timing
     std::cout << GetName () << "add+remove timing" << std::endl;
     int flm = std::numeric_limits<int>::max ();
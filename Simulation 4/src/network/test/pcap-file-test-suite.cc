@@ -25,6 +25,8 @@
 #include "ns3/log.h"
 #include "ns3/test.h"
 #include "ns3/pcap-file.h"
+#include "ns3/mapped-pcap-file.h"
+#include "ns3/packet.h"
 
 using namespace ns3;
 
@@ -1121,6 +1123,227 @@ DiffTestCase::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ (usec, 3696, "Files are different from 2.3696 seconds");
 }
 
+// ===========================================================================
+// Test case to make sure that a pcap file written in batches, from a
+// background thread, is the same as one written packet by packet.
+// ===========================================================================
+class BatchedWriteTestCase : public TestCase
+{
+public:
+  BatchedWriteTestCase ();
+
+private:
+  virtual void DoSetup (void);
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+
+  /**
+   * Copy the packets of known.pcap to a file opened with OpenBatched.
+   * \param filename the name of the copy
+   * \param compression the compression of the copy
+   * \param snapLen the snap length of the copy
+   */
+  void Copy (std::string filename, BatchedFileWriter::Compression compression,
+             uint32_t snapLen);
+
+  std::string m_testFilename;
+};
+
+BatchedWriteTestCase::BatchedWriteTestCase ()
+  : TestCase ("Check that PcapFile::OpenBatched writes the same file as PcapFile::Open")
+{
+}
+
+void
+BatchedWriteTestCase::DoSetup (void)
+{
+  std::stringstream filename;
+  uint32_t n = rand ();
+  filename << n;
+  m_testFilename = CreateTempDirFilename (filename.str () + ".pcap");
+}
+
+void
+BatchedWriteTestCase::DoTeardown (void)
+{
+  if (remove (m_testFilename.c_str ()))
+    {
+      NS_LOG_ERROR ("Failed to delete file " << m_testFilename);
+    }
+}
+
+void
+BatchedWriteTestCase::Copy (std::string filename, BatchedFileWriter::Compression compression,
+                            uint32_t snapLen)
+{
+  PcapFile in;
+  in.Open (CreateDataDirFilename ("known.pcap"), std::ios::in);
+  NS_TEST_ASSERT_MSG_EQ (in.Fail (), false, "Open of known.pcap returns error");
+
+  PcapFile out;
+  out.OpenBatched (filename, compression);
+  NS_TEST_ASSERT_MSG_EQ (out.Fail (), false, "OpenBatched (" << filename << ") returns error");
+  out.Init (in.GetDataLinkType (), snapLen, in.GetTimeZoneOffset ());
+
+  uint8_t data[PcapFile::SNAPLEN_DEFAULT];
+  uint32_t tsSec, tsUsec, inclLen, origLen, readLen;
+  for (uint32_t i = 0; i < N_KNOWN_PACKETS; ++i)
+    {
+      in.Read (data, sizeof (data), tsSec, tsUsec, inclLen, origLen, readLen);
+      NS_TEST_ASSERT_MSG_EQ (in.Fail (), false, "Read() of known good pcap file returns error");
+      out.Write (tsSec, tsUsec, data, origLen);
+    }
+  out.Close ();
+  NS_TEST_EXPECT_MSG_EQ (out.Fail (), false, "Batched writes return error");
+  NS_TEST_EXPECT_MSG_EQ (out.GetDroppedRecords (), 0, "Packets dropped from a short file");
+}
+
+void
+BatchedWriteTestCase::DoRun (void)
+{
+  //
+  // A full copy must not differ from the original
+  //
+  std::string known = CreateDataDirFilename ("known.pcap");
+  Copy (m_testFilename, BatchedFileWriter::COMPRESSION_NONE, PcapFile::SNAPLEN_DEFAULT);
+  uint32_t sec (0), usec (0), packets (0);
+  bool diff = PcapFile::Diff (known, m_testFilename, sec, usec, packets);
+  NS_TEST_EXPECT_MSG_EQ (diff, false, "Batched copy of known.pcap differs from it");
+  NS_TEST_EXPECT_MSG_EQ (packets, N_KNOWN_PACKETS, "Batched copy of known.pcap misses packets");
+
+  //
+  // With a small snap length, only the start of each packet is written
+  //
+  Copy (m_testFilename, BatchedFileWriter::COMPRESSION_NONE, N_PACKET_BYTES);
+  PcapFile f;
+  f.Open (m_testFilename, std::ios::in);
+  NS_TEST_ASSERT_MSG_EQ (f.Fail (), false, "Open of the snapped copy returns error");
+  uint8_t data[PcapFile::SNAPLEN_DEFAULT];
+  uint32_t tsSec, tsUsec, inclLen, origLen, readLen;
+  for (uint32_t i = 0; i < N_KNOWN_PACKETS; ++i)
+    {
+      f.Read (data, sizeof (data), tsSec, tsUsec, inclLen, origLen, readLen);
+      NS_TEST_ASSERT_MSG_EQ (f.Fail (), false, "Read() of the snapped copy returns error");
+      NS_TEST_EXPECT_MSG_EQ (inclLen, N_PACKET_BYTES, "Packet not snapped");
+      NS_TEST_EXPECT_MSG_EQ (origLen, knownPackets[i].origLen, "Original length lost");
+    }
+  f.Close ();
+
+  //
+  // A compressed copy starts with the gzip magic number
+  //
+  if (BatchedFileWriter::IsCompressionSupported (BatchedFileWriter::COMPRESSION_GZIP))
+    {
+      Copy (m_testFilename, BatchedFileWriter::COMPRESSION_GZIP, PcapFile::SNAPLEN_DEFAULT);
+      FILE *p = std::fopen (m_testFilename.c_str (), "rb");
+      NS_TEST_ASSERT_MSG_NE (p, 0, "Compressed copy not created");
+      int b0 = std::fgetc (p);
+      int b1 = std::fgetc (p);
+      std::fclose (p);
+      NS_TEST_EXPECT_MSG_EQ (b0, 0x1f, "Compressed copy is not a gzip file");
+      NS_TEST_EXPECT_MSG_EQ (b1, 0x8b, "Compressed copy is not a gzip file");
+    }
+}
+
+// ===========================================================================
+// Test case to make sure that MappedPcapFile indexes a known good pcap file
+// and gives random access to its records.
+// ===========================================================================
+class MappedReadTestCase : public TestCase
+{
+public:
+  MappedReadTestCase ();
+
+private:
+  virtual void DoSetup (void);
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+
+  std::string m_testFilename;
+};
+
+MappedReadTestCase::MappedReadTestCase ()
+  : TestCase ("Check that MappedPcapFile gives random access to a known good pcap file")
+{
+}
+
+void
+MappedReadTestCase::DoSetup (void)
+{
+  std::stringstream filename;
+  uint32_t n = rand ();
+  filename << n;
+  m_testFilename = CreateTempDirFilename (filename.str () + ".pcap");
+}
+
+void
+MappedReadTestCase::DoTeardown (void)
+{
+  if (remove (m_testFilename.c_str ()))
+    {
+      NS_LOG_ERROR ("Failed to delete file " << m_testFilename);
+    }
+}
+
+void
+MappedReadTestCase::DoRun (void)
+{
+  std::string known = CreateDataDirFilename ("known.pcap");
+  MappedPcapFile f;
+  NS_TEST_ASSERT_MSG_EQ (f.Open (known), true, "Open (" << known << ") returns error");
+  NS_TEST_ASSERT_MSG_EQ (f.Fail (), false, "known.pcap found truncated");
+  NS_TEST_ASSERT_MSG_EQ (f.GetNRecords (), N_KNOWN_PACKETS, "Wrong number of records in known.pcap");
+
+  //
+  // Visit the records backwards, to make sure the order does not matter
+  //
+  for (uint32_t i = N_KNOWN_PACKETS; i-- > 0; )
+    {
+      PacketEntry const & p = knownPackets[i];
+      uint32_t tsSec, tsUsec;
+      f.GetTimestamp (i, tsSec, tsUsec);
+      NS_TEST_EXPECT_MSG_EQ (tsSec, p.tsSec, "Incorrect seconds timestamp of record " << i);
+      NS_TEST_EXPECT_MSG_EQ (tsUsec, p.tsUsec, "Incorrect microseconds timestamp of record " << i);
+      NS_TEST_EXPECT_MSG_EQ (f.GetTime (i), Seconds (p.tsSec) + MicroSeconds (p.tsUsec),
+                             "Incorrect time of record " << i);
+      NS_TEST_EXPECT_MSG_EQ (f.GetInclLen (i), p.inclLen, "Incorrect included length of record " << i);
+      NS_TEST_EXPECT_MSG_EQ (f.GetOrigLen (i), p.origLen, "Incorrect original length of record " << i);
+      // the known data starts after the 14 bytes of the Ethernet header
+      uint8_t const *data = f.GetData (i) + 14;
+      for (uint32_t j = 0; j < N_PACKET_BYTES; ++j)
+        {
+          NS_TEST_EXPECT_MSG_EQ (static_cast<uint32_t> (data[2 * j]), static_cast<uint32_t> (p.data[j] >> 8), "Incorrect data in record " << i);
+          NS_TEST_EXPECT_MSG_EQ (static_cast<uint32_t> (data[2 * j + 1]), static_cast<uint32_t> (p.data[j] & 0xff), "Incorrect data in record " << i);
+        }
+      Ptr<Packet> packet = f.GetPacket (i);
+      NS_TEST_EXPECT_MSG_EQ (packet->GetSize (), p.origLen, "Incorrect size of the packet of record " << i);
+    }
+
+  //
+  // Find returns the first record at or after a time
+  //
+  NS_TEST_EXPECT_MSG_EQ (f.Find (Seconds (0)), 0, "Find before the first record");
+  NS_TEST_EXPECT_MSG_EQ (f.Find (Seconds (2) + MicroSeconds (3801)), 2, "Find at a record");
+  NS_TEST_EXPECT_MSG_EQ (f.Find (Seconds (2) + MicroSeconds (3802)), 3, "Find between two records");
+  NS_TEST_EXPECT_MSG_EQ (f.Find (Seconds (3)), N_KNOWN_PACKETS, "Find after the last record");
+  f.Close ();
+
+  //
+  // A file cut in the middle of its last record keeps the complete ones
+  //
+  std::ifstream in (known.c_str (), std::ios::in | std::ios::binary);
+  std::string bytes ((std::istreambuf_iterator<char> (in)), std::istreambuf_iterator<char> ());
+  std::ofstream out (m_testFilename.c_str (), std::ios::out | std::ios::binary);
+  out.write (bytes.data (), bytes.size () - 10);
+  out.close ();
+  NS_TEST_ASSERT_MSG_EQ (f.Open (m_testFilename), true, "Open of a truncated file returns error");
+  NS_TEST_EXPECT_MSG_EQ (f.Fail (), true, "Truncated file not detected");
+  NS_TEST_EXPECT_MSG_EQ (f.GetNRecords (), N_KNOWN_PACKETS - 1, "Wrong number of records in a truncated file");
+  uint32_t sec (0), usec (0), packets (0);
+  NS_TEST_EXPECT_MSG_EQ (PcapFile::Diff (known, m_testFilename, sec, usec, packets), true,
+                         "PcapDiff(file, truncated file) must be true");
+}
+
 class PcapFileTestSuite : public TestSuite
 {
 public:
@@ -1138,6 +1361,8 @@ PcapFileTestSuite::PcapFileTestSuite ()
   AddTestCase (new RecordHeaderTestCase, TestCase::QUICK);
   AddTestCase (new ReadFileTestCase, TestCase::QUICK);
   AddTestCase (new DiffTestCase, TestCase::QUICK);
+  AddTestCase (new BatchedWriteTestCase, TestCase::QUICK);
+  AddTestCase (new MappedReadTestCase, TestCase::QUICK);
 }
 
 static PcapFileTestSuite pcapFileTestSuite;
@@ -0,0 +1,467 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cstring>
+#include <cstdlib>
+#include "ns3/assert.h"
+#include "ns3/log.h"
+#include "ns3/core-config.h"
+#include "batched-file-writer.h"
+
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#include "ns3/callback.h"
+#include "ns3/system-thread.h"
+#endif /* HAVE_PTHREAD_H */
+
+#ifdef NS3_ZLIB
+#include <zlib.h>
+#endif /* NS3_ZLIB */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("BatchedFileWriter");
+
+#ifdef HAVE_PTHREAD_H
+/**
+ * The threads test the shared state and wait under the same mutex, so
+ * that no signal can be lost between the test and the wait, which
+ * SystemCondition does not allow.
+ */
+struct BatchedFileWriter::Sync
+{
+  pthread_mutex_t mutex;  //!< protects the fields the two threads share
+  pthread_cond_t wakeup;  //!< signaled when a batch is submitted or the thread must stop
+  pthread_cond_t drained; //!< signaled when a batch has been written
+};
+
+namespace {
+
+/**
+ * \ingroup network
+ * Hold a pthread mutex for the lifetime of this object.
+ */
+class SyncLock
+{
+public:
+  /**
+   * Lock the mutex.
+   * \param mutex the mutex.
+   */
+  SyncLock (pthread_mutex_t &mutex)
+    : m_mutex (mutex)
+  {
+    pthread_mutex_lock (&m_mutex);
+  }
+  /// Unlock the mutex.
+  ~SyncLock ()
+  {
+    pthread_mutex_unlock (&m_mutex);
+  }
+
+private:
+  pthread_mutex_t &m_mutex; //!< the mutex held
+};
+
+} // anonymous namespace
+#endif /* HAVE_PTHREAD_H */
+
+BatchedFileWriter::BatchedFileWriter ()
+  : m_gzFile (0),
+    m_isOpen (false),
+    m_failed (false),
+    m_async (false),
+    m_batchSize (BATCH_SIZE_DEFAULT),
+    m_maxBatches (MAX_BATCHES_DEFAULT),
+    m_batches (0),
+    m_dropped (0),
+    m_current (0),
+    m_writing (false),
+    m_stopping (false),
+    m_thread (0),
+    m_sync (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+BatchedFileWriter::~BatchedFileWriter ()
+{
+  NS_LOG_FUNCTION (this);
+  Close ();
+}
+
+bool
+BatchedFileWriter::IsCompressionSupported (enum Compression compression)
+{
+  NS_LOG_FUNCTION (compression);
+  switch (compression)
+    {
+    case COMPRESSION_NONE:
+      return true;
+    case COMPRESSION_GZIP:
+#ifdef NS3_ZLIB
+      return true;
+#else
+      return false;
+#endif /* NS3_ZLIB */
+    }
+  return false;
+}
+
+void
+BatchedFileWriter::Open (std::string const &filename, enum Compression compression,
+                         bool async, uint32_t batchSize, uint32_t maxBatches)
+{
+  NS_LOG_FUNCTION (this << filename << compression << async << batchSize << maxBatches);
+  NS_ASSERT (!m_isOpen);
+  NS_ASSERT (batchSize > 0 && maxBatches > 0);
+
+  m_isOpen = true;
+  m_failed = false;
+  m_batchSize = batchSize;
+  m_maxBatches = maxBatches;
+  m_dropped = 0;
+
+  if (compression == COMPRESSION_GZIP)
+    {
+#ifdef NS3_ZLIB
+      // favour speed: the file is written while the simulation runs
+      m_gzFile = gzopen (filename.c_str (), "wb1");
+      m_failed = m_gzFile == 0;
+#else
+      NS_LOG_WARN ("gzip compression requires zlib, which this build lacks");
+      m_failed = true;
+#endif /* NS3_ZLIB */
+    }
+  else
+    {
+      m_file.open (filename.c_str (), std::ios::out | std::ios::binary | std::ios::trunc);
+      m_failed = m_file.fail ();
+    }
+
+  m_async = false;
+  if (async)
+    {
+#ifdef HAVE_PTHREAD_H
+      m_async = true;
+      m_writing = false;
+      m_stopping = false;
+      m_sync = new Sync;
+      pthread_mutex_init (&m_sync->mutex, 0);
+      pthread_cond_init (&m_sync->wakeup, 0);
+      pthread_cond_init (&m_sync->drained, 0);
+      m_thread = new SystemThread (MakeCallback (&BatchedFileWriter::DoWrite, this));
+      m_thread->Start ();
+#else
+      NS_LOG_WARN ("No threads in this build, writing " << filename << " synchronously");
+#endif /* HAVE_PTHREAD_H */
+    }
+}
+
+bool
+BatchedFileWriter::IsOpen (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_isOpen;
+}
+
+bool
+BatchedFileWriter::Fail (void) const
+{
+  NS_LOG_FUNCTION (this);
+#ifdef HAVE_PTHREAD_H
+  if (m_async)
+    {
+      SyncLock lock (m_sync->mutex);
+      return m_failed;
+    }
+#endif /* HAVE_PTHREAD_H */
+  return m_failed;
+}
+
+uint64_t
+BatchedFileWriter::GetDroppedRecords (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_dropped;
+}
+
+BatchedFileWriter::Batch *
+BatchedFileWriter::GetBatch (void)
+{
+  NS_LOG_FUNCTION (this);
+  Batch *batch = 0;
+#ifdef HAVE_PTHREAD_H
+  if (m_async)
+    {
+      SyncLock lock (m_sync->mutex);
+      if (!m_free.empty ())
+        {
+          batch = m_free.back ();
+          m_free.pop_back ();
+        }
+    }
+  else
+#endif /* HAVE_PTHREAD_H */
+  if (!m_free.empty ())
+    {
+      batch = m_free.back ();
+      m_free.pop_back ();
+    }
+  if (batch == 0 && (m_batches < m_maxBatches || !m_async))
+    {
+      batch = new Batch;
+      batch->data = static_cast<uint8_t *> (std::malloc (m_batchSize));
+      batch->size = 0;
+      batch->capacity = m_batchSize;
+      m_batches++;
+    }
+  return batch;
+}
+
+uint8_t *
+BatchedFileWriter::Reserve (uint32_t size)
+{
+  NS_LOG_FUNCTION (this << size);
+  NS_ASSERT (m_isOpen);
+  if (m_current != 0 && m_current->size + size > m_current->capacity)
+    {
+      Submit (m_current);
+      m_current = 0;
+    }
+  if (m_current == 0)
+    {
+      m_current = GetBatch ();
+      if (m_current == 0)
+        {
+          NS_LOG_LOGIC ("writer thread behind, dropping a record of " << size << " bytes");
+          m_dropped++;
+          return 0;
+        }
+    }
+  if (size > m_current->capacity)
+    {
+      // only for records larger than a batch, which get a batch of their own
+      m_current->data = static_cast<uint8_t *> (std::realloc (m_current->data, size));
+      m_current->capacity = size;
+    }
+  uint8_t *area = m_current->data + m_current->size;
+  m_current->size += size;
+  return area;
+}
+
+bool
+BatchedFileWriter::Write (uint8_t const *data, uint32_t size)
+{
+  NS_LOG_FUNCTION (this << &data << size);
+  uint8_t *area = Reserve (size);
+  if (area == 0)
+    {
+      return false;
+    }
+  std::memcpy (area, data, size);
+  return true;
+}
+
+void
+BatchedFileWriter::Submit (Batch *batch)
+{
+  NS_LOG_FUNCTION (this << batch << batch->size);
+#ifdef HAVE_PTHREAD_H
+  if (m_async)
+    {
+      SyncLock lock (m_sync->mutex);
+      m_pending.push_back (batch);
+      pthread_cond_signal (&m_sync->wakeup);
+      return;
+    }
+#endif /* HAVE_PTHREAD_H */
+  WriteBatch (batch);
+  m_free.push_back (batch);
+}
+
+void
+BatchedFileWriter::WriteBatch (Batch *batch)
+{
+  NS_LOG_FUNCTION (this << batch << batch->size);
+  bool failed;
+  if (m_gzFile != 0)
+    {
+#ifdef NS3_ZLIB
+      failed = gzwrite (static_cast<gzFile> (m_gzFile), batch->data, batch->size) != static_cast<int> (batch->size);
+#else
+      failed = true;
+#endif /* NS3_ZLIB */
+    }
+  else
+    {
+      m_file.write (reinterpret_cast<const char *> (batch->data), batch->size);
+      failed = m_file.fail ();
+    }
+  batch->size = 0;
+  if (failed)
+    {
+#ifdef HAVE_PTHREAD_H
+      if (m_async)
+        {
+          SyncLock lock (m_sync->mutex);
+          m_failed = true;
+          return;
+        }
+#endif /* HAVE_PTHREAD_H */
+      m_failed = true;
+    }
+}
+
+void
+BatchedFileWriter::DoWrite (void)
+{
+  NS_LOG_FUNCTION (this);
+#ifdef HAVE_PTHREAD_H
+  while (true)
+    {
+      Batch *batch;
+      {
+        SyncLock lock (m_sync->mutex);
+        while (m_pending.empty () && !m_stopping)
+          {
+            pthread_cond_wait (&m_sync->wakeup, &m_sync->mutex);
+          }
+        if (m_pending.empty ())
+          {
+            // stopping, and all the batches are written
+            break;
+          }
+        batch = m_pending.front ();
+        m_pending.pop_front ();
+        m_writing = true;
+      }
+      WriteBatch (batch);
+      SyncLock lock (m_sync->mutex);
+      m_free.push_back (batch);
+      m_writing = false;
+      pthread_cond_signal (&m_sync->drained);
+    }
+#endif /* HAVE_PTHREAD_H */
+}
+
+void
+BatchedFileWriter::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (!m_isOpen)
+    {
+      return;
+    }
+  if (m_current != 0 && m_current->size > 0)
+    {
+      Submit (m_current);
+      m_current = 0;
+    }
+#ifdef HAVE_PTHREAD_H
+  if (m_async)
+    {
+      SyncLock lock (m_sync->mutex);
+      while (!m_pending.empty () || m_writing)
+        {
+          pthread_cond_wait (&m_sync->drained, &m_sync->mutex);
+        }
+    }
+#endif /* HAVE_PTHREAD_H */
+  // the writer thread is idle until the next Submit
+  if (m_gzFile != 0)
+    {
+#ifdef NS3_ZLIB
+      gzflush (static_cast<gzFile> (m_gzFile), Z_SYNC_FLUSH);
+#endif /* NS3_ZLIB */
+    }
+  else
+    {
+      m_file.flush ();
+    }
+}
+
+void
+BatchedFileWriter::Close (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (!m_isOpen)
+    {
+      return;
+    }
+  if (m_current != 0 && m_current->size > 0)
+    {
+      Submit (m_current);
+      m_current = 0;
+    }
+#ifdef HAVE_PTHREAD_H
+  if (m_async)
+    {
+      {
+        SyncLock lock (m_sync->mutex);
+        m_stopping = true;
+        pthread_cond_signal (&m_sync->wakeup);
+      }
+      m_thread->Join ();
+      delete m_thread;
+      pthread_cond_destroy (&m_sync->drained);
+      pthread_cond_destroy (&m_sync->wakeup);
+      pthread_mutex_destroy (&m_sync->mutex);
+      delete m_sync;
+      m_thread = 0;
+      m_sync = 0;
+      m_async = false;
+    }
+#endif /* HAVE_PTHREAD_H */
+  if (m_current != 0)
+    {
+      m_free.push_back (m_current);
+      m_current = 0;
+    }
+  NS_ASSERT (m_pending.empty ());
+  NS_ASSERT (m_free.size () == m_batches);
+  for (std::vector<Batch *>::iterator i = m_free.begin (); i != m_free.end (); ++i)
+    {
+      std::free ((*i)->data);
+      delete *i;
+    }
+  m_free.clear ();
+  m_batches = 0;
+
+  if (m_gzFile != 0)
+    {
+#ifdef NS3_ZLIB
+      if (gzclose (static_cast<gzFile> (m_gzFile)) != Z_OK)
+        {
+          m_failed = true;
+        }
+#endif /* NS3_ZLIB */
+      m_gzFile = 0;
+    }
+  else if (m_file.is_open ())
+    {
+      m_file.close ();
+      m_failed = m_failed || m_file.fail ();
+    }
+  m_file.clear ();
+  m_isOpen = false;
+  if (m_dropped > 0)
+    {
+      NS_LOG_WARN (m_dropped << " records dropped because the writer thread fell behind");
+    }
+}
+
+} // namespace ns3
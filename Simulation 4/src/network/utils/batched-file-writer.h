@@ -0,0 +1,188 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef BATCHED_FILE_WRITER_H
+#define BATCHED_FILE_WRITER_H
+
+#include <string>
+#include <fstream>
+#include <list>
+#include <vector>
+#include <stdint.h>
+
+namespace ns3 {
+
+class SystemThread;
+
+/**
+ * \ingroup network
+ *
+ * \brief Write a stream of records to a file in large batches.
+ *
+ * Records are copied into a batch buffer by the caller, with Reserve
+ * or Write.  A full batch is written to the file with a single call,
+ * either directly or, in asynchronous mode, by a background thread so
+ * that the caller never waits on the file system.  The output may be
+ * gzip-compressed on the way out when ns-3 was built with zlib.
+ *
+ * In asynchronous mode at most \c maxBatches batches are in flight.
+ * When the writer thread falls that far behind, the records that do
+ * not fit are dropped and counted rather than blocking the caller;
+ * see GetDroppedRecords.  Synchronous mode never drops records.
+ *
+ * The caller side of this class is not thread-safe: a single thread,
+ * normally the simulator thread, must make all the calls.
+ */
+class BatchedFileWriter
+{
+public:
+  /**
+   * \brief Compression applied to the output file.
+   */
+  enum Compression
+  {
+    COMPRESSION_NONE, //!< Plain file
+    COMPRESSION_GZIP  //!< gzip file, needs zlib
+  };
+
+  static const uint32_t BATCH_SIZE_DEFAULT = 256 * 1024; /**< Default size of a batch, in bytes */
+  static const uint32_t MAX_BATCHES_DEFAULT = 16;        /**< Default number of batches in flight */
+
+  BatchedFileWriter ();
+  ~BatchedFileWriter ();
+
+  /**
+   * \param compression a compression mode
+   * \return true if this build can write files with this compression
+   */
+  static bool IsCompressionSupported (enum Compression compression);
+
+  /**
+   * Create or truncate a file and get ready to write records to it.
+   *
+   * \param filename the name of the file.
+   * \param compression the compression of the file.
+   * \param async true to write the batches from a background thread.
+   * Ignored, with a warning, if ns-3 was built without threads.
+   * \param batchSize the size of a batch, in bytes.
+   * \param maxBatches the number of batches in flight in asynchronous
+   * mode, the one being filled included.
+   */
+  void Open (std::string const &filename,
+             enum Compression compression = COMPRESSION_NONE,
+             bool async = true,
+             uint32_t batchSize = BATCH_SIZE_DEFAULT,
+             uint32_t maxBatches = MAX_BATCHES_DEFAULT);
+  /**
+   * \return true between a call to Open and a call to Close.
+   */
+  bool IsOpen (void) const;
+  /**
+   * \return true if the file could not be opened or written.
+   */
+  bool Fail (void) const;
+
+  /**
+   * Make room for a record of the given size at the end of the file.
+   *
+   * The caller must fill the returned area, and do so before any other
+   * call to this object.
+   *
+   * \param size the size of the record, in bytes.
+   * \return the area to copy the record into, or zero if the record
+   * was dropped.
+   */
+  uint8_t *Reserve (uint32_t size);
+  /**
+   * Append a record to the file.
+   *
+   * \param data the record.
+   * \param size the size of the record, in bytes.
+   * \return false if the record was dropped.
+   */
+  bool Write (uint8_t const *data, uint32_t size);
+  /**
+   * Write all the records appended so far to the file and wait until
+   * they have been handed to the operating system.
+   */
+  void Flush (void);
+  /**
+   * Flush the file, stop the writer thread if any, and close the file.
+   */
+  void Close (void);
+
+  /**
+   * \return the number of records dropped since the file was opened
+   * because too many batches were in flight.
+   */
+  uint64_t GetDroppedRecords (void) const;
+
+private:
+  /**
+   * \brief A buffer of records written to the file as a whole.
+   */
+  struct Batch
+  {
+    uint8_t *data;     //!< the records
+    uint32_t size;     //!< bytes of records in data
+    uint32_t capacity; //!< allocated size of data
+  };
+
+  /**
+   * \return an empty batch, or zero if maxBatches are in flight.
+   */
+  Batch *GetBatch (void);
+  /**
+   * Write a batch, from this thread or from the writer thread.
+   * \param batch the batch to write.
+   */
+  void Submit (Batch *batch);
+  /**
+   * Write a batch to the file and make it available again.
+   * \param batch the batch to write.
+   */
+  void WriteBatch (Batch *batch);
+  /**
+   * Body of the writer thread: write the submitted batches until
+   * asked to stop.
+   */
+  void DoWrite (void);
+
+  /// The mutex and condition variables shared with the writer thread
+  struct Sync;
+
+  std::ofstream m_file;         //!< Uncompressed output
+  void *m_gzFile;               //!< Compressed output, a zlib gzFile
+  bool m_isOpen;                //!< true if opened and not closed yet
+  bool m_failed;                //!< true after an open or write error
+  bool m_async;                 //!< true if batches go to the writer thread
+  uint32_t m_batchSize;         //!< size of a batch
+  uint32_t m_maxBatches;        //!< number of batches in flight
+  uint32_t m_batches;           //!< number of batches allocated
+  uint64_t m_dropped;           //!< number of records dropped
+  Batch *m_current;             //!< batch being filled by the caller
+  std::list<Batch *> m_pending; //!< full batches, oldest first
+  std::vector<Batch *> m_free;  //!< batches available to fill
+  bool m_writing;               //!< true while the writer thread writes a batch
+  bool m_stopping;              //!< true once the writer thread must exit
+
+  SystemThread *m_thread;       //!< the writer thread
+  Sync *m_sync;                 //!< synchronization with the writer thread
+};
+
+} // namespace ns3
+
+#endif /* BATCHED_FILE_WRITER_H */
@@ -0,0 +1,276 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cstring>
+#include <fstream>
+#include "ns3/assert.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/packet.h"
+#include "binary-trace-file.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("BinaryTraceFile");
+
+using namespace BinaryTrace;
+
+/**
+ * \param length the length of a payload
+ * \return the length of the payload once padded
+ */
+static uint32_t
+PaddedLength (uint32_t length)
+{
+  return (length + 7) & ~7U;
+}
+
+BinaryTraceWriter::TextBuffer::TextBuffer (BinaryTraceWriter *writer)
+  : m_writer (writer)
+{
+}
+
+BinaryTraceWriter::TextBuffer::int_type
+BinaryTraceWriter::TextBuffer::overflow (int_type c)
+{
+  if (c == traits_type::eof ())
+    {
+      return traits_type::not_eof (c);
+    }
+  m_line.push_back (traits_type::to_char_type (c));
+  if (c == '\n')
+    {
+      sync ();
+    }
+  return c;
+}
+
+int
+BinaryTraceWriter::TextBuffer::sync (void)
+{
+  if (!m_line.empty ())
+    {
+      m_writer->RecordText (m_line);
+      m_line.clear ();
+    }
+  return 0;
+}
+
+BinaryTraceWriter::BinaryTraceWriter (std::string filename)
+  : m_cache (CACHE_SIZE),
+    m_textBuffer (this),
+    m_textStream (&m_textBuffer)
+{
+  NS_LOG_FUNCTION (this << filename);
+  // synchronous: a dropped record would break the packet references
+  m_writer.Open (filename, BatchedFileWriter::COMPRESSION_NONE, false);
+  uint32_t fileHeader[FILE_HEADER_SIZE / 4] = { MAGIC, VERSION, 0, 0 };
+  m_writer.Write (reinterpret_cast<uint8_t const *> (fileHeader), FILE_HEADER_SIZE);
+}
+
+BinaryTraceWriter::~BinaryTraceWriter ()
+{
+  NS_LOG_FUNCTION (this);
+  m_textStream.flush ();
+  m_writer.Close ();
+}
+
+bool
+BinaryTraceWriter::Fail (void) const
+{
+  return m_writer.Fail ();
+}
+
+std::ostream *
+BinaryTraceWriter::GetStream (void)
+{
+  return &m_textStream;
+}
+
+void
+BinaryTraceWriter::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_textStream.flush ();
+  m_writer.Flush ();
+}
+
+void
+BinaryTraceWriter::Record (char event, Ptr<const Packet> p)
+{
+  NS_LOG_FUNCTION (this << event << p);
+  DoRecord (event, 0, 0, p);
+}
+
+void
+BinaryTraceWriter::Record (char event, std::string const &context, Ptr<const Packet> p)
+{
+  NS_LOG_FUNCTION (this << event << context << p);
+  DoRecord (event, FLAG_CONTEXT, Intern (context), p);
+}
+
+void
+BinaryTraceWriter::DoRecord (char event, uint8_t flags, uint32_t context, Ptr<const Packet> p)
+{
+  RecordHeader header;
+  header.type = event;
+  header.flags = flags;
+  header.reserved = 0;
+  header.context = context;
+  header.time = Simulator::Now ().GetSeconds ();
+  header.uid = p->GetUid ();
+  header.size = p->GetSize ();
+  header.length = 0;
+
+  uint32_t length = p->GetSerializedSize ();
+  m_scratch.resize (PaddedLength (length));
+  if (p->Serialize (&m_scratch[0], length) == 0)
+    {
+      NS_LOG_WARN ("cannot serialize packet " << header.uid);
+      Write (header, 0);
+      return;
+    }
+
+  //
+  // A packet is usually traced several times unchanged, when enqueued
+  // and dequeued for instance.  Only store it the first time.
+  //
+  CachedPacket &cached = m_cache[header.uid % CACHE_SIZE];
+  if (cached.uid == header.uid && cached.data.size () == length
+      && std::memcmp (&cached.data[0], &m_scratch[0], length) == 0)
+    {
+      header.flags |= FLAG_PACKET_REF;
+      Write (header, 0);
+      return;
+    }
+  cached.uid = header.uid;
+  cached.data.assign (m_scratch.begin (), m_scratch.begin () + length);
+  header.flags |= FLAG_PACKET;
+  header.length = length;
+  Write (header, &m_scratch[0]);
+}
+
+void
+BinaryTraceWriter::Write (RecordHeader const &header, uint8_t const *payload)
+{
+  uint32_t padded = PaddedLength (header.length);
+  uint8_t *area = m_writer.Reserve (sizeof (header) + padded);
+  NS_ASSERT (area != 0);
+  std::memcpy (area, &header, sizeof (header));
+  if (header.length > 0)
+    {
+      std::memcpy (area + sizeof (header), payload, header.length);
+      std::memset (area + sizeof (header) + header.length, 0, padded - header.length);
+    }
+}
+
+void
+BinaryTraceWriter::RecordText (std::string const &text)
+{
+  NS_LOG_FUNCTION (this << text);
+  RecordHeader header;
+  std::memset (&header, 0, sizeof (header));
+  header.flags = FLAG_TEXT;
+  header.time = Simulator::Now ().GetSeconds ();
+  header.length = text.size ();
+  Write (header, reinterpret_cast<uint8_t const *> (text.data ()));
+}
+
+uint32_t
+BinaryTraceWriter::Intern (std::string const &context)
+{
+  std::map<std::string, uint32_t>::const_iterator i = m_contexts.find (context);
+  if (i != m_contexts.end ())
+    {
+      return i->second;
+    }
+  uint32_t id = m_contexts.size ();
+  m_contexts[context] = id;
+  RecordHeader header;
+  std::memset (&header, 0, sizeof (header));
+  header.flags = FLAG_DEFINE_CONTEXT;
+  header.context = id;
+  header.length = context.size ();
+  Write (header, reinterpret_cast<uint8_t const *> (context.data ()));
+  return id;
+}
+
+bool
+BinaryTraceReader::Decode (std::string const &filename, std::ostream &os)
+{
+  NS_LOG_FUNCTION (filename);
+  std::ifstream file (filename.c_str (), std::ios::in | std::ios::binary);
+  uint32_t fileHeader[FILE_HEADER_SIZE / 4];
+  file.read (reinterpret_cast<char *> (fileHeader), FILE_HEADER_SIZE);
+  if (file.fail () || fileHeader[0] != MAGIC || fileHeader[1] != VERSION)
+    {
+      return false;
+    }
+
+  std::vector<std::string> contexts;
+  std::vector<std::pair<uint64_t, std::vector<uint8_t> > > cache (CACHE_SIZE);
+  std::vector<uint8_t> payload;
+  RecordHeader header;
+  while (file.read (reinterpret_cast<char *> (&header), sizeof (header)))
+    {
+      payload.resize (PaddedLength (header.length));
+      if (header.length > 0 && !file.read (reinterpret_cast<char *> (&payload[0]), payload.size ()))
+        {
+          return false;
+        }
+      if (header.flags & FLAG_DEFINE_CONTEXT)
+        {
+          if (header.context >= contexts.size ())
+            {
+              contexts.resize (header.context + 1);
+            }
+          contexts[header.context].assign (reinterpret_cast<char const *> (&payload[0]), header.length);
+          continue;
+        }
+      if (header.flags & FLAG_TEXT)
+        {
+          os.write (reinterpret_cast<char const *> (&payload[0]), header.length);
+          continue;
+        }
+
+      os << header.type << " " << header.time << " ";
+      if (header.flags & FLAG_CONTEXT)
+        {
+          NS_ASSERT (header.context < contexts.size ());
+          os << contexts[header.context] << " ";
+        }
+      std::pair<uint64_t, std::vector<uint8_t> > &cached = cache[header.uid % CACHE_SIZE];
+      if (header.flags & FLAG_PACKET)
+        {
+          cached.first = header.uid;
+          cached.second.assign (payload.begin (), payload.begin () + header.length);
+        }
+      if ((header.flags & (FLAG_PACKET | FLAG_PACKET_REF)) && cached.first == header.uid)
+        {
+          // the serialized packet must be 4-byte aligned
+          Ptr<Packet> p = Create<Packet> (&cached.second[0], cached.second.size (), true);
+          os << *p;
+        }
+      else
+        {
+          os << "(uid=" << header.uid << " size=" << header.size << ")";
+        }
+      os << std::endl;
+    }
+  return file.eof () && file.gcount () == 0;
+}
+
+} // namespace ns3
@@ -0,0 +1,249 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef BINARY_TRACE_FILE_H
+#define BINARY_TRACE_FILE_H
+
+#include <string>
+#include <map>
+#include <vector>
+#include <ostream>
+#include <streambuf>
+#include <stdint.h>
+#include "ns3/ptr.h"
+#include "ns3/simple-ref-count.h"
+#include "batched-file-writer.h"
+
+namespace ns3 {
+
+class Packet;
+
+/**
+ * \ingroup network
+ *
+ * \brief Layout of the binary trace files.
+ *
+ * A binary trace file is a 16-byte file header followed by records.
+ * Every record starts with a fixed-size RecordHeader, followed by
+ * \c length bytes of payload padded to a multiple of 8 bytes.  The
+ * fields are stored in the byte order of the host that wrote the
+ * file, which the magic number of the file header reveals.
+ *
+ * The records are told apart by their flags, never by their type,
+ * which is free for the event character:
+ *  - FLAG_DEFINE_CONTEXT: defines the string \c context as the
+ *    payload.  Context paths are written once and referred to by this
+ *    id afterwards.
+ *  - FLAG_TEXT: a piece of free-form text, written through the text
+ *    stream of the trace, reproduced verbatim by the decoder.
+ *  - neither: a packet event of type the event character, like the
+ *    '+', '-', 'd', 'r' and 't' events of the ascii traces.  The
+ *    payload, if any, is the packet as written by Packet::Serialize.
+ *    A FLAG_PACKET_REF event has no payload: its packet is the last
+ *    one stored with the same uid modulo CACHE_SIZE.
+ */
+namespace BinaryTrace {
+
+static const uint32_t MAGIC = 0x6e334254;     //!< "TB3n" read as a little-endian word
+static const uint32_t VERSION = 2;            //!< Version of the file format
+static const uint32_t FILE_HEADER_SIZE = 16;  //!< magic, version, 8 reserved bytes
+static const uint32_t CACHE_SIZE = 1024;      //!< Packets a FLAG_PACKET_REF may refer to
+
+/**
+ * \brief Flags of a record.
+ */
+enum Flags
+{
+  FLAG_CONTEXT = 0x01,        //!< the context field is set
+  FLAG_PACKET = 0x02,         //!< the payload is the serialized packet
+  FLAG_PACKET_REF = 0x04,     //!< the packet is the last one stored with this uid
+  FLAG_DEFINE_CONTEXT = 0x08, //!< the record defines a context string, not an event
+  FLAG_TEXT = 0x10            //!< the record is free-form text, not an event
+};
+
+/**
+ * \brief The fixed-size part of every record.
+ */
+struct RecordHeader
+{
+  uint8_t type;      //!< the event character, zero for the other records
+  uint8_t flags;     //!< a combination of Flags
+  uint16_t reserved; //!< zero
+  uint32_t context;  //!< id of the context string of the event
+  double time;       //!< simulation time of the event, in seconds
+  uint64_t uid;      //!< uid of the packet
+  uint32_t size;     //!< size of the packet
+  uint32_t length;   //!< length of the payload, before padding
+};
+
+} // namespace BinaryTrace
+
+/**
+ * \ingroup network
+ *
+ * \brief Write packet trace events to a compact binary file.
+ *
+ * This is the binary counterpart of the text written by the
+ * AsciiTraceHelper sinks.  Instead of printing every packet, each
+ * event is stored as a fixed-size record, context paths are interned,
+ * and the packet is stored with Packet::Serialize, once per uid for as
+ * long as it does not change: a packet enqueued and dequeued
+ * unchanged is stored only at the enqueue.  BinaryTraceReader turns
+ * the file back into the text the ascii sinks would have written.
+ *
+ * Anything written to GetStream is kept as text records, in order with
+ * the packet events.
+ */
+class BinaryTraceWriter : public SimpleRefCount<BinaryTraceWriter>
+{
+public:
+  /**
+   * Create or truncate a binary trace file.
+   * \param filename the name of the file.
+   */
+  BinaryTraceWriter (std::string filename);
+  ~BinaryTraceWriter ();
+
+  /**
+   * \return true if the file could not be opened or written.
+   */
+  bool Fail (void) const;
+
+  /**
+   * Record a packet event that has no context, at the current
+   * simulation time.
+   * \param event the event character, like '+' or 'r'.
+   * \param p the packet.
+   */
+  void Record (char event, Ptr<const Packet> p);
+  /**
+   * Record a packet event at the current simulation time.
+   * \param event the event character, like '+' or 'r'.
+   * \param context the context of the event.
+   * \param p the packet.
+   */
+  void Record (char event, std::string const &context, Ptr<const Packet> p);
+
+  /**
+   * \return a stream whose text is recorded in the file, each line in
+   * order with the packet events.
+   */
+  std::ostream *GetStream (void);
+
+  /**
+   * Write all the records to the file.
+   */
+  void Flush (void);
+
+private:
+  /**
+   * \brief Turn the text written to the stream into text records.
+   */
+  class TextBuffer : public std::streambuf
+  {
+  public:
+    /**
+     * \param writer the writer of the text records
+     */
+    TextBuffer (BinaryTraceWriter *writer);
+
+  protected:
+    /**
+     * Append a character, and record the line it ends.
+     * \param c the character
+     * \return c
+     */
+    virtual int_type overflow (int_type c);
+    /**
+     * Record the text not recorded yet.
+     * \return zero
+     */
+    virtual int sync (void);
+
+  private:
+    BinaryTraceWriter *m_writer; //!< the writer
+    std::string m_line;          //!< text not recorded yet
+  };
+
+  /**
+   * \brief The last packet stored with a uid.
+   */
+  struct CachedPacket
+  {
+    uint64_t uid;              //!< the uid of the packet
+    std::vector<uint8_t> data; //!< the serialized packet
+  };
+
+  /**
+   * Record a packet event.
+   * \param event the event character.
+   * \param flags FLAG_CONTEXT or zero.
+   * \param context the context id.
+   * \param p the packet.
+   */
+  void DoRecord (char event, uint8_t flags, uint32_t context, Ptr<const Packet> p);
+  /**
+   * Append a record to the file.
+   * \param header the record header, whose length is that of payload.
+   * \param payload the payload.
+   */
+  void Write (BinaryTrace::RecordHeader const &header, uint8_t const *payload);
+  /**
+   * Record a piece of text.
+   * \param text the text.
+   */
+  void RecordText (std::string const &text);
+  /**
+   * \param context a context string.
+   * \return its id, after writing its definition the first time.
+   */
+  uint32_t Intern (std::string const &context);
+
+  BatchedFileWriter m_writer;                 //!< the file
+  std::map<std::string, uint32_t> m_contexts; //!< ids of the contexts written
+  std::vector<CachedPacket> m_cache;          //!< the last packets stored, by uid modulo CACHE_SIZE
+  std::vector<uint8_t> m_scratch;             //!< the packet being serialized
+  TextBuffer m_textBuffer;                    //!< buffer of m_textStream
+  std::ostream m_textStream;                  //!< stream returned by GetStream
+};
+
+/**
+ * \ingroup network
+ *
+ * \brief Regenerate the ascii trace text of a binary trace file.
+ *
+ * Printing the packets needs the headers they carry to be registered,
+ * so the program that decodes a file must be linked with the modules
+ * of the simulation that wrote it.  A header that is not registered
+ * makes the decoding abort.
+ */
+class BinaryTraceReader
+{
+public:
+  /**
+   * Decode a binary trace file.
+   *
+   * \param filename the name of the file.
+   * \param os the stream to write the text to.
+   * \return false if the file is not a binary trace file or is
+   * truncated.  The records before the truncation are decoded.
+   */
+  static bool Decode (std::string const &filename, std::ostream &os);
+};
+
+} // namespace ns3
+
+#endif /* BINARY_TRACE_FILE_H */
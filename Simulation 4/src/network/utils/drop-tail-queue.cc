@@ -16,6 +16,7 @@
  * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#include <algorithm>
 #include "ns3/log.h"
 #include "drop-tail-queue.h"
 
@@ -25,6 +26,9 @@ NS_LOG_COMPONENT_DEFINE ("DropTailQueue");
 
 NS_OBJECT_ENSURE_REGISTERED (DropTailQueue);
 
+/// Most slots allocated up front in packet mode, the ring doubles beyond
+static const uint32_t MAX_PREALLOCATED_SLOTS = 65536;
+
 TypeId DropTailQueue::GetTypeId (void)
 {
   static TypeId tid = TypeId ("ns3::DropTailQueue")
@@ -37,7 +41,9 @@ TypeId DropTailQueue::GetTypeId (void)
 
 DropTailQueue::DropTailQueue () :
   Queue (),
-  m_packets ()
+  m_slots (),
+  m_head (0),
+  m_count (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -47,13 +53,54 @@ DropTailQueue::~DropTailQueue ()
   NS_LOG_FUNCTION (this);
 }
 
+void
+DropTailQueue::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_slots.clear ();
+  m_head = 0;
+  m_count = 0;
+  Queue::DoDispose ();
+}
+
+void
+DropTailQueue::Grow (void)
+{
+  NS_LOG_FUNCTION (this);
+  uint32_t size = m_slots.size ();
+  uint32_t needed = std::max (2 * size, m_count + 1);
+  if (GetMode () == QUEUE_MODE_PACKETS)
+    {
+      // Queue::Enqueue does not let more than MaxPackets items in
+      needed = std::max (needed, std::min (GetMaxPackets (), MAX_PREALLOCATED_SLOTS));
+    }
+  uint32_t newSize = 16;
+  while (newSize < needed)
+    {
+      newSize *= 2;
+    }
+  std::vector<Ptr<QueueItem> > slots (newSize);
+  for (uint32_t i = 0; i < m_count; i++)
+    {
+      slots[i] = m_slots[(m_head + i) & (size - 1)];
+    }
+  m_slots.swap (slots);
+  m_head = 0;
+  NS_LOG_LOGIC ("grown to " << m_slots.size () << " slots");
+}
+
 bool 
 DropTailQueue::DoEnqueue (Ptr<QueueItem> item)
 {
   NS_LOG_FUNCTION (this << item);
-  NS_ASSERT (m_packets.size () == GetNPackets ());
+  NS_ASSERT (m_count == GetNPackets ());
 
-  m_packets.push (item);
+  if (m_count == m_slots.size ())
+    {
+      Grow ();
+    }
+  m_slots[(m_head + m_count) & (m_slots.size () - 1)] = item;
+  m_count++;
 
   return true;
 }
@@ -62,10 +109,13 @@ Ptr<QueueItem>
 DropTailQueue::DoDequeue (void)
 {
   NS_LOG_FUNCTION (this);
-  NS_ASSERT (m_packets.size () == GetNPackets ());
+  NS_ASSERT (m_count == GetNPackets ());
+  NS_ASSERT (m_count > 0);
 
-  Ptr<QueueItem> item = m_packets.front ();
-  m_packets.pop ();
+  Ptr<QueueItem> item = m_slots[m_head];
+  m_slots[m_head] = 0;
+  m_head = (m_head + 1) & (m_slots.size () - 1);
+  m_count--;
 
   NS_LOG_LOGIC ("Popped " << item);
 
@@ -76,10 +126,10 @@ Ptr<const QueueItem>
 DropTailQueue::DoPeek (void) const
 {
   NS_LOG_FUNCTION (this);
-  NS_ASSERT (m_packets.size () == GetNPackets ());
+  NS_ASSERT (m_count == GetNPackets ());
+  NS_ASSERT (m_count > 0);
 
-  return m_packets.front ();
+  return m_slots[m_head];
 }
 
 } // namespace ns3
-
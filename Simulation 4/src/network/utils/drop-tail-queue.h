@@ -19,7 +19,7 @@
 #ifndef DROPTAIL_H
 #define DROPTAIL_H
 
-#include <queue>
+#include <vector>
 #include "ns3/queue.h"
 
 namespace ns3 {
@@ -28,6 +28,12 @@ namespace ns3 {
  * \ingroup queue
  *
  * \brief A FIFO packet queue that drops tail-end packets on overflow
+ *
+ * The items are kept in a ring buffer of slots.  In packet mode the
+ * ring is allocated at the first enqueue with room for MaxPackets
+ * items (up to 65536), so enqueue and dequeue never allocate nor free
+ * memory.  In byte mode the number of items is not bounded in advance,
+ * and the ring doubles when it is full.
  */
 class DropTailQueue : public Queue
 {
@@ -46,12 +52,27 @@ public:
 
   virtual ~DropTailQueue();
 
+protected:
+  virtual void DoDispose (void);
+
 private:
   virtual bool DoEnqueue (Ptr<QueueItem> item);
   virtual Ptr<QueueItem> DoDequeue (void);
   virtual Ptr<const QueueItem> DoPeek (void) const;
 
-  std::queue<Ptr<QueueItem> > m_packets; //!< the items in the queue
+  /**
+   * Make room for one more item: allocate MaxPackets slots in packet
+   * mode, or double the number of slots.
+   */
+  void Grow (void);
+
+  /**
+   * The slots of the ring buffer, a power of two of them.  The slots
+   * not in use are null.
+   */
+  std::vector<Ptr<QueueItem> > m_slots;
+  uint32_t m_head;  //!< the slot of the oldest item
+  uint32_t m_count; //!< the number of items in the queue
 };
 
 } // namespace ns3
@@ -0,0 +1,312 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cstring>
+#include <fstream>
+#include "ns3/assert.h"
+#include "ns3/log.h"
+#include "ns3/packet.h"
+#include "mapped-pcap-file.h"
+
+#ifdef HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif /* HAVE_SYS_MMAN_H */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MappedPcapFile");
+
+static const uint32_t MAGIC = 0xa1b2c3d4;            //!< Standard pcap magic number
+static const uint32_t SWAPPED_MAGIC = 0xd4c3b2a1;    //!< Standard magic number, byte swapped
+static const uint32_t NS_MAGIC = 0xa1b23c4d;         //!< Nanosecond resolution magic number
+static const uint32_t NS_SWAPPED_MAGIC = 0x4d3cb2a1; //!< Nanosecond magic number, byte swapped
+static const uint32_t FILE_HEADER_SIZE = 24;         //!< Size of the pcap global header
+static const uint32_t RECORD_HEADER_SIZE = 16;       //!< Size of a pcap record header
+
+MappedPcapFile::MappedPcapFile ()
+  : m_data (0),
+    m_size (0),
+    m_mapped (false),
+    m_fail (false),
+    m_swapMode (false),
+    m_nanosecMode (false),
+    m_snapLen (0),
+    m_dataLinkType (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+MappedPcapFile::~MappedPcapFile ()
+{
+  NS_LOG_FUNCTION (this);
+  Close ();
+}
+
+void
+MappedPcapFile::Close (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_data != 0)
+    {
+#ifdef HAVE_SYS_MMAN_H
+      if (m_mapped)
+        {
+          munmap (m_data, m_size);
+        }
+      else
+#endif /* HAVE_SYS_MMAN_H */
+        {
+          delete [] m_data;
+        }
+    }
+  m_data = 0;
+  m_size = 0;
+  m_mapped = false;
+  m_records.clear ();
+}
+
+bool
+MappedPcapFile::Open (std::string const &filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  Close ();
+  m_fail = true;
+
+#ifdef HAVE_SYS_MMAN_H
+  int fd = open (filename.c_str (), O_RDONLY);
+  if (fd < 0)
+    {
+      return false;
+    }
+  struct stat st;
+  if (fstat (fd, &st) == 0 && st.st_size > 0)
+    {
+      void *addr = mmap (0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (addr != MAP_FAILED)
+        {
+          m_data = static_cast<uint8_t *> (addr);
+          m_size = st.st_size;
+          m_mapped = true;
+        }
+    }
+  close (fd);
+#endif /* HAVE_SYS_MMAN_H */
+
+  if (m_data == 0)
+    {
+      std::ifstream file (filename.c_str (), std::ios::in | std::ios::binary);
+      file.seekg (0, std::ios::end);
+      std::streamoff size = file.tellg ();
+      if (file.fail () || size <= 0)
+        {
+          return false;
+        }
+      m_size = size;
+      m_data = new uint8_t[m_size];
+      file.seekg (0, std::ios::beg);
+      file.read (reinterpret_cast<char *> (m_data), m_size);
+      if (file.fail ())
+        {
+          Close ();
+          return false;
+        }
+    }
+
+  if (m_size < FILE_HEADER_SIZE)
+    {
+      Close ();
+      return false;
+    }
+
+  //
+  // The magic number tells the byte order and the time stamp resolution
+  //
+  uint32_t magic;
+  std::memcpy (&magic, m_data, 4);
+  if (magic != MAGIC && magic != SWAPPED_MAGIC && magic != NS_MAGIC && magic != NS_SWAPPED_MAGIC)
+    {
+      Close ();
+      return false;
+    }
+  m_swapMode = magic == SWAPPED_MAGIC || magic == NS_SWAPPED_MAGIC;
+  m_nanosecMode = magic == NS_MAGIC || magic == NS_SWAPPED_MAGIC;
+
+  uint16_t versionMajor;
+  uint16_t versionMinor;
+  std::memcpy (&versionMajor, m_data + 4, 2);
+  std::memcpy (&versionMinor, m_data + 6, 2);
+  if (m_swapMode)
+    {
+      versionMajor = ((versionMajor >> 8) & 0xff) | ((versionMajor << 8) & 0xff00);
+      versionMinor = ((versionMinor >> 8) & 0xff) | ((versionMinor << 8) & 0xff00);
+    }
+  int32_t zone = ReadU32 (8);
+  if (versionMajor != 2 || versionMinor != 4 || zone < -12 || zone > 12)
+    {
+      Close ();
+      return false;
+    }
+  m_snapLen = ReadU32 (16);
+  m_dataLinkType = ReadU32 (20);
+
+  //
+  // Index the records.  Only the record headers are touched, so this
+  // does not page the packet data in.
+  //
+  uint64_t offset = FILE_HEADER_SIZE;
+  while (offset + RECORD_HEADER_SIZE <= m_size)
+    {
+      uint32_t inclLen = ReadU32 (offset + 8);
+      if (offset + RECORD_HEADER_SIZE + inclLen > m_size)
+        {
+          break;
+        }
+      m_records.push_back (offset);
+      offset += RECORD_HEADER_SIZE + inclLen;
+    }
+  m_fail = offset != m_size;
+  NS_LOG_LOGIC (filename << ": " << m_records.size () << " records, " << m_size << " bytes");
+  return true;
+}
+
+bool
+MappedPcapFile::Fail (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_fail;
+}
+
+uint32_t
+MappedPcapFile::ReadU32 (uint64_t offset) const
+{
+  uint32_t val;
+  std::memcpy (&val, m_data + offset, 4);
+  if (m_swapMode)
+    {
+      val = ((val >> 24) & 0x000000ff) | ((val >> 8) & 0x0000ff00) | ((val << 8) & 0x00ff0000) | ((val << 24) & 0xff000000);
+    }
+  return val;
+}
+
+uint32_t
+MappedPcapFile::GetNRecords (void) const
+{
+  return m_records.size ();
+}
+
+uint32_t
+MappedPcapFile::GetDataLinkType (void) const
+{
+  return m_dataLinkType;
+}
+
+uint32_t
+MappedPcapFile::GetSnapLen (void) const
+{
+  return m_snapLen;
+}
+
+bool
+MappedPcapFile::IsNanoSecMode (void) const
+{
+  return m_nanosecMode;
+}
+
+void
+MappedPcapFile::GetTimestamp (uint32_t i, uint32_t &tsSec, uint32_t &tsUsec) const
+{
+  NS_ASSERT (i < m_records.size ());
+  tsSec = ReadU32 (m_records[i]);
+  tsUsec = ReadU32 (m_records[i] + 4);
+}
+
+uint64_t
+MappedPcapFile::GetTicks (uint32_t i) const
+{
+  uint32_t tsSec, tsUsec;
+  GetTimestamp (i, tsSec, tsUsec);
+  return tsSec * (m_nanosecMode ? 1000000000ULL : 1000000ULL) + tsUsec;
+}
+
+Time
+MappedPcapFile::GetTime (uint32_t i) const
+{
+  uint64_t ticks = GetTicks (i);
+  return m_nanosecMode ? NanoSeconds (ticks) : MicroSeconds (ticks);
+}
+
+uint32_t
+MappedPcapFile::GetInclLen (uint32_t i) const
+{
+  NS_ASSERT (i < m_records.size ());
+  return ReadU32 (m_records[i] + 8);
+}
+
+uint32_t
+MappedPcapFile::GetOrigLen (uint32_t i) const
+{
+  NS_ASSERT (i < m_records.size ());
+  return ReadU32 (m_records[i] + 12);
+}
+
+uint8_t const *
+MappedPcapFile::GetData (uint32_t i) const
+{
+  NS_ASSERT (i < m_records.size ());
+  return m_data + m_records[i] + RECORD_HEADER_SIZE;
+}
+
+Ptr<Packet>
+MappedPcapFile::GetPacket (uint32_t i) const
+{
+  NS_LOG_FUNCTION (this << i);
+  uint32_t inclLen = GetInclLen (i);
+  uint32_t origLen = GetOrigLen (i);
+  Ptr<Packet> p = Create<Packet> (GetData (i), inclLen);
+  if (origLen > inclLen)
+    {
+      p->AddPaddingAtEnd (origLen - inclLen);
+    }
+  return p;
+}
+
+uint32_t
+MappedPcapFile::Find (Time t) const
+{
+  NS_LOG_FUNCTION (this << t);
+  uint64_t ticks = m_nanosecMode ? t.GetNanoSeconds () : t.GetMicroSeconds ();
+  uint32_t first = 0;
+  uint32_t count = m_records.size ();
+  while (count > 0)
+    {
+      uint32_t step = count / 2;
+      if (GetTicks (first + step) < ticks)
+        {
+          first += step + 1;
+          count -= step + 1;
+        }
+      else
+        {
+          count = step;
+        }
+    }
+  return first;
+}
+
+} // namespace ns3
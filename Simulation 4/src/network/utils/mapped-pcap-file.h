@@ -0,0 +1,167 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MAPPED_PCAP_FILE_H
+#define MAPPED_PCAP_FILE_H
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include "ns3/ptr.h"
+#include "ns3/nstime.h"
+
+namespace ns3 {
+
+class Packet;
+
+/**
+ * \ingroup network
+ *
+ * \brief A read-only pcap file, mapped in memory, with random access
+ * to its records.
+ *
+ * Where PcapFile reads a capture one record at a time through a
+ * stream, this class maps the whole file in memory and indexes its
+ * records when it is opened.  Records can then be visited in any
+ * order, found by time stamp with a binary search, and turned into
+ * packets straight from the mapped bytes:
+ *
+ * \code
+ *   MappedPcapFile f;
+ *   f.Open ("capture.pcap");
+ *   for (uint32_t i = f.Find (Seconds (10)); i < f.GetNRecords (); ++i)
+ *     {
+ *       Ptr<Packet> p = f.GetPacket (i);
+ *       ...
+ *     }
+ * \endcode
+ *
+ * The records are assumed to be sorted by time stamp, as they are in
+ * the files written by ns-3, for Find to make sense.  Platforms without
+ * mmap read the whole file in memory instead.
+ */
+class MappedPcapFile
+{
+public:
+  MappedPcapFile ();
+  ~MappedPcapFile ();
+
+  /**
+   * Map a pcap file in memory and index its records.
+   *
+   * A file that ends in the middle of a record is accepted: the
+   * partial record is left out of the index and Fail returns true.
+   *
+   * \param filename the name of the file.
+   * \return false if the file is not a readable pcap file.
+   */
+  bool Open (std::string const &filename);
+  /**
+   * Unmap the file.  The data of its records is no longer available.
+   */
+  void Close (void);
+  /**
+   * \return true if the last Open failed or found a truncated record.
+   */
+  bool Fail (void) const;
+
+  /**
+   * \return the number of complete records in the file.
+   */
+  uint32_t GetNRecords (void) const;
+  /**
+   * \return the data link type field of the pcap global header.
+   */
+  uint32_t GetDataLinkType (void) const;
+  /**
+   * \return the snaplen field of the pcap global header.
+   */
+  uint32_t GetSnapLen (void) const;
+  /**
+   * \return true if the time stamps have a nanosecond resolution.
+   */
+  bool IsNanoSecMode (void) const;
+
+  /**
+   * \param i the index of a record.
+   * \return the time stamp of the record.
+   */
+  Time GetTime (uint32_t i) const;
+  /**
+   * \param i the index of a record.
+   * \param tsSec [out] seconds part of the time stamp.
+   * \param tsUsec [out] micro- or nanoseconds part of the time stamp.
+   */
+  void GetTimestamp (uint32_t i, uint32_t &tsSec, uint32_t &tsUsec) const;
+  /**
+   * \param i the index of a record.
+   * \return the number of bytes of the packet saved in the file.
+   */
+  uint32_t GetInclLen (uint32_t i) const;
+  /**
+   * \param i the index of a record.
+   * \return the length of the original packet.
+   */
+  uint32_t GetOrigLen (uint32_t i) const;
+  /**
+   * \param i the index of a record.
+   * \return the GetInclLen bytes of the packet, in the mapped file.
+   */
+  uint8_t const *GetData (uint32_t i) const;
+  /**
+   * Create a packet from a record, copying its bytes once from the
+   * mapped file.  A packet truncated to the snap length is padded with
+   * zeros to its original length.
+   *
+   * \param i the index of a record.
+   * \return the packet.
+   */
+  Ptr<Packet> GetPacket (uint32_t i) const;
+
+  /**
+   * \param t a time.
+   * \return the index of the first record with a time stamp not
+   * before \p t, or GetNRecords if there is none.
+   */
+  uint32_t Find (Time t) const;
+
+private:
+  /**
+   * \param offset an offset in the file.
+   * \return the 32 bits at this offset, in host byte order.
+   */
+  uint32_t ReadU32 (uint64_t offset) const;
+  /**
+   * \param i the index of a record.
+   * \return the time stamp of the record, in micro- or nanoseconds
+   * depending on the file.
+   */
+  uint64_t GetTicks (uint32_t i) const;
+
+  uint8_t *m_data;                 //!< The file, mapped or read in memory
+  uint64_t m_size;                 //!< The size of the file
+  bool m_mapped;                   //!< true if m_data is mapped, false if allocated
+  bool m_fail;                     //!< true after an Open error or truncation
+  bool m_swapMode;                 //!< true if the file has the other byte order
+  bool m_nanosecMode;              //!< true for nanosecond time stamps
+  uint32_t m_snapLen;              //!< snaplen of the global header
+  uint32_t m_dataLinkType;         //!< data link type of the global header
+  std::vector<uint64_t> m_records; //!< offset of each record header
+};
+
+} // namespace ns3
+
+#endif /* MAPPED_PCAP_FILE_H */
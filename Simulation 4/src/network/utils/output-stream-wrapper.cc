@@ -46,6 +46,14 @@ OutputStreamWrapper::OutputStreamWrapper (std::ostream* os)
   NS_ABORT_MSG_UNLESS (m_ostream->good (), "Output stream is not vaild for writing.");
 }
 
+OutputStreamWrapper::OutputStreamWrapper (Ptr<BinaryTraceWriter> trace)
+  : m_ostream (trace->GetStream ()), m_binaryTrace (trace), m_destroyable (false)
+{
+  NS_LOG_FUNCTION (this << trace);
+  FatalImpl::RegisterStream (m_ostream);
+  NS_ABORT_MSG_IF (trace->Fail (), "Binary trace file is not valid for writing.");
+}
+
 OutputStreamWrapper::~OutputStreamWrapper ()
 {
   NS_LOG_FUNCTION (this);
@@ -61,4 +69,10 @@ OutputStreamWrapper::GetStream (void)
   return m_ostream;
 }
 
+Ptr<BinaryTraceWriter>
+OutputStreamWrapper::GetBinaryTrace (void) const
+{
+  return m_binaryTrace;
+}
+
 } // namespace ns3
@@ -23,6 +23,7 @@
 #include "ns3/object.h"
 #include "ns3/ptr.h"
 #include "ns3/simple-ref-count.h"
+#include "binary-trace-file.h"
 
 namespace ns3 {
 
@@ -81,6 +82,12 @@ public:
    * \param os output stream
    */
   OutputStreamWrapper (std::ostream* os);
+  /**
+   * Constructor
+   * \param trace binary trace file.  The stream is the text stream of
+   * the trace.
+   */
+  OutputStreamWrapper (Ptr<BinaryTraceWriter> trace);
   ~OutputStreamWrapper ();
 
   /**
@@ -92,8 +99,19 @@ public:
    */
   std::ostream *GetStream (void);
 
+  /**
+   * Return the binary trace file the wrapper writes to, if any.
+   *
+   * Trace sinks record their events in the binary trace, when there
+   * is one, instead of printing them to the stream.
+   *
+   * \returns the binary trace file, or zero for a plain stream
+   */
+  Ptr<BinaryTraceWriter> GetBinaryTrace (void) const;
+
 private:
   std::ostream *m_ostream; //!< The output stream
+  Ptr<BinaryTraceWriter> m_binaryTrace; //!< The binary trace file, if any
   bool m_destroyable; //!< Can be destroyed
 };
 
@@ -19,6 +19,8 @@
 #include "ns3/log.h"
 #include "ns3/boolean.h"
 #include "ns3/uinteger.h"
+#include "ns3/enum.h"
+#include "ns3/abort.h"
 #include "ns3/buffer.h"
 #include "ns3/header.h"
 #include "pcap-file-wrapper.h"
@@ -46,6 +48,24 @@ PcapFileWrapper::GetTypeId (void)
                    BooleanValue (false),
                    MakeBooleanAccessor (&PcapFileWrapper::m_nanosecMode),
                    MakeBooleanChecker())
+    .AddAttribute ("AsyncWrite",
+                   "Whether packets are written to the file in large batches from a "
+                   "background thread instead of one write per packet.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&PcapFileWrapper::m_asyncWrite),
+                   MakeBooleanChecker ())
+    .AddAttribute ("WriteQueueSize",
+                   "Number of batches of packets waiting for the background writer "
+                   "beyond which packets are dropped, with AsyncWrite.",
+                   UintegerValue (BatchedFileWriter::MAX_BATCHES_DEFAULT),
+                   MakeUintegerAccessor (&PcapFileWrapper::m_writeQueueSize),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("Compression",
+                   "Compression of the files written.",
+                   EnumValue (BatchedFileWriter::COMPRESSION_NONE),
+                   MakeEnumAccessor (&PcapFileWrapper::m_compression),
+                   MakeEnumChecker (BatchedFileWriter::COMPRESSION_NONE, "None",
+                                    BatchedFileWriter::COMPRESSION_GZIP, "Gzip"))
   ;
   return tid;
 }
@@ -93,9 +113,29 @@ void
 PcapFileWrapper::Open (std::string const &filename, std::ios::openmode mode)
 {
   NS_LOG_FUNCTION (this << filename << mode);
+  bool compress = m_compression != BatchedFileWriter::COMPRESSION_NONE;
+  if ((mode & std::ios::out) && (m_asyncWrite || compress))
+    {
+      NS_ABORT_MSG_UNLESS (BatchedFileWriter::IsCompressionSupported (m_compression),
+                           "Compressed pcap files need ns-3 built with zlib");
+      std::string name = filename;
+      if (m_compression == BatchedFileWriter::COMPRESSION_GZIP)
+        {
+          name += ".gz";
+        }
+      m_file.OpenBatched (name, m_compression, m_asyncWrite, m_writeQueueSize);
+      return;
+    }
   m_file.Open (filename, mode);
 }
 
+uint64_t
+PcapFileWrapper::GetDroppedRecords (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_file.GetDroppedRecords ();
+}
+
 void
 PcapFileWrapper::Init (uint32_t dataLinkType, uint32_t snapLen, int32_t tzCorrection)
 {
@@ -74,6 +74,10 @@ public:
    *
    * \param mode String containing the access mode for the file.
    *
+   * A file opened for writing is written in batches, see
+   * PcapFile::OpenBatched, if the AsyncWrite attribute is true or the
+   * Compression attribute asks for compression.  ".gz" is appended to
+   * the name of a gzip-compressed file.
    */
   void Open (std::string const &filename, std::ios::openmode mode);
 
@@ -82,6 +86,12 @@ public:
    */
   void Close (void);
 
+  /**
+   * \return the number of packets not written because the background
+   * writer fell behind, with the AsyncWrite attribute set.
+   */
+  uint64_t GetDroppedRecords (void) const;
+
   /**
    * Initialize the pcap file associated with this wrapper.  This file must have
    * been previously opened with write permissions.
@@ -224,6 +234,9 @@ private:
   PcapFile m_file; //!< Pcap file
   uint32_t m_snapLen; //!< max length of saved packets
   bool     m_nanosecMode; //!< Timestamps in nanosecond mode
+  bool     m_asyncWrite; //!< Write from a background thread
+  uint32_t m_writeQueueSize; //!< Batches in flight before dropping packets
+  BatchedFileWriter::Compression m_compression; //!< Compression of written files
 };
 
 } // namespace ns3
@@ -27,6 +27,7 @@
 #include "ns3/header.h"
 #include "ns3/buffer.h"
 #include "pcap-file.h"
+#include "mapped-pcap-file.h"
 #include "ns3/log.h"
 #include "ns3/build-profile.h"
 //
@@ -68,6 +69,10 @@ bool
 PcapFile::Fail (void) const
 {
   NS_LOG_FUNCTION (this);
+  if (m_writer.IsOpen ())
+    {
+      return m_writer.Fail ();
+    }
   return m_file.fail ();
 }
 bool 
@@ -88,9 +93,21 @@ void
 PcapFile::Close (void)
 {
   NS_LOG_FUNCTION (this);
+  if (m_writer.IsOpen ())
+    {
+      m_writer.Close ();
+      return;
+    }
   m_file.close ();
 }
 
+uint64_t
+PcapFile::GetDroppedRecords (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_writer.GetDroppedRecords ();
+}
+
 uint32_t
 PcapFile::GetMagic (void)
 {
@@ -202,12 +219,6 @@ void
 PcapFile::WriteFileHeader (void)
 {
   NS_LOG_FUNCTION (this);
-  //
-  // If we're initializing the file, we need to write the pcap file header
-  // at the start of the file.
-  //
-  m_file.seekp (0, std::ios::beg);
- 
   //
   // We have the ability to write out the pcap file header in a foreign endian
   // format, so we need a temp place to swap on the way out.
@@ -230,6 +241,30 @@ PcapFile::WriteFileHeader (void)
       headerOut = &header;
     }
 
+  if (m_writer.IsOpen ())
+    {
+      //
+      // A batched file is only ever appended to, so Init must come
+      // before any packet and nothing can have been dropped yet.
+      //
+      uint8_t *buffer = m_writer.Reserve (24);
+      NS_ASSERT (buffer != 0);
+      std::memcpy (buffer, &headerOut->m_magicNumber, 4);
+      std::memcpy (buffer + 4, &headerOut->m_versionMajor, 2);
+      std::memcpy (buffer + 6, &headerOut->m_versionMinor, 2);
+      std::memcpy (buffer + 8, &headerOut->m_zone, 4);
+      std::memcpy (buffer + 12, &headerOut->m_sigFigs, 4);
+      std::memcpy (buffer + 16, &headerOut->m_snapLen, 4);
+      std::memcpy (buffer + 20, &headerOut->m_type, 4);
+      return;
+    }
+
+  //
+  // If we're initializing the file, we need to write the pcap file header
+  // at the start of the file.
+  //
+  m_file.seekp (0, std::ios::beg);
+
   //
   // Watch out for memory alignment differences between machines, so write
   // them all individually.
@@ -341,6 +376,17 @@ PcapFile::Open (std::string const &filename, std::ios::openmode mode)
     }
 }
 
+void
+PcapFile::OpenBatched (std::string const &filename, BatchedFileWriter::Compression compression,
+                       bool async, uint32_t maxBatches)
+{
+  NS_LOG_FUNCTION (this << filename << compression << async << maxBatches);
+  NS_ASSERT (!m_file.is_open ());
+  m_filename = filename;
+  m_writer.Open (filename, compression, async,
+                 BatchedFileWriter::BATCH_SIZE_DEFAULT, maxBatches);
+}
+
 void
 PcapFile::Init (uint32_t dataLinkType, uint32_t snapLen, int32_t timeZoneCorrection, bool swapMode, bool nanosecMode)
 {
@@ -430,10 +476,55 @@ PcapFile::WritePacketHeader (uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen)
   return inclLen;
 }
 
+uint8_t *
+PcapFile::ReserveRecord (uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen, uint32_t &inclLen)
+{
+  NS_LOG_FUNCTION (this << tsSec << tsUsec << totalLen);
+
+  inclLen = totalLen > m_fileHeader.m_snapLen ? m_fileHeader.m_snapLen : totalLen;
+
+  //
+  // Only the captured part of the packet is queued, so a small snaplen
+  // also keeps the batches small.
+  //
+  uint8_t *buffer = m_writer.Reserve (16 + inclLen);
+  if (buffer == 0)
+    {
+      return 0;
+    }
+
+  PcapRecordHeader header;
+  header.m_tsSec = tsSec;
+  header.m_tsUsec = tsUsec;
+  header.m_inclLen = inclLen;
+  header.m_origLen = totalLen;
+
+  if (m_swapMode)
+    {
+      Swap (&header, &header);
+    }
+
+  std::memcpy (buffer, &header.m_tsSec, 4);
+  std::memcpy (buffer + 4, &header.m_tsUsec, 4);
+  std::memcpy (buffer + 8, &header.m_inclLen, 4);
+  std::memcpy (buffer + 12, &header.m_origLen, 4);
+  return buffer + 16;
+}
+
 void
 PcapFile::Write (uint32_t tsSec, uint32_t tsUsec, uint8_t const * const data, uint32_t totalLen)
 {
   NS_LOG_FUNCTION (this << tsSec << tsUsec << &data << totalLen);
+  if (m_writer.IsOpen ())
+    {
+      uint32_t inclLen;
+      uint8_t *buffer = ReserveRecord (tsSec, tsUsec, totalLen, inclLen);
+      if (buffer != 0)
+        {
+          std::memcpy (buffer, data, inclLen);
+        }
+      return;
+    }
   uint32_t inclLen = WritePacketHeader (tsSec, tsUsec, totalLen);
   m_file.write ((const char *)data, inclLen);
   NS_BUILD_DEBUG(m_file.flush());
@@ -443,6 +534,16 @@ void
 PcapFile::Write (uint32_t tsSec, uint32_t tsUsec, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (this << tsSec << tsUsec << p);
+  if (m_writer.IsOpen ())
+    {
+      uint32_t inclLen;
+      uint8_t *buffer = ReserveRecord (tsSec, tsUsec, p->GetSize (), inclLen);
+      if (buffer != 0)
+        {
+          p->CopyData (buffer, inclLen);
+        }
+      return;
+    }
   uint32_t inclLen = WritePacketHeader (tsSec, tsUsec, p->GetSize ());
   p->CopyData (&m_file, inclLen);
   NS_BUILD_DEBUG(m_file.flush());
@@ -454,6 +555,24 @@ PcapFile::Write (uint32_t tsSec, uint32_t tsUsec, const Header &header, Ptr<cons
   NS_LOG_FUNCTION (this << tsSec << tsUsec << &header << p);
   uint32_t headerSize = header.GetSerializedSize ();
   uint32_t totalSize = headerSize + p->GetSize ();
+
+  if (m_writer.IsOpen ())
+    {
+      uint32_t inclLen;
+      uint8_t *buffer = ReserveRecord (tsSec, tsUsec, totalSize, inclLen);
+      if (buffer == 0)
+        {
+          return;
+        }
+      Buffer headerBuffer;
+      headerBuffer.AddAtStart (headerSize);
+      header.Serialize (headerBuffer.Begin ());
+      uint32_t toCopy = std::min (headerSize, inclLen);
+      headerBuffer.CopyData (buffer, toCopy);
+      p->CopyData (buffer + toCopy, inclLen - toCopy);
+      return;
+    }
+
   uint32_t inclLen = WritePacketHeader (tsSec, tsUsec, totalSize);
 
   Buffer headerBuffer;
@@ -530,60 +649,46 @@ PcapFile::Diff (std::string const & f1, std::string const & f2,
                 uint32_t snapLen)
 {
   NS_LOG_FUNCTION (f1 << f2 << sec << usec << snapLen);
-  PcapFile pcap1, pcap2;
-  pcap1.Open (f1, std::ios::in);
-  pcap2.Open (f2, std::ios::in);
-  bool bad = pcap1.Fail () || pcap2.Fail ();
+  //
+  // Both files are mapped in memory and compared in place, rather than
+  // read record by record through two streams.
+  //
+  MappedPcapFile pcap1, pcap2;
+  bool bad = !pcap1.Open (f1) || !pcap2.Open (f2);
   if (bad)
     {
       return true;
     }
 
-  uint8_t *data1 = new uint8_t [snapLen] ();
-  uint8_t *data2 = new uint8_t [snapLen] ();
   uint32_t tsSec1 = 0;
   uint32_t tsSec2 = 0;
   uint32_t tsUsec1 = 0;
   uint32_t tsUsec2 = 0;
-  uint32_t inclLen1 = 0;
-  uint32_t inclLen2 = 0;
-  uint32_t origLen1 = 0;
-  uint32_t origLen2 = 0;
-  uint32_t readLen1 = 0;
-  uint32_t readLen2 = 0;
   bool diff = false;
 
-  while (!pcap1.Eof () && !pcap2.Eof ())
+  uint32_t nRecords = std::min (pcap1.GetNRecords (), pcap2.GetNRecords ());
+  for (uint32_t i = 0; i < nRecords; ++i)
     {
-      pcap1.Read (data1, snapLen, tsSec1, tsUsec1, inclLen1, origLen1, readLen1);
-      pcap2.Read (data2, snapLen, tsSec2, tsUsec2, inclLen2, origLen2, readLen2);
-
-      bool same = pcap1.Fail () == pcap2.Fail ();
-      if (!same)
-        {
-          diff = true;
-          break;
-        }
-      if (pcap1.Eof ())
-        {
-          break;
-        }
+      pcap1.GetTimestamp (i, tsSec1, tsUsec1);
+      pcap2.GetTimestamp (i, tsSec2, tsUsec2);
 
       ++packets;
-      
+
       if (tsSec1 != tsSec2 || tsUsec1 != tsUsec2)
         {
           diff = true; // Next packet timestamps do not match
           break;
         }
 
+      uint32_t readLen1 = std::min (snapLen, pcap1.GetInclLen (i));
+      uint32_t readLen2 = std::min (snapLen, pcap2.GetInclLen (i));
       if (readLen1 != readLen2)
         {
           diff = true; // Packet lengths do not match
           break;
         }
 
-      if (std::memcmp (data1, data2, readLen1) != 0)
+      if (std::memcmp (pcap1.GetData (i), pcap2.GetData (i), readLen1) != 0)
         {
           diff = true; // Packet data do not match
           break;
@@ -592,16 +697,14 @@ PcapFile::Diff (std::string const & f1, std::string const & f2,
   sec = tsSec1;
   usec = tsUsec1;
 
-  bad = pcap1.Fail () || pcap2.Fail ();
-  bool eof = pcap1.Eof () && pcap2.Eof ();
-  if (bad && !eof)
+  //
+  // One file has more packets than the other, or ends in the middle of one
+  //
+  if (pcap1.GetNRecords () != pcap2.GetNRecords () || pcap1.Fail () || pcap2.Fail ())
     {
       diff = true;
     }
 
-  delete[] data1;
-  delete[] data2;
-
   return diff;
 }
 
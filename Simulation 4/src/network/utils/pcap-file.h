@@ -25,6 +25,7 @@
 #include <fstream>
 #include <stdint.h>
 #include "ns3/ptr.h"
+#include "batched-file-writer.h"
 
 namespace ns3 {
 
@@ -80,11 +81,38 @@ public:
    */
   void Open (std::string const &filename, std::ios::openmode mode);
 
+  /**
+   * Create a new pcap file to be written in large batches.
+   *
+   * The records are buffered and written by a BatchedFileWriter, from a
+   * background thread if \p async is true, instead of one stream write
+   * per packet.  Call Init right after this method, then Write; the
+   * file cannot be read or rewound.  The file is complete once Close
+   * returns.
+   *
+   * \param filename String containing the name of the file.
+   * \param compression The compression of the file.
+   * \param async true to write the file from a background thread.
+   * \param maxBatches Number of batches of
+   * BatchedFileWriter::BATCH_SIZE_DEFAULT bytes in flight before records
+   * are dropped, in asynchronous mode.
+   */
+  void OpenBatched (std::string const &filename,
+                    BatchedFileWriter::Compression compression = BatchedFileWriter::COMPRESSION_NONE,
+                    bool async = true,
+                    uint32_t maxBatches = BatchedFileWriter::MAX_BATCHES_DEFAULT);
+
   /**
    * Close the underlying file.
    */
   void Close (void);
 
+  /**
+   * \return the number of packets not written to a file opened with
+   * OpenBatched because the background writer fell behind.
+   */
+  uint64_t GetDroppedRecords (void) const;
+
   /**
    * Initialize the pcap file associated with this object.  This file must have
    * been previously opened with write permissions.
@@ -360,6 +388,18 @@ private:
    * \returns the length of the packet to write in the Pcap file
    */
   uint32_t WritePacketHeader (uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen);
+  /**
+   * \brief Append a Pcap packet header to a batched file and make room
+   * for the packet data behind it
+   *
+   * \param tsSec Time stamp (seconds part)
+   * \param tsUsec Time stamp (microseconds part)
+   * \param totalLen total packet length
+   * \param inclLen [out] the length of the packet data to write
+   * \returns the area to copy the packet data into, or zero if the
+   * packet was dropped
+   */
+  uint8_t *ReserveRecord (uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen, uint32_t &inclLen);
 
   /**
    * \brief Read and verify a Pcap file header
@@ -368,6 +408,7 @@ private:
 
   std::string    m_filename;    //!< file name
   std::fstream   m_file;        //!< file stream
+  BatchedFileWriter m_writer;   //!< batched output, used instead of m_file when open
   PcapFileHeader m_fileHeader;  //!< file header
   bool m_swapMode;              //!< swap mode
   bool m_nanosecMode;           //!< nanosecond timestamp mode
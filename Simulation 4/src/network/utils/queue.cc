@@ -97,19 +97,17 @@ bool
 Queue::Enqueue (Ptr<QueueItem> item)
 {
   NS_LOG_FUNCTION (this << item);
-  Ptr<Packet> p = item->GetPacket ();
-
   if (m_mode == QUEUE_MODE_PACKETS && (m_nPackets.Get () >= m_maxPackets))
     {
       NS_LOG_LOGIC ("Queue full (at max packets) -- dropping pkt");
-      Drop (p);
+      Drop (item->GetPacket ());
       return false;
     }
 
   if (m_mode == QUEUE_MODE_BYTES && (m_nBytes.Get () + item->GetPacketSize () > m_maxBytes))
     {
       NS_LOG_LOGIC ("Queue full (packet would exceed max bytes) -- dropping pkt");
-      Drop (p);
+      Drop (item->GetPacket ());
       return false;
     }
 
@@ -119,14 +117,18 @@ Queue::Enqueue (Ptr<QueueItem> item)
   bool retval = DoEnqueue (item);
   if (retval)
     {
-      NS_LOG_LOGIC ("m_traceEnqueue (p)");
-      m_traceEnqueue (item->GetPacket ());
+      // skip the packet reference when nothing is connected
+      if (!m_traceEnqueue.IsEmpty ())
+        {
+          NS_LOG_LOGIC ("m_traceEnqueue (p)");
+          m_traceEnqueue (item->GetPacket ());
+        }
 
       uint32_t size = item->GetPacketSize ();
       m_nBytes += size;
       m_nTotalReceivedBytes += size;
 
-      m_nPackets++;
+      ++m_nPackets;
       m_nTotalReceivedPackets++;
     }
   return retval;
@@ -151,10 +153,13 @@ Queue::Dequeue (void)
       NS_ASSERT (m_nPackets.Get () > 0);
 
       m_nBytes -= item->GetPacketSize ();
-      m_nPackets--;
+      --m_nPackets;
 
-      NS_LOG_LOGIC ("m_traceDequeue (packet)");
-      m_traceDequeue (item->GetPacket ());
+      if (!m_traceDequeue.IsEmpty ())
+        {
+          NS_LOG_LOGIC ("m_traceDequeue (packet)");
+          m_traceDequeue (item->GetPacket ());
+        }
     }
   return item;
 }
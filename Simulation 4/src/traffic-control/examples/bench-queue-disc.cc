@@ -0,0 +1,141 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Throughput of the traffic control layer: IPv4 packets sent through a
+// queue disc to a device that accepts them all.
+//
+//   ./waf --run "bench-queue-disc --n=10000000"
+//   ./waf --run "bench-queue-disc --n=10000000 --bulk=16"
+//
+// "steady" sends the packets one at a time, so that every queue disc run
+// dequeues a single packet.  "burst" enqueues --burst packets while the
+// device queue is stopped, then wakes it, so that the queue disc runs
+// dequeue --quota packets each, with bulk dequeues of --bulk packets.
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/traffic-control-module.h"
+#include "ns3/ipv4-queue-disc-item.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include <iostream>
+#include <iomanip>
+#include <string>
+
+using namespace ns3;
+
+/**
+ * A device that accepts and discards every packet
+ */
+class SinkNetDevice : public SimpleNetDevice
+{
+public:
+  virtual bool Send (Ptr<Packet> packet, const Address& dest, uint16_t protocolNumber)
+  {
+    return true;
+  }
+};
+
+static void
+Report (std::string name, uint32_t n, SystemWallClockMs &clock)
+{
+  int64_t ms = clock.End ();
+  std::cout << std::left << std::setw (16) << name
+            << std::right << std::setw (10) << ms << " ms  "
+            << std::setw (10) << (ms * 1e6 / n) << " ns/packet" << std::endl;
+}
+
+static void
+BenchSteady (Ptr<TrafficControlLayer> tc, Ptr<NetDevice> device, Ptr<Packet> p, uint32_t n)
+{
+  Ipv4Header header;
+  header.SetPayloadSize (p->GetSize ());
+  Address dest = device->GetBroadcast ();
+  SystemWallClockMs clock;
+  clock.Start ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      tc->Send (device, Create<Ipv4QueueDiscItem> (p->Copy (), dest, Ipv4L3Protocol::PROT_NUMBER, header));
+    }
+  Report ("steady", n, clock);
+}
+
+static void
+BenchBurst (Ptr<TrafficControlLayer> tc, Ptr<NetDevice> device, Ptr<Packet> p, uint32_t n,
+            uint32_t burst)
+{
+  Ptr<QueueDisc> qdisc = tc->GetRootQueueDiscOnDevice (device);
+  Ipv4Header header;
+  header.SetPayloadSize (p->GetSize ());
+  Address dest = device->GetBroadcast ();
+  Ptr<NetDeviceQueue> txq = device->GetObject<NetDeviceQueueInterface> ()->GetTxQueue (0);
+  SystemWallClockMs clock;
+  clock.Start ();
+  for (uint32_t i = 0; i < n; i += burst)
+    {
+      txq->Stop ();
+      for (uint32_t j = 0; j < burst; j++)
+        {
+          tc->Send (device, Create<Ipv4QueueDiscItem> (p->Copy (), dest, Ipv4L3Protocol::PROT_NUMBER, header));
+        }
+      while (qdisc->GetNPackets () > 0)
+        {
+          txq->Wake ();
+        }
+    }
+  Report ("burst", n, clock);
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 1000000;
+  uint32_t burst = 1000;
+  uint32_t bulk = 1;
+  uint32_t quota = 64;
+
+  CommandLine cmd;
+  cmd.AddValue ("n", "number of packets of each benchmark", n);
+  cmd.AddValue ("burst", "number of packets enqueued while the device queue is stopped", burst);
+  cmd.AddValue ("bulk", "maximum number of packets of a bulk dequeue (MaxBulkPackets)", bulk);
+  cmd.AddValue ("quota", "maximum number of packets dequeued in a queue disc run", quota);
+  cmd.Parse (argc, argv);
+
+  Ptr<Node> node = CreateObject<Node> ();
+  Ptr<SimpleNetDevice> device = CreateObject<SinkNetDevice> ();
+  device->SetAddress (Mac48Address::Allocate ());
+  node->AddDevice (device);
+  Ptr<TrafficControlLayer> tc = CreateObject<TrafficControlLayer> ();
+  node->AggregateObject (tc);
+  tc->SetupDevice (device);
+
+  TrafficControlHelper tch;
+  tch.SetRootQueueDisc ("ns3::CoDelQueueDisc",
+                        "Mode", StringValue ("QUEUE_MODE_PACKETS"),
+                        "MaxPackets", UintegerValue (burst),
+                        "Quota", UintegerValue (quota),
+                        "MaxBulkPackets", UintegerValue (bulk));
+  tch.Install (device);
+  node->Initialize ();
+
+  std::cout << "bulk: " << bulk << " packets" << std::endl;
+
+  // run inside the simulation, as the Time objects made before are tracked
+  Ptr<Packet> p = Create<Packet> (1000);
+  Simulator::ScheduleNow (&BenchSteady, tc, device, p, n);
+  Simulator::ScheduleNow (&BenchBurst, tc, device, p, n, burst);
+  Simulator::Run ();
+  Simulator::Destroy ();
+  return 0;
+}
@@ -134,6 +134,17 @@ TypeId QueueDisc::GetTypeId (void)
                    MakeUintegerAccessor (&QueueDisc::SetQuota,
                                          &QueueDisc::GetQuota),
                    MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("MaxBulkPackets",
+                   "The maximum number of packets sent to the device in a single "
+                   "dequeue operation of a qdisc run (1 disables bulk dequeues)",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&QueueDisc::m_maxBulkPackets),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("MaxBulkBytes",
+                   "The amount of bytes after which a bulk dequeue stops",
+                   UintegerValue (65536),
+                   MakeUintegerAccessor (&QueueDisc::m_maxBulkBytes),
+                   MakeUintegerChecker<uint32_t> ())
     .AddAttribute ("InternalQueueList", "The list of internal queues.",
                    ObjectVectorValue (),
                    MakeObjectVectorAccessor (&QueueDisc::m_queues),
@@ -179,6 +190,8 @@ QueueDisc::QueueDisc ()
      m_nTotalDroppedBytes (0),
      m_nTotalRequeuedPackets (0),
      m_nTotalRequeuedBytes (0),
+     m_maxBulkPackets (1),
+     m_maxBulkBytes (65536),
      m_running (false)
 {
   NS_LOG_FUNCTION (this);
@@ -193,7 +206,8 @@ QueueDisc::DoDispose (void)
   m_classes.clear ();
   m_device = 0;
   m_devQueueIface = 0;
-  m_requeued = 0;
+  m_requeued.clear ();
+  m_bulk.clear ();
   Object::DoDispose ();
 }
 
@@ -443,6 +457,28 @@ QueueDisc::Dequeue (void)
   return item;
 }
 
+uint32_t
+QueueDisc::DequeueBatch (std::vector<Ptr<QueueDiscItem> > &items, uint32_t maxPackets,
+                         uint32_t maxBytes)
+{
+  NS_LOG_FUNCTION (this << maxPackets << maxBytes);
+
+  uint32_t packets = 0;
+  uint32_t bytes = 0;
+  while (packets < maxPackets && bytes < maxBytes)
+    {
+      Ptr<QueueDiscItem> item = Dequeue ();
+      if (item == 0)
+        {
+          break;
+        }
+      bytes += item->GetPacketSize ();
+      packets++;
+      items.push_back (item);
+    }
+  return packets;
+}
+
 Ptr<const QueueDiscItem>
 QueueDisc::Peek (void) const
 {
@@ -458,14 +494,15 @@ QueueDisc::Run (void)
   if (RunBegin ())
     {
       uint32_t quota = m_quota;
-      while (Restart ())
+      uint32_t packets;
+      while (Restart (packets))
         {
-          quota -= 1;
-          if (quota <= 0)
+          if (packets >= quota)
             {
               /// \todo netif_schedule (q);
               break;
             }
+          quota -= packets;
         }
       RunEnd ();
     }
@@ -492,17 +529,37 @@ QueueDisc::RunEnd (void)
 }
 
 bool
-QueueDisc::Restart (void)
+QueueDisc::Restart (uint32_t &packets)
 {
   NS_LOG_FUNCTION (this);
   Ptr<QueueDiscItem> item = DequeuePacket();
   if (item == 0)
     {
       NS_LOG_LOGIC ("No packet to send");
+      packets = 0;
       return false;
     }
 
-  return Transmit (item);
+  bool ret = Transmit (item);
+  packets = 1 + m_bulk.size ();
+  if (!m_bulk.empty ())
+    {
+      // Send the rest of a bulk dequeue. Once a packet is requeued, the
+      // following ones are requeued too, so that they keep their order.
+      for (ItemVector::iterator i = m_bulk.begin (); i != m_bulk.end (); i++)
+        {
+          if (ret)
+            {
+              ret = Transmit (*i);
+            }
+          else
+            {
+              Requeue (*i);
+            }
+        }
+      m_bulk.clear ();
+    }
+  return ret;
 }
 
 Ptr<QueueDiscItem>
@@ -512,22 +569,29 @@ QueueDisc::DequeuePacket ()
   NS_ASSERT (m_devQueueIface);
   Ptr<QueueDiscItem> item;
 
-  // First check if there is a requeued packet
-  if (m_requeued != 0)
+  // First check if there are requeued packets
+  if (!m_requeued.empty ())
     {
-        // If the queue where the requeued packet is destined to is not stopped, return
-        // the requeued packet; otherwise, return an empty packet.
+        // If the queue where the requeued packets are destined to is not stopped, return
+        // the requeued packets; otherwise, return an empty packet.
         // If the device does not support flow control, the device queue is never stopped
-        if (!m_devQueueIface->GetTxQueue (m_requeued->GetTxQueueIndex ())->IsStopped ())
+        if (!m_devQueueIface->GetTxQueue (m_requeued.front ()->GetTxQueueIndex ())->IsStopped ())
           {
-            item = m_requeued;
-            m_requeued = 0;
+            // more than one packet is only requeued after a bulk dequeue, hence
+            // all the packets are destined to the same (unique) queue
+            m_bulk.swap (m_requeued);
+            item = m_bulk.front ();
+            m_bulk.erase (m_bulk.begin ());
 
-            m_nPackets--;
+            m_nPackets -= 1 + m_bulk.size ();
             m_nBytes -= item->GetPacketSize ();
-
             NS_LOG_LOGIC ("m_traceDequeue (p)");
             m_traceDequeue (item);
+            for (ItemVector::iterator i = m_bulk.begin (); i != m_bulk.end (); i++)
+              {
+                m_nBytes -= (*i)->GetPacketSize ();
+                m_traceDequeue (*i);
+              }
           }
     }
   else
@@ -544,8 +608,19 @@ QueueDisc::DequeuePacket ()
           if (item != 0)
             {
               item->AddHeader ();
+
+              // Bulk dequeue, only for single-queue devices as in Linux
+              uint32_t size = item->GetPacketSize ();
+              if (m_maxBulkPackets > 1 && size < m_maxBulkBytes
+                  && m_devQueueIface->GetTxQueuesN () == 1)
+                {
+                  DequeueBatch (m_bulk, m_maxBulkPackets - 1, m_maxBulkBytes - size);
+                  for (ItemVector::iterator i = m_bulk.begin (); i != m_bulk.end (); i++)
+                    {
+                      (*i)->AddHeader ();
+                    }
+                }
             }
-          // Here, Linux tries bulk dequeues
         }
     }
   return item;
@@ -555,7 +630,7 @@ void
 QueueDisc::Requeue (Ptr<QueueDiscItem> item)
 {
   NS_LOG_FUNCTION (this << item);
-  m_requeued = item;
+  m_requeued.push_back (item);
   /// \todo netif_schedule (q);
 
   m_nPackets++;       // it's still part of the queue
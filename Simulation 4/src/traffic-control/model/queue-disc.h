@@ -315,6 +315,22 @@ public:
    */
   Ptr<QueueDiscItem> Dequeue (void);
 
+  /**
+   * Modelled after the Linux function try_bulk_dequeue_skb (net/sched/sch_generic.c)
+   * Request the queue discipline to extract several packets at once, by calling
+   * Dequeue until either maxPackets items are extracted, or the size of the
+   * extracted items reaches maxBytes, or the queue disc is empty. The item
+   * that takes the size over maxBytes is extracted too. As with Dequeue, the
+   * header is not added to the packets: call AddHeader on every item before
+   * sending it to a device.
+   * \param items the vector to append the extracted items to
+   * \param maxPackets the maximum number of items to extract
+   * \param maxBytes the amount of bytes after which no item is extracted
+   * \return the number of items appended to items.
+   */
+  uint32_t DequeueBatch (std::vector<Ptr<QueueDiscItem> > &items, uint32_t maxPackets,
+                         uint32_t maxBytes);
+
   /**
    * Get a copy of the next packet the queue discipline will extract, without
    * actually extracting the packet. This function only calls the (private)
@@ -327,6 +343,14 @@ public:
    * Modelled after the Linux function __qdisc_run (net/sched/sch_generic.c)
    * Dequeues multiple packets, until a quota is exceeded or sending a packet
    * to the device failed.
+   *
+   * If MaxBulkPackets is greater than one and the device has a single
+   * transmission queue, every dequeue operation extracts up to MaxBulkPackets
+   * packets (or MaxBulkBytes bytes) with DequeueBatch and sends them to the
+   * device in a row. The packets the device does not accept are requeued, in
+   * order. Bulk dequeues are disabled by default because they change the
+   * order of the trace events, and AQM algorithms no longer see the packets
+   * requeued after the device stopped the queue.
    */
   void Run (void);
 
@@ -487,14 +511,17 @@ private:
 
   /**
    * Modelled after the Linux function qdisc_restart (net/sched/sch_generic.c)
-   * Dequeue a packet (by calling DequeuePacket) and send it to the device (by calling Transmit).
-   * \return true if a packet is successfully sent to the device.
+   * Dequeue a packet (by calling DequeuePacket) and send it to the device (by calling Transmit),
+   * followed by the other packets of a bulk dequeue, if any.
+   * \param packets set to the number of packets dequeued
+   * \return true if all the packets are successfully sent to the device.
    */
-  bool Restart (void);
+  bool Restart (uint32_t &packets);
 
   /**
    * Modelled after the Linux function dequeue_skb (net/sched/sch_generic.c)
-   * \return the requeued packet, if any, or the packet dequeued by the queue disc, otherwise.
+   * The other packets of a bulk dequeue, if any, are stored in m_bulk.
+   * \return the first requeued packet, if any, or the packet dequeued by the queue disc, otherwise.
    */
   Ptr<QueueDiscItem> DequeuePacket (void);
 
@@ -515,6 +542,9 @@ private:
 
   static const uint32_t DEFAULT_QUOTA = 64; //!< Default quota (as in /proc/sys/net/core/dev_weight)
 
+  /// Items of the queue disc
+  typedef std::vector<Ptr<QueueDiscItem> > ItemVector;
+
   std::vector<Ptr<Queue> > m_queues;            //!< Internal queues
   std::vector<Ptr<PacketFilter> > m_filters;    //!< Packet filters
   std::vector<Ptr<QueueDiscClass> > m_classes;  //!< Classes
@@ -529,10 +559,13 @@ private:
   uint32_t m_nTotalRequeuedPackets; //!< Total requeued packets
   uint32_t m_nTotalRequeuedBytes;   //!< Total requeued bytes
   uint32_t m_quota;                 //!< Maximum number of packets dequeued in a qdisc run
+  uint32_t m_maxBulkPackets;        //!< Maximum number of packets of a bulk dequeue
+  uint32_t m_maxBulkBytes;          //!< Amount of bytes after which a bulk dequeue stops
   Ptr<NetDevice> m_device;          //!< The NetDevice on which this queue discipline is installed
   Ptr<NetDeviceQueueInterface> m_devQueueIface;   //!< NetDevice queue interface
   bool m_running;                   //!< The queue disc is performing multiple dequeue operations
-  Ptr<QueueDiscItem> m_requeued;    //!< The last packet that failed to be transmitted
+  ItemVector m_requeued;            //!< The last packets that failed to be transmitted, in order
+  ItemVector m_bulk;                //!< The packets dequeued after the first one by a bulk dequeue
 
   /// Traced callback: fired when a packet is enqueued
   TracedCallback<Ptr<const QueueItem> > m_traceEnqueue;
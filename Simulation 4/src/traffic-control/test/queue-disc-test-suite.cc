@@ -0,0 +1,252 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/codel-queue-disc.h"
+#include "ns3/node.h"
+#include "ns3/simple-channel.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/error-model.h"
+#include "ns3/mac48-address.h"
+#include "ns3/uinteger.h"
+#include "ns3/packet.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup traffic-control-test
+ * \ingroup tests
+ *
+ * \brief Queue disc item whose header is already in the packet
+ */
+class QueueDiscTestItem : public QueueDiscItem {
+public:
+  /**
+   * Constructor
+   * \param p the packet
+   * \param addr the destination address
+   * \param protocol the protocol number
+   */
+  QueueDiscTestItem (Ptr<Packet> p, const Address & addr, uint16_t protocol);
+  virtual ~QueueDiscTestItem ();
+  virtual void AddHeader (void);
+
+private:
+  QueueDiscTestItem ();
+  QueueDiscTestItem (const QueueDiscTestItem &);
+  QueueDiscTestItem &operator = (const QueueDiscTestItem &);
+};
+
+QueueDiscTestItem::QueueDiscTestItem (Ptr<Packet> p, const Address & addr, uint16_t protocol)
+  : QueueDiscItem (p, addr, protocol)
+{
+}
+
+QueueDiscTestItem::~QueueDiscTestItem ()
+{
+}
+
+void
+QueueDiscTestItem::AddHeader (void)
+{
+}
+
+/**
+ * \ingroup traffic-control-test
+ * \ingroup tests
+ *
+ * \brief Device recording the size of the packets it is sent, which stops
+ * its transmission queue once it has accepted a given number of packets
+ */
+class QueueDiscTestDevice : public SimpleNetDevice
+{
+public:
+  QueueDiscTestDevice ();
+
+  /**
+   * Set the number of packets to accept before stopping the queue
+   * \param budget the number of packets
+   */
+  void SetBudget (uint32_t budget);
+
+  virtual bool Send (Ptr<Packet> packet, const Address& dest, uint16_t protocolNumber);
+
+  std::vector<uint32_t> m_sizes; //!< The size of the packets sent
+
+private:
+  uint32_t m_budget;             //!< The number of packets to accept before stopping the queue
+};
+
+QueueDiscTestDevice::QueueDiscTestDevice ()
+  : m_budget (0)
+{
+}
+
+void
+QueueDiscTestDevice::SetBudget (uint32_t budget)
+{
+  m_budget = budget;
+}
+
+bool
+QueueDiscTestDevice::Send (Ptr<Packet> packet, const Address& dest, uint16_t protocolNumber)
+{
+  if (m_budget == 0)
+    {
+      return false;
+    }
+  m_sizes.push_back (packet->GetSize ());
+  if (--m_budget == 0)
+    {
+      GetObject<NetDeviceQueueInterface> ()->GetTxQueue (0)->Stop ();
+    }
+  return true;
+}
+
+/**
+ * \ingroup traffic-control-test
+ * \ingroup tests
+ *
+ * \brief Check the bulk dequeues of a queue disc
+ */
+class QueueDiscBulkDequeueTestCase : public TestCase
+{
+public:
+  QueueDiscBulkDequeueTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Enqueue packets of increasing size
+   * \param qdisc the queue disc
+   * \param first the size of the first packet
+   * \param n the number of packets
+   */
+  void Enqueue (Ptr<QueueDisc> qdisc, uint32_t first, uint32_t n);
+};
+
+QueueDiscBulkDequeueTestCase::QueueDiscBulkDequeueTestCase ()
+  : TestCase ("Check the bulk dequeues of a queue disc")
+{
+}
+
+void
+QueueDiscBulkDequeueTestCase::Enqueue (Ptr<QueueDisc> qdisc, uint32_t first, uint32_t n)
+{
+  for (uint32_t i = 0; i < n; i++)
+    {
+      qdisc->Enqueue (Create<QueueDiscTestItem> (Create<Packet> (first + i), Mac48Address::GetBroadcast (), 0));
+    }
+}
+
+void
+QueueDiscBulkDequeueTestCase::DoRun (void)
+{
+  Ptr<QueueDiscTestDevice> device = CreateObject<QueueDiscTestDevice> ();
+  Ptr<NetDeviceQueueInterface> devQueueIface = CreateObject<NetDeviceQueueInterface> ();
+  device->AggregateObject (devQueueIface);
+  Ptr<NetDeviceQueue> txq = devQueueIface->GetTxQueue (0);
+
+  Ptr<QueueDisc> qdisc = CreateObject<CoDelQueueDisc> ();
+  qdisc->SetAttribute ("MaxBulkPackets", UintegerValue (4));
+  qdisc->SetNetDevice (device);
+  qdisc->Initialize ();
+
+  //
+  // DequeueBatch stops at the count or once the size reaches the byte limit
+  //
+  Enqueue (qdisc, 100, 10);
+  std::vector<Ptr<QueueDiscItem> > items;
+  NS_TEST_EXPECT_MSG_EQ (qdisc->DequeueBatch (items, 3, 100000), 3, "Wrong number of items with a count limit");
+  NS_TEST_EXPECT_MSG_EQ (qdisc->DequeueBatch (items, 10, 207), 2, "Wrong number of items with a byte limit");
+  NS_TEST_EXPECT_MSG_EQ (qdisc->DequeueBatch (items, 10, 100000), 5, "Wrong number of items of an emptying batch");
+  NS_TEST_EXPECT_MSG_EQ (qdisc->DequeueBatch (items, 10, 100000), 0, "Items dequeued from an empty queue disc");
+  NS_TEST_ASSERT_MSG_EQ (items.size (), 10, "Wrong number of items appended");
+  for (uint32_t i = 0; i < items.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (items[i]->GetPacketSize (), 100 + i, "Items out of order");
+    }
+  NS_TEST_EXPECT_MSG_EQ (qdisc->GetNPackets (), 0, "Packets left in the queue disc");
+  NS_TEST_EXPECT_MSG_EQ (qdisc->GetNBytes (), 0, "Bytes left in the queue disc");
+
+  //
+  // The device stops the queue in the middle of the second bulk dequeue:
+  // the rest of the bulk is requeued, and sent first when the device wakes
+  //
+  txq->Stop ();
+  Enqueue (qdisc, 200, 10);
+  device->SetBudget (6);
+  txq->Start ();
+  qdisc->Run ();
+  NS_TEST_ASSERT_MSG_EQ (device->m_sizes.size (), 6, "Wrong number of packets sent");
+  NS_TEST_EXPECT_MSG_EQ (qdisc->GetTotalRequeuedPackets (), 2, "Wrong number of packets requeued");
+  NS_TEST_EXPECT_MSG_EQ (qdisc->GetNPackets (), 4, "Wrong number of packets in the queue disc");
+  NS_TEST_EXPECT_MSG_EQ (qdisc->GetNBytes (), 206 + 207 + 208 + 209, "Wrong number of bytes in the queue disc");
+
+  device->SetBudget (100);
+  txq->Start ();
+  qdisc->Run ();
+  NS_TEST_ASSERT_MSG_EQ (device->m_sizes.size (), 10, "Wrong number of packets sent");
+  for (uint32_t i = 0; i < device->m_sizes.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (device->m_sizes[i], 200 + i, "Packets sent out of order");
+    }
+  NS_TEST_EXPECT_MSG_EQ (qdisc->GetNPackets (), 0, "Packets left in the queue disc");
+  NS_TEST_EXPECT_MSG_EQ (qdisc->GetNBytes (), 0, "Bytes left in the queue disc");
+
+  //
+  // A device refusing a packet with its queue started: the packets stay
+  // requeued in order
+  //
+  device->m_sizes.clear ();
+  device->SetBudget (0);
+  Enqueue (qdisc, 300, 3);
+  qdisc->Run ();
+  NS_TEST_EXPECT_MSG_EQ (device->m_sizes.size (), 0, "Packets sent to a refusing device");
+  NS_TEST_EXPECT_MSG_EQ (qdisc->GetNPackets (), 3, "Wrong number of packets in the queue disc");
+  device->SetBudget (100);
+  txq->Start ();
+  qdisc->Run ();
+  NS_TEST_ASSERT_MSG_EQ (device->m_sizes.size (), 3, "Wrong number of packets sent");
+  for (uint32_t i = 0; i < device->m_sizes.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (device->m_sizes[i], 300 + i, "Requeued packets sent out of order");
+    }
+
+  qdisc->Dispose ();
+  device->Dispose ();
+}
+
+/**
+ * \ingroup traffic-control-test
+ * \ingroup tests
+ *
+ * \brief Queue disc TestSuite
+ */
+class QueueDiscTestSuite : public TestSuite
+{
+public:
+  QueueDiscTestSuite ();
+};
+
+QueueDiscTestSuite::QueueDiscTestSuite ()
+  : TestSuite ("queue-disc", UNIT)
+{
+  AddTestCase (new QueueDiscBulkDequeueTestCase, TestCase::QUICK);
+}
+
+static QueueDiscTestSuite queueDiscTestSuite; //!< Static variable for test initialization
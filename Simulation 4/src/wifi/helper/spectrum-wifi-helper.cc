@@ -50,6 +50,12 @@ AsciiPhyTransmitSinkWithContext (
   uint8_t txLevel)
 {
   NS_LOG_FUNCTION (stream << context << p << mode << preamble << txLevel);
+  Ptr<BinaryTraceWriter> binary = stream->GetBinaryTrace ();
+  if (binary != 0)
+    {
+      binary->Record ('t', context, p);
+      return;
+    }
   *stream->GetStream () << "t " << Simulator::Now ().GetSeconds () << " " << context << " " << *p << std::endl;
 }
 
@@ -62,6 +68,12 @@ AsciiPhyTransmitSinkWithoutContext (
   uint8_t txLevel)
 {
   NS_LOG_FUNCTION (stream << p << mode << preamble << txLevel);
+  Ptr<BinaryTraceWriter> binary = stream->GetBinaryTrace ();
+  if (binary != 0)
+    {
+      binary->Record ('t', p);
+      return;
+    }
   *stream->GetStream () << "t " << Simulator::Now ().GetSeconds () << " " << *p << std::endl;
 }
 
@@ -75,6 +87,12 @@ AsciiPhyReceiveSinkWithContext (
   enum WifiPreamble preamble)
 {
   NS_LOG_FUNCTION (stream << context << p << snr << mode << preamble);
+  Ptr<BinaryTraceWriter> binary = stream->GetBinaryTrace ();
+  if (binary != 0)
+    {
+      binary->Record ('r', context, p);
+      return;
+    }
   *stream->GetStream () << "r " << Simulator::Now ().GetSeconds () << " " << context << " " << *p << std::endl;
 }
 
@@ -87,6 +105,12 @@ AsciiPhyReceiveSinkWithoutContext (
   enum WifiPreamble preamble)
 {
   NS_LOG_FUNCTION (stream << p << snr << mode << preamble);
+  Ptr<BinaryTraceWriter> binary = stream->GetBinaryTrace ();
+  if (binary != 0)
+    {
+      binary->Record ('r', p);
+      return;
+    }
   *stream->GetStream () << "r " << Simulator::Now ().GetSeconds () << " " << *p << std::endl;
 }
 